@@ -61,7 +61,7 @@ namespace simu5g
         auto cbrHeader = pPacket->popAtFront<CbrPacket>();
 
         unsigned short fiveQI = cbrHeader->getFiveQI(); // alaf
-        auto params = get_qos_parameters(fiveQI);
+        const auto &params = get_qos_parameters(fiveQI);
 
         if (params.fiveQI == 0)
         {
@@ -0,0 +1,98 @@
+//
+//                  Simu5G-NR-EDF (Extension of Simu5G)
+//
+// Original Authors: Giovanni Nardini, Giovanni Stea, Antonio Virdis (University of Pisa)
+// Extension Authors: Alaf Nascimento, Philippe Martins, Samuel Tardieu, Laurent Pautet (Institut Polytechnique de Paris)
+//
+// This file is part of a software released under the license included in file
+// "license.pdf". Please read LICENSE and README files before using it.
+// The above files and the present reference are part of the software itself,
+// and cannot be removed from it.
+//
+
+#ifndef _LTE_CARRIERARRAY_H_
+#define _LTE_CARRIERARRAY_H_
+
+#include <vector>
+#include <utility>
+#include <stdexcept>
+#include "common/LteCommon.h"
+
+namespace simu5g {
+
+//! Per-carrier state stored in a contiguous array indexed by CarrierIndex.
+/*!
+   Replaces the std::map<double, T> keyed by carrier frequency: the frequency is
+   mapped once to its CarrierIndex (see Binder::getCarrierIndex()), then every
+   access is a plain array lookup. Slots of carriers without state are skipped
+   by iteration, which yields (CarrierIndex, T) pairs as a map would.
+ */
+template<typename T>
+class CarrierArray
+{
+    typedef std::pair<CarrierIndex, T> Slot;
+
+    //! Slot i holds the state of carrier i, its key is CARRIER_INDEX_NONE if the carrier has none.
+    std::vector<Slot> slots_;
+
+    template<typename S>
+    class Iterator
+    {
+        S *slot_;
+        S *end_;
+
+        void skipEmpty()
+        {
+            while (slot_ != end_ && slot_->first == CARRIER_INDEX_NONE)
+                ++slot_;
+        }
+
+      public:
+        Iterator(S *slot, S *end) : slot_(slot), end_(end) { skipEmpty(); }
+        S& operator*() const { return *slot_; }
+        S *operator->() const { return slot_; }
+        Iterator& operator++() { ++slot_; skipEmpty(); return *this; }
+        bool operator==(const Iterator& other) const { return slot_ == other.slot_; }
+        bool operator!=(const Iterator& other) const { return slot_ != other.slot_; }
+    };
+
+  public:
+    typedef Iterator<Slot> iterator;
+    typedef Iterator<const Slot> const_iterator;
+
+    bool contains(CarrierIndex c) const { return c < slots_.size() && slots_[c].first != CARRIER_INDEX_NONE; }
+
+    //! Returns the state of the carrier, creating it if needed.
+    T& operator[](CarrierIndex c)
+    {
+        if (c >= slots_.size())
+            slots_.resize(c + 1, Slot(CARRIER_INDEX_NONE, T()));
+        slots_[c].first = c;
+        return slots_[c].second;
+    }
+
+    T& at(CarrierIndex c)
+    {
+        if (!contains(c))
+            throw std::out_of_range("CarrierArray::at - no state for this carrier");
+        return slots_[c].second;
+    }
+
+    const T& at(CarrierIndex c) const
+    {
+        if (!contains(c))
+            throw std::out_of_range("CarrierArray::at - no state for this carrier");
+        return slots_[c].second;
+    }
+
+    void clear() { slots_.clear(); }
+
+    iterator begin() { return iterator(slots_.data(), slots_.data() + slots_.size()); }
+    iterator end() { return iterator(slots_.data() + slots_.size(), slots_.data() + slots_.size()); }
+    const_iterator begin() const { return const_iterator(slots_.data(), slots_.data() + slots_.size()); }
+    const_iterator end() const { return const_iterator(slots_.data() + slots_.size(), slots_.data() + slots_.size()); }
+};
+
+} //namespace
+
+#endif // _LTE_CARRIERARRAY_H_
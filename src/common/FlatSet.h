@@ -0,0 +1,311 @@
+//
+//                  Simu5G-NR-EDF (Extension of Simu5G)
+//
+// Original Authors: Giovanni Nardini, Giovanni Stea, Antonio Virdis (University of Pisa)
+// Extension Authors: Alaf Nascimento, Philippe Martins, Samuel Tardieu, Laurent Pautet (Institut Polytechnique de Paris)
+//
+// This file is part of a software released under the license included in file
+// "license.pdf". Please read LICENSE and README files before using it.
+// The above files and the present reference are part of the software itself,
+// and cannot be removed from it.
+//
+
+#ifndef _LTE_FLATSET_H_
+#define _LTE_FLATSET_H_
+
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <stdexcept>
+
+namespace simu5g {
+
+//! Sorted table stored in contiguous arrays, base of FlatSet and FlatMap.
+/*!
+   Entries are kept sorted by key, so iteration follows the order of the
+   std::set/std::map they replace. Erasing only marks the entry as dead
+   (tombstone): it costs no shift and does not invalidate the iterators, so
+   the schedulers may erase connections while walking a set. Dead entries are
+   reclaimed when a key has to be inserted in the middle of the table, or when
+   the table is copied.
+
+   Copies reuse the storage of the destination, hence the "working copy, then
+   commit" pattern of the schedulers allocates nothing once the tables have
+   reached their steady size.
+
+   KeyOf extracts the key from an entry.
+ */
+template<typename Entry, typename Key, typename KeyOf>
+class FlatTable
+{
+  protected:
+    std::vector<Entry> entries_;
+    std::vector<unsigned char> live_;
+
+    //! number of live entries
+    size_t size_ = 0;
+
+    //! no live entry precedes this position
+    size_t first_ = 0;
+
+    size_t lowerBound(const Key& key) const
+    {
+        auto it = std::lower_bound(entries_.begin(), entries_.end(), key,
+                [](const Entry& e, const Key& k) { return KeyOf()(e) < k; });
+        return it - entries_.begin();
+    }
+
+    //! position of the live entry with the given key, entries_.size() if none
+    size_t position(const Key& key) const
+    {
+        size_t pos = lowerBound(key);
+        if (pos < entries_.size() && live_[pos] && !(key < KeyOf()(entries_[pos])))
+            return pos;
+        return entries_.size();
+    }
+
+    size_t nextLive(size_t pos) const
+    {
+        while (pos < entries_.size() && !live_[pos])
+            ++pos;
+        return pos;
+    }
+
+    //! removes the dead entries
+    void compact()
+    {
+        size_t out = 0;
+        for (size_t in = first_; in < entries_.size(); ++in) {
+            if (live_[in]) {
+                if (out != in)
+                    entries_[out] = std::move(entries_[in]);
+                ++out;
+            }
+        }
+        entries_.resize(out);
+        live_.assign(out, 1);
+        first_ = 0;
+    }
+
+    //! returns the position of the entry with the given key, inserting the given entry if absent
+    size_t emplace(const Key& key, Entry&& entry, bool& inserted)
+    {
+        inserted = true;
+
+        // keys often come in increasing order
+        if (entries_.empty() || KeyOf()(entries_.back()) < key) {
+            if (size_ == 0)
+                clear();
+            entries_.push_back(std::move(entry));
+            live_.push_back(1);
+            if (size_++ == 0)
+                first_ = entries_.size() - 1;
+            return entries_.size() - 1;
+        }
+
+        size_t pos = lowerBound(key);
+        if (!(key < KeyOf()(entries_[pos]))) {
+            // the key is in the table, possibly dead
+            if (live_[pos]) {
+                inserted = false;
+                return pos;
+            }
+            entries_[pos] = std::move(entry);
+            live_[pos] = 1;
+            first_ = (size_++ == 0) ? pos : std::min(first_, pos);
+            return pos;
+        }
+
+        if (size_ < entries_.size()) {
+            compact();
+            pos = lowerBound(key);
+        }
+        entries_.insert(entries_.begin() + pos, std::move(entry));
+        live_.insert(live_.begin() + pos, 1);
+        first_ = (size_++ == 0) ? pos : std::min(first_, pos);
+        return pos;
+    }
+
+    void kill(size_t pos)
+    {
+        live_[pos] = 0;
+        --size_;
+        if (pos == first_)
+            first_ = nextLive(pos);
+    }
+
+  public:
+    template<typename T, typename Table>
+    class Iterator
+    {
+        Table *table_ = nullptr;
+        size_t pos_ = 0;
+
+      public:
+        Iterator() {}
+        Iterator(Table *table, size_t pos) : table_(table), pos_(pos) {}
+        // iterator to const_iterator
+        template<typename T2, typename Table2>
+        Iterator(const Iterator<T2, Table2>& other) : table_(other.table()), pos_(other.position()) {}
+        T& operator*() const { return table_->entries_[pos_]; }
+        T *operator->() const { return &table_->entries_[pos_]; }
+        Iterator& operator++() { pos_ = table_->nextLive(pos_ + 1); return *this; }
+        Iterator operator++(int) { Iterator it = *this; ++(*this); return it; }
+        bool operator==(const Iterator& other) const { return pos_ == other.pos_; }
+        bool operator!=(const Iterator& other) const { return pos_ != other.pos_; }
+        Table *table() const { return table_; }
+        size_t position() const { return pos_; }
+    };
+
+    FlatTable() {}
+    FlatTable(const FlatTable& other) { *this = other; }
+
+    //! copies the live entries only, into the storage already owned by this table
+    FlatTable& operator=(const FlatTable& other)
+    {
+        if (&other == this)
+            return *this;
+        entries_.clear();
+        for (size_t i = other.first_; i < other.entries_.size(); ++i) {
+            if (other.live_[i])
+                entries_.push_back(other.entries_[i]);
+        }
+        live_.assign(entries_.size(), 1);
+        size_ = entries_.size();
+        first_ = 0;
+        return *this;
+    }
+
+    void swap(FlatTable& other)
+    {
+        entries_.swap(other.entries_);
+        live_.swap(other.live_);
+        std::swap(size_, other.size_);
+        std::swap(first_, other.first_);
+    }
+
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    size_t count(const Key& key) const { return position(key) != entries_.size() ? 1 : 0; }
+
+    //! removes all the entries, keeping the storage
+    void clear()
+    {
+        entries_.clear();
+        live_.clear();
+        size_ = 0;
+        first_ = 0;
+    }
+
+    size_t erase(const Key& key)
+    {
+        size_t pos = position(key);
+        if (pos == entries_.size())
+            return 0;
+        kill(pos);
+        return 1;
+    }
+};
+
+template<typename Key>
+struct FlatSetKeyOf
+{
+    const Key& operator()(const Key& entry) const { return entry; }
+};
+
+//! Sorted set in contiguous storage, see FlatTable.
+template<typename Key>
+class FlatSet : public FlatTable<Key, Key, FlatSetKeyOf<Key>>
+{
+    typedef FlatTable<Key, Key, FlatSetKeyOf<Key>> Base;
+
+  public:
+    typedef Key value_type;
+    typedef typename Base::template Iterator<const Key, const FlatSet> iterator;
+    typedef iterator const_iterator;
+
+    const_iterator begin() const { return const_iterator(this, this->nextLive(this->first_)); }
+    const_iterator end() const { return const_iterator(this, this->entries_.size()); }
+
+    const_iterator find(const Key& key) const { return const_iterator(this, this->position(key)); }
+
+    bool insert(const Key& key)
+    {
+        bool inserted;
+        this->emplace(key, Key(key), inserted);
+        return inserted;
+    }
+
+    using Base::erase;
+
+    //! erases the entry and returns the next one. The other iterators stay valid
+    const_iterator erase(const_iterator it)
+    {
+        this->kill(it.position());
+        return const_iterator(this, this->nextLive(it.position() + 1));
+    }
+};
+
+template<typename Key, typename Value>
+struct FlatMapKeyOf
+{
+    const Key& operator()(const std::pair<Key, Value>& entry) const { return entry.first; }
+};
+
+//! Sorted map in contiguous storage, see FlatTable.
+/*!
+   References to values are invalidated by the insertion of a new key.
+ */
+template<typename Key, typename Value>
+class FlatMap : public FlatTable<std::pair<Key, Value>, Key, FlatMapKeyOf<Key, Value>>
+{
+    typedef FlatTable<std::pair<Key, Value>, Key, FlatMapKeyOf<Key, Value>> Base;
+
+  public:
+    typedef std::pair<Key, Value> value_type;
+    typedef typename Base::template Iterator<value_type, FlatMap> iterator;
+    typedef typename Base::template Iterator<const value_type, const FlatMap> const_iterator;
+
+    iterator begin() { return iterator(this, this->nextLive(this->first_)); }
+    iterator end() { return iterator(this, this->entries_.size()); }
+    const_iterator begin() const { return const_iterator(this, this->nextLive(this->first_)); }
+    const_iterator end() const { return const_iterator(this, this->entries_.size()); }
+
+    iterator find(const Key& key) { return iterator(this, this->position(key)); }
+    const_iterator find(const Key& key) const { return const_iterator(this, this->position(key)); }
+
+    Value& operator[](const Key& key)
+    {
+        bool inserted;
+        return this->entries_[this->emplace(key, value_type(key, Value()), inserted)].second;
+    }
+
+    Value& at(const Key& key)
+    {
+        size_t pos = this->position(key);
+        if (pos == this->entries_.size())
+            throw std::out_of_range("FlatMap::at - key not found");
+        return this->entries_[pos].second;
+    }
+
+    const Value& at(const Key& key) const
+    {
+        size_t pos = this->position(key);
+        if (pos == this->entries_.size())
+            throw std::out_of_range("FlatMap::at - key not found");
+        return this->entries_[pos].second;
+    }
+
+    using Base::erase;
+
+    //! erases the entry and returns the next one. The other iterators stay valid
+    iterator erase(iterator it)
+    {
+        this->kill(it.position());
+        return iterator(this, this->nextLive(it.position() + 1));
+    }
+};
+
+} //namespace
+
+#endif // _LTE_FLATSET_H_
@@ -38,6 +38,7 @@
 #include <inet/common/Protocol.h>
 
 #include "common/features.h"
+#include "common/FlatSet.h"
 #include "common/LteCommonEnum_m.h"
 
 namespace simu5g
@@ -166,6 +167,10 @@ namespace simu5g
     /// Numerology Index
     typedef unsigned short NumerologyIndex;
 
+    /// Dense index of a component carrier, assigned by the Binder at registration
+    typedef unsigned short CarrierIndex;
+    const CarrierIndex CARRIER_INDEX_NONE = 0xFFFF;
+
     /// identifies a traffic flow template
     typedef int TrafficFlowTemplateId;
 
@@ -187,9 +192,6 @@ namespace simu5g
         FiveQI fiveQi;
         simtime_t arrivalTime;
     };
-    // List of MAC Control Information
-    typedef std::vector<MacPduMetaData> MacPduMetaDataList;
-    
 
 
     // Attenuation vector for analogue models
@@ -483,8 +485,9 @@ namespace simu5g
     /**
      * This is the Schedule list, a list of schedule elements.
      * For each CID on each codeword there is a number of SDUs
+     * (a flat sorted table: it is filled and walked every TTI)
      */
-    typedef std::map<std::pair<MacCid, Codeword>, unsigned int> LteMacScheduleList;
+    typedef FlatMap<std::pair<MacCid, Codeword>, unsigned int> LteMacScheduleList;
 
     /**
      * This is the Pdu list, a list of scheduled Pdus for
@@ -628,6 +631,7 @@ namespace simu5g
         BandLimitVector bandLimit;
         NumerologyIndex numerologyIndex;
         SlotFormat slotFormat;
+        CarrierIndex carrierIndex = CARRIER_INDEX_NONE;
     };
     typedef std::map<double, CarrierInfo> CarrierInfoMap;
 
@@ -643,7 +647,8 @@ namespace simu5g
     typedef std::pair<int, simtime_t> PacketInfo;
     typedef std::vector<RemoteUnitPhyData> RemoteUnitPhyDataVector;
     typedef std::set<MacNodeId> ActiveUser;
-    typedef std::set<MacCid> ActiveSet;
+    // connections with data to send, copied into working sets at each TTI
+    typedef FlatSet<MacCid> ActiveSet;
 
     /**
      * Used at initialization to pass the parameters
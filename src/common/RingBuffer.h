@@ -0,0 +1,115 @@
+//
+//                  Simu5G-NR-EDF (Extension of Simu5G)
+//
+// Original Authors: Giovanni Nardini, Giovanni Stea, Antonio Virdis (University of Pisa)
+// Extension Authors: Alaf Nascimento, Philippe Martins, Samuel Tardieu, Laurent Pautet (Institut Polytechnique de Paris)
+//
+// This file is part of a software released under the license included in file
+// "license.pdf". Please read LICENSE and README files before using it.
+// The above files and the present reference are part of the software itself,
+// and cannot be removed from it.
+//
+
+#ifndef _LTE_RINGBUFFER_H_
+#define _LTE_RINGBUFFER_H_
+
+#include <vector>
+#include <assert.h>
+
+namespace simu5g {
+
+//! FIFO of elements stored in a contiguous circular array.
+/*!
+   A growable ring buffer doubles its storage when full; a fixed-capacity one
+   overwrites its oldest element instead. Index 0 is always the oldest element.
+ */
+template<typename T>
+class RingBuffer
+{
+    //! Storage. Its size is the capacity of the buffer.
+    std::vector<T> buf_;
+
+    //! Position of the oldest element.
+    unsigned int head_ = 0;
+
+    //! Number of stored elements.
+    unsigned int size_ = 0;
+
+    //! If false, pushing into a full buffer drops the oldest element.
+    bool growable_ = true;
+
+    void grow()
+    {
+        std::vector<T> larger(buf_.empty() ? 4 : 2 * buf_.size());
+        for (unsigned int i = 0; i < size_; ++i)
+            larger[i] = std::move((*this)[i]);
+        buf_.swap(larger);
+        head_ = 0;
+    }
+
+  public:
+    //! Create an empty buffer.
+    explicit RingBuffer(unsigned int capacity = 0, bool growable = true) : buf_(capacity), growable_(growable)
+    {
+    }
+
+    //! Return true if the buffer is empty.
+    bool empty() const { return size_ == 0; }
+
+    //! Return the number of elements.
+    unsigned int size() const { return size_; }
+
+    //! Return the number of elements that fit without growing.
+    unsigned int capacity() const { return buf_.size(); }
+
+    //! Return true if the next push will grow the buffer or drop an element.
+    bool full() const { return size_ == buf_.size(); }
+
+    //! Removes all the elements, keeping the storage.
+    void clear()
+    {
+        head_ = 0;
+        size_ = 0;
+    }
+
+    //! Append an element after the newest one.
+    void push_back(const T& t)
+    {
+        if (full()) {
+            if (growable_ || buf_.empty())
+                grow();
+            else {
+                // overwrite the oldest element
+                buf_[head_] = t;
+                head_ = (head_ + 1) % buf_.size();
+                return;
+            }
+        }
+        buf_[(head_ + size_) % buf_.size()] = t;
+        ++size_;
+    }
+
+    //! Removes the oldest element.
+    void pop_front()
+    {
+        assert(size_ > 0);
+        head_ = (head_ + 1) % buf_.size();
+        --size_;
+    }
+
+    //! Return the oldest element.
+    const T& front() const { assert(size_ > 0); return buf_[head_]; }
+    T& front() { assert(size_ > 0); return buf_[head_]; }
+
+    //! Return the newest element.
+    const T& back() const { assert(size_ > 0); return (*this)[size_ - 1]; }
+    T& back() { assert(size_ > 0); return (*this)[size_ - 1]; }
+
+    //! Return the i-th oldest element.
+    const T& operator[](unsigned int i) const { return buf_[(head_ + i) % buf_.size()]; }
+    T& operator[](unsigned int i) { return buf_[(head_ + i) % buf_.size()]; }
+};
+
+} //namespace
+
+#endif // _LTE_RINGBUFFER_H_
@@ -18,6 +18,7 @@
 #include "corenetwork/statsCollector/BaseStationStatsCollector.h"
 #include "corenetwork/statsCollector/UeStatsCollector.h"
 #include "stack/mac/LteMacUe.h"
+#include "stack/mac/scheduler/CellSchedulingPool.h"
 #include "stack/phy/LtePhyUe.h"
 
 namespace simu5g {
@@ -36,34 +37,45 @@ void Binder::registerCarrier(double carrierFrequency, unsigned int carrierNumBan
         EV << "Binder::registerCarrier - Carrier @ " << carrierFrequency << "GHz already registered" << endl;
     }
     else {
+        CarrierIndex carrierIndex = getCarrierIndex(carrierFrequency);
+        if (carrierIndex == CARRIER_INDEX_NONE) {
+            // first registration: the carrier gets the next dense index
+            carrierIndex = carrierFrequencies_.size();
+            carrierFrequencies_.push_back(carrierFrequency);
+            carrierUeSets_.emplace_back();
+            carrierNumerology_.push_back(numerologyIndex);
+            carrierSlotFormat_.emplace_back();
+        }
+
         CarrierInfo cInfo;
         cInfo.carrierFrequency = carrierFrequency;
         cInfo.numBands = carrierNumBands;
         cInfo.numerologyIndex = numerologyIndex;
         cInfo.slotFormat = computeSlotFormat(useTdd, tddNumSymbolsDl, tddNumSymbolsUl);
+        cInfo.carrierIndex = carrierIndex;
         componentCarriers_[carrierFrequency] = cInfo;
 
         // update total number of bands in the system
         totalBands_ += carrierNumBands;
 
-        EV << "Binder::registerCarrier - Registered component carrier @ " << carrierFrequency << "GHz" << endl;
+        EV << "Binder::registerCarrier - Registered component carrier @ " << carrierFrequency << "GHz (index " << carrierIndex << ")" << endl;
 
-        carrierFreqToNumerologyIndex_[carrierFrequency] = numerologyIndex;
+        carrierNumerology_[carrierIndex] = numerologyIndex;
+        carrierSlotFormat_[carrierIndex] = cInfo.slotFormat;
 
-        // add new (empty) entry to carrierUeMap
-        std::set<MacNodeId> tempSet;
-        carrierUeMap_[carrierFrequency] = tempSet;
+        // start with an empty set of UEs
+        carrierUeSets_[carrierIndex].clear();
     }
 }
 
 void Binder::registerCarrierUe(double carrierFrequency, unsigned int numerologyIndex, MacNodeId ueId)
 {
     // check if carrier exists in the system
-    CarrierUeMap::iterator it = carrierUeMap_.find(carrierFrequency);
-    if (it == carrierUeMap_.end())
+    CarrierIndex carrierIndex = getCarrierIndex(carrierFrequency);
+    if (carrierIndex == CARRIER_INDEX_NONE)
         throw cRuntimeError("Binder::registerCarrierUe - Carrier [%fGHz] not found", carrierFrequency);
 
-    carrierUeMap_[carrierFrequency].insert(ueId);
+    carrierUeSets_[carrierIndex].insert(ueId);
 
     if (ueNumerologyIndex_.find(ueId) == ueNumerologyIndex_.end()) {
         std::set<NumerologyIndex> numerologySet;
@@ -81,11 +93,11 @@ void Binder::registerCarrierUe(double carrierFrequency, unsigned int numerologyI
 
 const UeSet& Binder::getCarrierUeSet(double carrierFrequency)
 {
-    CarrierUeMap::iterator it = carrierUeMap_.find(carrierFrequency);
-    if (it == carrierUeMap_.end())
+    CarrierIndex carrierIndex = getCarrierIndex(carrierFrequency);
+    if (carrierIndex == CARRIER_INDEX_NONE)
         throw cRuntimeError("Binder::getCarrierUeSet - Carrier [%fGHz] not found", carrierFrequency);
 
-    return carrierUeMap_[carrierFrequency];
+    return carrierUeSets_[carrierIndex];
 }
 
 NumerologyIndex Binder::getUeMaxNumerologyIndex(MacNodeId ueId)
@@ -129,11 +141,11 @@ SlotFormat Binder::computeSlotFormat(bool useTdd, unsigned int tddNumSymbolsDl,
 
 SlotFormat Binder::getSlotFormat(double carrierFrequency)
 {
-    CarrierInfoMap::iterator it = componentCarriers_.find(carrierFrequency);
-    if (it == componentCarriers_.end())
+    CarrierIndex carrierIndex = getCarrierIndex(carrierFrequency);
+    if (carrierIndex == CARRIER_INDEX_NONE)
         throw cRuntimeError("Binder::getSlotFormat - Carrier [%fGHz] not found", carrierFrequency);
 
-    return it->second.slotFormat;
+    return carrierSlotFormat_[carrierIndex];
 }
 
 void Binder::unregisterNode(MacNodeId id)
@@ -255,6 +267,14 @@ void Binder::initialize(int stage)
     if (stage == inet::INITSTAGE_LOCAL) {
         phyPisaData.setBlerShift(par("blerShift"));
         networkName_ = getSystemModule()->getName();
+
+        int schedulingThreads = par("schedulingThreads");
+        if (schedulingThreads > 0) {
+            cellSchedulingPool_ = new CellSchedulingPool(getSimulation(), schedulingThreads);
+            schedulingBarrier_ = new cMessage("schedulingBarrier");
+            // same priority as the slot ticks, before the HARQ flushes they schedule
+            schedulingBarrier_->setSchedulingPriority(1);
+        }
     }
 
     if (stage == inet::INITSTAGE_LAST) {
@@ -265,6 +285,21 @@ void Binder::initialize(int stage)
     }
 }
 
+void Binder::handleMessage(cMessage *msg)
+{
+    if (msg == schedulingBarrier_)
+        cellSchedulingPool_->run();
+}
+
+void Binder::queueDownlinkScheduling(LteMacEnb *mac)
+{
+    Enter_Method_Silent("queueDownlinkScheduling");
+    // the barrier is inserted after the slot ticks of the other cells, which were scheduled in the
+    // previous slot, and before the HARQ flush of the queuing cell
+    if (cellSchedulingPool_->add(mac))
+        scheduleAt(NOW, schedulingBarrier_);
+}
+
 void Binder::finish()
 {
     if (par("printTrafficGeneratorConfig").boolValue()) {
@@ -388,7 +423,7 @@ LteMacBase *Binder::getMacFromMacNodeId(MacNodeId id)
 
 MacNodeId Binder::getNextHop(MacNodeId slaveId)
 {
-    Enter_Method_Silent("getNextHop");
+    // no context switch, this is called by the AMC of the cells scheduled in parallel
     if (num(slaveId) >= nextHop_.size())
         throw cRuntimeError("Binder::getNextHop(): bad slave id %hu", num(slaveId));
     return nextHop_[num(slaveId)];
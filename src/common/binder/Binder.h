@@ -29,6 +29,8 @@ namespace simu5g {
 using namespace omnetpp;
 
 class UeStatsCollector;
+class CellSchedulingPool;
+class LteMacEnb;
 
 /**
  * The Binder module has one instance in the whole network.
@@ -96,12 +98,13 @@ class Binder : public cSimpleModule
     unsigned int totalBands_ = 0;
     CarrierInfoMap componentCarriers_;
 
-    // for each carrier, store the UEs that are able to use it
-    typedef std::map<double, UeSet> CarrierUeMap;
-    CarrierUeMap carrierUeMap_;
+    // frequency of each registered carrier, indexed by its CarrierIndex
+    std::vector<double> carrierFrequencies_;
 
-    // hack to link carrier freq to numerology index
-    std::map<double, NumerologyIndex> carrierFreqToNumerologyIndex_;
+    // per-carrier state, indexed by CarrierIndex
+    std::vector<UeSet> carrierUeSets_;               // UEs that are able to use the carrier
+    std::vector<NumerologyIndex> carrierNumerology_;
+    std::vector<SlotFormat> carrierSlotFormat_;
     // max numerology index used by UEs
     std::vector<NumerologyIndex> ueMaxNumerologyIndex_;
     // set of numerologies used by each UE
@@ -147,12 +150,17 @@ class Binder : public cSimpleModule
     std::set<MacNodeId> ueHandoverTriggered_;
     std::map<MacNodeId, std::pair<MacNodeId, MacNodeId>> handoverTriggered_;
 
+    /*
+     * Parallel scheduling of the cells
+     */
+    CellSchedulingPool *cellSchedulingPool_ = nullptr;
+    // runs the queued downlink scheduling of the cells
+    cMessage *schedulingBarrier_ = nullptr;
+
   protected:
     void initialize(int stages) override;
     int numInitStages() const override { return inet::NUM_INIT_STAGES; }
-    void handleMessage(cMessage *msg) override
-    {
-    }
+    void handleMessage(cMessage *msg) override;
 
     void finish() override;
 
@@ -179,8 +187,25 @@ class Binder : public cSimpleModule
 
         for (auto ue : ueList_)
             delete ue;
+
+        cancelAndDelete(schedulingBarrier_);
+        delete cellSchedulingPool_;
     }
 
+    /**
+     * Returns the pool scheduling the cells in parallel, nullptr if cells are scheduled sequentially
+     */
+    CellSchedulingPool *getCellSchedulingPool()
+    {
+        return cellSchedulingPool_;
+    }
+
+    /**
+     * Queues the downlink scheduling of the cell, which runs with the one of the other cells
+     * whose slot starts now.
+     */
+    void queueDownlinkScheduling(LteMacEnb *mac);
+
     std::string& getNetworkName()
     {
         return networkName_;
@@ -201,6 +226,25 @@ class Binder : public cSimpleModule
      * Returns the set of UEs enabled on the given carrier
      */
     const UeSet& getCarrierUeSet(double carrierFrequency);
+    const UeSet& getCarrierUeSetByIndex(CarrierIndex carrierIndex) { return carrierUeSets_.at(carrierIndex); }
+
+    /**
+     * Returns the dense index of the given carrier, CARRIER_INDEX_NONE if it is not registered.
+     * Per-carrier state can be stored in arrays indexed by it
+     */
+    CarrierIndex getCarrierIndex(double carrierFrequency) const
+    {
+        // a handful of carriers at most: a scan of contiguous memory beats a tree walk
+        for (size_t i = 0; i < carrierFrequencies_.size(); i++) {
+            if (carrierFrequencies_[i] == carrierFrequency)
+                return CarrierIndex(i);
+        }
+        return CARRIER_INDEX_NONE;
+    }
+
+    double getCarrierFrequency(CarrierIndex carrierIndex) const { return carrierFrequencies_.at(carrierIndex); }
+
+    unsigned int getNumCarriers() const { return carrierFrequencies_.size(); }
 
     /**
      * Returns the max numerology index used by the given UE
@@ -215,7 +259,11 @@ class Binder : public cSimpleModule
     /**
      * Returns the numerology associated to a carrier frequency
      */
-    NumerologyIndex getNumerologyIndexFromCarrierFreq(double carrierFreq) { return carrierFreqToNumerologyIndex_[carrierFreq]; }
+    NumerologyIndex getNumerologyIndexFromCarrierFreq(double carrierFreq)
+    {
+        CarrierIndex c = getCarrierIndex(carrierFreq);
+        return (c == CARRIER_INDEX_NONE) ? 0 : carrierNumerology_[c];
+    }
 
     /**
      * Returns the slot duration associated to the numerology (in seconds)
@@ -231,6 +279,7 @@ class Binder : public cSimpleModule
      * Returns the slot format for the given carrier
      */
     SlotFormat getSlotFormat(double carrierFrequency);
+    const SlotFormat& getSlotFormatByIndex(CarrierIndex carrierIndex) { return carrierSlotFormat_.at(carrierIndex); }
 
     /**
      * Registers a node to the global Binder module.
@@ -9,8 +9,12 @@
 // and cannot be removed from it.
 //
 
+#include <algorithm>
+#include <cmath>
+
 #include <omnetpp.h>
 #include "common/blerCurves/PhyPisaData.h"
+#include "common/blerCurves/BLERvsSINR_15CQI_TU.h"
 
 namespace simu5g {
 
@@ -2650,8 +2654,7 @@ double lambdaTable[][3] = {
 
 PhyPisaData::PhyPisaData()
 {
-    memcpy(blerCurves_, blerCurvesNew, sizeof(double) * 3 * 15 * 49);
-    memcpy(lambdaTable_, lambdaTable, sizeof(double) * 10000 * 3);
+    initBlerGrid();
     channel_.resize(10000);
     double x, y;
 
@@ -2666,6 +2669,50 @@ PhyPisaData::~PhyPisaData()
 {
 }
 
+void PhyPisaData::initBlerGrid()
+{
+    const int numPoints = 16;
+    double maxSinr = SINR_15_CQI_TU[0][numPoints - 1];
+    blerGridMin_ = SINR_15_CQI_TU[0][0];
+    for (int c = 0; c < numBlerCurves - 1; c++) {
+        blerGridMin_ = std::min(blerGridMin_, SINR_15_CQI_TU[c][0]);
+        maxSinr = std::max(maxSinr, SINR_15_CQI_TU[c][numPoints - 1]);
+    }
+    blerGridSize_ = (maxSinr - blerGridMin_) / blerGridStep + 1;
+    blerGrid_.assign(numBlerCurves * blerGridSize_, 0);
+
+    // GetBLER_TU() is called with CQI 0 for the lowest CQI, and reads before its tables: the BLER has
+    // always been 1 up to 0 dB and 0 above
+    blerFirstSinr_[0] = blerLastSinr_[0] = 0;
+
+    for (int j = 1; j < numBlerCurves; j++) {
+        const double *sinr = SINR_15_CQI_TU[j - 1];
+        blerFirstSinr_[j] = sinr[0];
+        blerLastSinr_[j] = sinr[numPoints - 1];
+        for (int p = 0; p < numPoints; p++) {
+            if (fmod(sinr[p] - blerGridMin_, blerGridStep) != 0)
+                throw cRuntimeError("PhyPisaData::initBlerGrid - BLER curve %d has a point off the %g dB grid", j, blerGridStep);
+        }
+
+        for (unsigned int k = 0; k < blerGridSize_; k++) {
+            double s = blerGridMin_ + k * blerGridStep;
+
+            // the ends of the curve are the first and last BLER points, GetBLER_TU() saturates there
+            if (s == sinr[0])
+                blerGrid_[j * blerGridSize_ + k] = BLER_15_CQI_TU[j - 1][0];
+            else if (s == sinr[numPoints - 1])
+                blerGrid_[j * blerGridSize_ + k] = BLER_15_CQI_TU[j - 1][numPoints - 1];
+            else
+                blerGrid_[j * blerGridSize_ + k] = GetBLER_TU(s, j);
+        }
+    }
+}
+
+double PhyPisaData::getLambda(int i, int j)
+{
+    return lambdaTable[i][j];
+}
+
 double PhyPisaData::getChannel(unsigned int i)
 {
     i = i % channel_.size();
@@ -16,23 +16,35 @@
 #include <vector>
 #include <iostream>
 
-#include "common/blerCurves/BLERvsSINR_15CQI_TU.h"
-
 namespace simu5g {
 
 class PhyPisaData
 {
-    double lambdaTable_[10000][3];
-    double blerCurves_[3][15][49];
+    /*
+     * BLER curves of GetBLER_TU() (BLERvsSINR_15CQI_TU.h), indexed by its CQI argument, sampled every
+     * blerGridStep dB from blerGridMin_. All the points of the curves lie on the grid, so linear
+     * interpolation between two samples gives the same BLER as the curve, without searching the points.
+     * Curve j is at blerGrid_[j * blerGridSize_]; it is 1 up to blerFirstSinr_[j] and 0 from blerLastSinr_[j]
+     */
+    static constexpr int numBlerCurves = 16;
+    static constexpr double blerGridStep = 0.5;
+    double blerGridMin_ = 0;
+    unsigned int blerGridSize_ = 0;
+    std::vector<double> blerGrid_;
+    double blerFirstSinr_[numBlerCurves];
+    double blerLastSinr_[numBlerCurves];
+
     std::vector<double> channel_;
 
     int blerShift_ = 0;
 
+    void initBlerGrid();
+
   public:
     PhyPisaData();
     virtual ~PhyPisaData();
 
-    double getLambda(int i, int j) { return lambdaTable_[i][j]; }
+    double getLambda(int i, int j);
     int nTxMode() { return 3; }
     int nMcs() { return 15; }
 
@@ -40,8 +52,20 @@ class PhyPisaData
     int maxChannel2() { return 1000; }
 
     // getBler gets the following parameters: (txMode , CQI, SINR)
-    //double getBler(int i, int j, int k){if (j==0) return 1; else return blerCurves_[i][j][k-1+blerShift_];}
-    double getBler(int i, int j, int k) { return GetBLER_TU(k + blerShift_, j); };
+    double getBler(int i, int j, double sinr) const
+    {
+        sinr += blerShift_;
+        if (sinr <= blerFirstSinr_[j])
+            return 1.0;
+        if (sinr >= blerLastSinr_[j])
+            return 0.0;
+
+        double pos = (sinr - blerGridMin_) / blerGridStep;
+        unsigned int k = pos;
+        const double *bler = &blerGrid_[j * blerGridSize_ + k];
+        return bler[0] + (pos - k) * (bler[1] - bler[0]);
+    }
+
     int minSnr() { return -14 - blerShift_; }//SINR_15_CQI_TU [0] [0];}
     int maxSnr() { return 40 - blerShift_; }//SINR_15_CQI_TU [14] [15];}
 
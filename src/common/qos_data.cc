@@ -11,21 +11,22 @@
 //
 
 #include "qos_data.h"
-#include <algorithm> // for std::find_if
 
-const qos_data::QoS5G get_qos_parameters(int qos_id)
-{
-    qos_data qos;
-
-    // Compares each QoS5G struct's fiveQI with the provided qos_id
-    // Returns true when it finds a match
-    auto it = std::find_if(qos.QoS5GTable.begin(), qos.QoS5GTable.end(),
-                           [qos_id](const qos_data::QoS5G &params)
-                           {
-                               return params.fiveQI == qos_id;
-                           });
+// sanity checks on the compile-time table
+static_assert(QoS5GTable[0].fiveQI == 0 && QoS5GTable[0].resource_type == qos_data::NONE, "5QI 0 must stay unassigned");
+static_assert(QoS5GTable[85].resource_type == qos_data::DCGBR && QoS5GTable[85].packet_delay_budget == 5, "5QI table lookup mismatch");
+static_assert(QoS5GTable[9].resource_type == qos_data::NGBR, "5QI table lookup mismatch");
 
-    // If found (it's not end()), returns the found QoS5G struct
-    // If not found, returns empty QoS5G struct
-    return (it != qos.QoS5GTable.end()) ? *it : qos_data::QoS5G{};
+const char *resourceTypeToA(qos_data::ResourceType type)
+{
+    switch (type) {
+        case qos_data::GBR:
+            return "GBR";
+        case qos_data::NGBR:
+            return "NGBR";
+        case qos_data::DCGBR:
+            return "DCGBR";
+        default:
+            return "NONE";
+    }
 }
@@ -19,6 +19,7 @@
 #include "stack/mac/LteMacEnb.h"
 #include "stack/mac/LteMacUe.h"
 #include "stack/mac/buffer/harq/LteHarqBufferRx.h"
+#include "stack/mac/buffer/harq/LteHarqBufferTx.h"
 #include "stack/mac/buffer/LteMacBuffer.h"
 #include "stack/mac/buffer/LteMacQueue.h"
 #include "stack/phy/packet/LteFeedbackPkt.h"
@@ -62,6 +63,8 @@ namespace simu5g
 
         for (auto &[key, value] : bsrbuf_)
             delete value;
+
+        cancelAndDelete(miniSlotTick_);
     }
 
     /***********************
@@ -81,16 +84,19 @@ namespace simu5g
     }
 
     SchedDiscipline LteMacEnb::getSchedDiscipline(Direction dir)
+    {
+        return aToSchedDiscipline(getSchedDisciplineName(dir));
+    }
+
+    std::string LteMacEnb::getSchedDisciplineName(Direction dir)
     {
         if (dir == DL)
-            return aToSchedDiscipline(
-                par("schedulingDisciplineDl").stdstringValue());
+            return par("schedulingDisciplineDl").stdstringValue();
         else if (dir == UL)
-            return aToSchedDiscipline(
-                par("schedulingDisciplineUl").stdstringValue());
+            return par("schedulingDisciplineUl").stdstringValue();
         else
         {
-            throw cRuntimeError("LteMacEnb::getSchedDiscipline(): unrecognized direction %d", (int)dir);
+            throw cRuntimeError("LteMacEnb::getSchedDisciplineName(): unrecognized direction %d", (int)dir);
         }
     }
 
@@ -137,6 +143,7 @@ namespace simu5g
             numAntennas_ = getNumAntennas();
 
             eNodeBCount = par("eNodeBCount");
+            rlcUm_ = inet::findModuleFromPar<LteRlcUm>(par("rlcUmModule"), this);
             WATCH(numAntennas_);
             WATCH_MAP(bsrbuf_);
         }
@@ -208,6 +215,11 @@ namespace simu5g
                 double carrierFrequency = item.second.carrierFrequency;
                 bgTrafficManager_[carrierFrequency] = check_and_cast<IBackgroundTrafficManager *>(getParentModule()->getSubmodule("bgTrafficGenerator", i)->getSubmodule("manager"));
                 bgTrafficManager_[carrierFrequency]->setCarrierFrequency(carrierFrequency);
+
+                // the traffic generators of the background UEs are modules, they cannot be updated from the scheduling threads
+                IBackgroundTrafficManager *bgManager = bgTrafficManager_[carrierFrequency];
+                if (binder_->getCellSchedulingPool() != nullptr && bgManager->getBgUesBegin() != bgManager->getBgUesEnd())
+                    throw cRuntimeError("LteMacEnb::initialize - background UEs are not supported with parallel scheduling (Binder parameter schedulingThreads > 0)");
                 ++i;
             }
         }
@@ -220,6 +232,19 @@ namespace simu5g
             ttiPeriod_ = binder_->getSlotDurationFromNumerologyIndex(cellInfo_->getMaxNumerologyIndex());
             scheduleAt(NOW + ttiPeriod_, ttiTick_);
 
+            // mini-slots are defined on the slot of the largest numerology
+            miniSlotSymbols_ = par("miniSlotSymbols").intValue();
+            if (miniSlotSymbols_ > 0)
+            {
+                if (miniSlotSymbols_ != 2 && miniSlotSymbols_ != 4 && miniSlotSymbols_ != 7)
+                    throw cRuntimeError("LteMacEnb::initialize - a mini-slot spans 2, 4 or 7 symbols, %u given", miniSlotSymbols_);
+                if (dynamic_cast<NRAmc *>(amc_) == nullptr)
+                    throw cRuntimeError("LteMacEnb::initialize - mini-slots are only supported by NR base stations");
+                miniSlotTick_ = new cMessage("miniSlotTick");
+                miniSlotTick_->setSchedulingPriority(1); // after other messages
+                miniSlotDuration_ = ttiPeriod_ * miniSlotSymbols_ / 14;
+            }
+
             const CarrierInfoMap *carriers = cellInfo_->getCarrierInfoMap();
             for (const auto &item : *carriers)
             {
@@ -246,6 +271,11 @@ namespace simu5g
                 delete msg;
                 return;
             }
+            if (msg == miniSlotTick_)
+            {
+                handleMiniSlot();
+                return;
+            }
         }
         LteMacBase::handleMessage(msg);
     }
@@ -300,6 +330,8 @@ namespace simu5g
 
     void LteMacEnb::bufferizeBsr(MacBsr *bsr, MacCid cid)
     {
+        enbSchedulerUl_->signalBsr(cid, bsr->getSize(), bsr->getTimestamp());
+
         LteMacBufferMap::iterator it = bsrbuf_.find(cid);
         if (it == bsrbuf_.end())
         {
@@ -511,27 +543,45 @@ namespace simu5g
         sendLowerPackets(pkt);
     }
 
-    // Return the list of MAC PDU metadata
-    MacPduMetaDataList *LteMacEnb::getMacPduMetaDataList() const
+    // Return the store of MAC PDU metadata
+    MacPduMetaDataStore *LteMacEnb::getMacPduMetaDataStore() const
     {
-        return enbSchedulerDl_->readMacPduMetaDataList();
+        return enbSchedulerDl_->readMacPduMetaDataStore();
     }
 
-    void LteMacEnb::insertMacPduMetaData(MacPduMetaData meta)
+    void LteMacEnb::insertMacPduMetaData(const MacPduMetaData &meta)
     {
         enbSchedulerDl_->insertMacPduMetaData(meta);
     }
 
+    unsigned int LteMacEnb::discardHolSdu(MacCid cid)
+    {
+        auto it = macBuffers_.find(cid);
+        if (it == macBuffers_.end() || it->second->isEmpty())
+            return 0;
+
+        // the RLC keeps the SDU if some of its fragments have already been sent
+        if (rlcUm_ == nullptr || !rlcUm_->discardHolSdu(cid))
+            return 0;
+
+        PacketInfo vpkt = it->second->popFront();
+        EV << NOW << " LteMacEnb::discardHolSdu - cid[" << cid << "] discarded SDU of " << vpkt.first << " bytes" << endl;
+        return vpkt.first;
+    }
+
     // alaf
     void LteMacEnb::macPduMake(MacCid cid, FiveQI fiveQi, simtime_t arrivalTime, bool isLteRlcPduNewData)
     {
-        MacPduMetaData meta;
-        meta.cid = cid;
-        meta.fiveQi = fiveQi;
-        meta.arrivalTime = arrivalTime;
+        // one metadata entry per SDU in the virtual buffer, added with the new data notification
+        if (isLteRlcPduNewData)
+        {
+            MacPduMetaData meta;
+            meta.cid = cid;
+            meta.fiveQi = fiveQi;
+            meta.arrivalTime = arrivalTime;
 
-        // Add metadata to the list
-        enbSchedulerDl_->insertMacPduMetaData(meta);
+            enbSchedulerDl_->insertMacPduMetaData(meta);
+        }
 
         // Call the actual PDU making function
         if (!isLteRlcPduNewData)
@@ -720,6 +770,8 @@ namespace simu5g
 
             // TODO: upPkt->info()
             EV << "LteMacBase: PDU Unmaker extracted SDU" << endl;
+            auto sduInfo = check_and_cast<Packet *>(upPkt)->findTag<FlowControlInfo>();
+            enbSchedulerUl_->signalUplinkData(userInfo->getSourceId(), (sduInfo != nullptr) ? sduInfo->getFiveQI() : 0);
             sendUpperPackets(upPkt);
         }
 
@@ -925,19 +977,19 @@ namespace simu5g
 
         if (activation)
         {
-            // clear previous schedule list
-            if (scheduleListDl_ != nullptr)
+            if (binder_->getCellSchedulingPool() != nullptr)
             {
-                for (auto &cit : *scheduleListDl_)
-                    cit.second.clear();
-                scheduleListDl_->clear();
+                // scheduled with the other cells whose slot starts now, see CellSchedulingPool
+                enbSchedulerDl_->dropExpiredPdus();
+                binder_->queueDownlinkScheduling(this);
             }
+            else
+            {
+                scheduleDownlink();
 
-            // perform Downlink scheduling
-            scheduleListDl_ = enbSchedulerDl_->schedule();
-
-            // requests SDUs to the RLC layer
-            macSduRequest();
+                // requests SDUs to the RLC layer
+                macSduRequest();
+            }
         }
         EV << "========================================== END DOWNLINK ============================================" << endl;
 
@@ -959,9 +1011,87 @@ namespace simu5g
 
         decreaseNumerologyPeriodCounter();
 
+        slotStart_ = NOW;
+        if (miniSlotTick_ != nullptr)
+        {
+            cancelEvent(miniSlotTick_);
+            scheduleAt(NOW + miniSlotDuration_, miniSlotTick_);
+        }
+
         EV << "--- END ENB MAIN LOOP ---" << endl;
     }
 
+    void LteMacEnb::scheduleDownlink()
+    {
+        // clear previous schedule list
+        if (scheduleListDl_ != nullptr)
+        {
+            for (auto &cit : *scheduleListDl_)
+                cit.second.clear();
+            scheduleListDl_->clear();
+        }
+
+        // perform Downlink scheduling
+        scheduleListDl_ = enbSchedulerDl_->schedule();
+    }
+
+    void LteMacEnb::endDownlinkScheduling()
+    {
+        Enter_Method_Silent("endDownlinkScheduling");
+
+        enbSchedulerDl_->emitDeferredSignals();
+
+        // requests SDUs to the RLC layer
+        macSduRequest();
+    }
+
+    void LteMacEnb::handleMiniSlot()
+    {
+        EV << NOW << " LteMacEnb::handleMiniSlot" << endl;
+
+        if (enbSchedulerDl_->hasMiniSlotTraffic())
+        {
+            // the scheduler reads the slot grants from the list before replacing them with the mini-slot ones
+            scheduleListDl_ = enbSchedulerDl_->scheduleMiniSlot(miniSlotSymbols_);
+            enbSchedulerDl_->emitDeferredSignals();
+            macSduRequest();
+
+            cMessage *flushHarqMsg = new cMessage("flushHarqMsg");
+            flushHarqMsg->setSchedulingPriority(1); // after other messages
+            scheduleAt(NOW, flushHarqMsg);
+        }
+
+        // next mini-slot, as long as it ends within the slot
+        if (NOW + 2 * miniSlotDuration_ <= slotStart_ + ttiPeriod_)
+            scheduleAt(NOW + miniSlotDuration_, miniSlotTick_);
+    }
+
+    unsigned int LteMacEnb::punctureTransmission(MacNodeId nodeId, double carrierFrequency)
+    {
+        auto mit = harqTxBuffers_.find(carrierFrequency);
+        if (mit == harqTxBuffers_.end())
+            return 0;
+        auto hit = mit->second.find(nodeId);
+        if (hit == mit->second.end())
+            return 0;
+
+        unsigned int punctured = 0;
+        LteHarqBufferTx *buffer = hit->second;
+        for (unsigned int acid = 0; acid < buffer->getNumProcesses(); acid++)
+        {
+            LteHarqProcessTx *process = buffer->getProcess(acid);
+            for (Codeword cw = 0; cw < process->getNumHarqUnits(); cw++)
+            {
+                if (process->getUnitStatus(cw) == TXHARQ_PDU_WAITING && process->getTxTime(cw) == slotStart_)
+                {
+                    process->markPunctured(cw);
+                    punctured++;
+                }
+            }
+        }
+        return punctured;
+    }
+
     void LteMacEnb::signalProcessForRtx(MacNodeId nodeId, double carrierFrequency, Direction dir, bool rtx)
     {
         std::map<double, int> *needRtx = (dir == DL) ? &needRtxDl_ : (dir == UL) ? &needRtxUl_
@@ -1061,11 +1191,6 @@ namespace simu5g
         lteInfo->setTotalGrantedBlocks(grantedBlocks);
     }
 
-    // MacPduMetaDataList LteMacEnb::readMacPduMetaDataList() const{
-
-    // }
-    // return enbSchedulerUl_->readMacPduMetaDataList();
-
     ActiveSet *LteMacEnb::getActiveSet(Direction dir)
     {
         if (dir == DL)
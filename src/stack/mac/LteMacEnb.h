@@ -27,11 +27,13 @@ namespace simu5g
     using namespace omnetpp;
 
     class MacBsr;
+    class MacPduMetaDataStore;
     class LteAmc;
     class LteSchedulerEnbDl;
     class LteSchedulerEnbUl;
     class ConflictGraph;
     class LteHarqProcessRx;
+    class LteRlcUm;
 
     class LteMacEnb : public LteMacBase
     {
@@ -69,6 +71,20 @@ namespace simu5g
         std::map<double, int> needRtxUl_;
         std::map<double, int> needRtxD2D_;
 
+        /// Mini-slot tick, for DC-GBR transmissions within the slot (nullptr if mini-slots are disabled)
+        cMessage *miniSlotTick_ = nullptr;
+
+        /// OFDM symbols of a mini-slot
+        unsigned int miniSlotSymbols_ = 0;
+
+        simtime_t miniSlotDuration_;
+
+        /// Start time of the current slot
+        simtime_t slotStart_;
+
+        /// RLC UM of the node, where expired SDUs are discarded (nullptr if none)
+        LteRlcUm *rlcUm_ = nullptr;
+
         /**
          * Reads MAC parameters for eNb and performs initialization.
          */
@@ -144,6 +160,13 @@ namespace simu5g
          * Main loop.
          */
         void handleSelfMessage() override;
+
+        /**
+         * Schedules the DC-GBR data arrived since the slot started in a mini-slot,
+         * then sets up the next mini-slot tick within the slot.
+         */
+        virtual void handleMiniSlot();
+
         /**
          * macHandleFeedbackPkt is called every time a feedback packet arrives on MAC.
          */
@@ -168,8 +191,38 @@ namespace simu5g
         LteMacEnb();
         ~LteMacEnb() override;
 
-        MacPduMetaDataList *getMacPduMetaDataList() const;
-        void insertMacPduMetaData(MacPduMetaData meta);
+        MacPduMetaDataStore *getMacPduMetaDataStore() const;
+        void insertMacPduMetaData(const MacPduMetaData &meta);
+
+        /**
+         * Discards the head-of-line SDU of the given connection, both from
+         * the RLC buffer and from the virtual buffer. The SDU is kept if its
+         * transmission has already started.
+         *
+         * @param cid connection identifier
+         * @return the size in bytes of the discarded SDU, 0 if none was discarded
+         */
+        unsigned int discardHolSdu(MacCid cid);
+
+        /**
+         * Marks the transmissions sent to the given UE at the start of the current slot
+         * as punctured by a mini-slot, so that they are retransmitted.
+         *
+         * @return the number of punctured codewords
+         */
+        unsigned int punctureTransmission(MacNodeId nodeId, double carrierFrequency);
+
+        /**
+         * Runs the downlink scheduler for the current slot. In parallel mode, this is
+         * called by a thread of CellSchedulingPool and must only touch this cell.
+         */
+        void scheduleDownlink();
+
+        /**
+         * Completes a parallel downlink scheduling: emits its statistics and requests
+         * the scheduled SDUs to the RLC.
+         */
+        void endDownlinkScheduling();
 
         /// Returns the BSR virtual buffers.
         LteMacBufferMap *getBsrVirtualBuffers()
@@ -219,6 +272,13 @@ namespace simu5g
          */
         SchedDiscipline getSchedDiscipline(Direction dir);
 
+        /**
+         * Returns the name of the scheduling discipline for the given direction, as configured.
+         * Disciplines registered in LteSchedulerFactory are UNKNOWN_DISCIPLINE for getSchedDiscipline().
+         * @param dir link direction.
+         */
+        std::string getSchedDisciplineName(Direction dir);
+
         /*
          * Return the current active set (active connections).
          * @param direction
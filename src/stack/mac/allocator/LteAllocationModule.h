@@ -186,22 +186,22 @@ class LteAllocationModule
     virtual ~LteAllocationModule() {}
 
     // init Allocation Module structure
-    void init(const unsigned int resourceBlocks, const unsigned int bands);
+    virtual void init(const unsigned int resourceBlocks, const unsigned int bands);
 
     // reset Allocation Module structure
-    void reset(const unsigned int resourceBlocks, const unsigned int bands);
+    virtual void reset(const unsigned int resourceBlocks, const unsigned int bands);
 
     // ********* MU-MIMO Support *********
     // Configure MuMimo between "nodeId" and "peer"
-    bool configureMuMimoPeering(const MacNodeId nodeId, const MacNodeId peer);
+    virtual bool configureMuMimoPeering(const MacNodeId nodeId, const MacNodeId peer);
 
     // MU-MIMO configuration functions
-    void configureOFDMplane(const Plane plane);
-    void setRemoteAntenna(const Plane plane, const Remote antenna);
-    Plane getOFDMPlane(const MacNodeId nodeId);
+    virtual void configureOFDMplane(const Plane plane);
+    virtual void setRemoteAntenna(const Plane plane, const Remote antenna);
+    virtual Plane getOFDMPlane(const MacNodeId nodeId);
 
     // returns the Mu-MIMO peer id if it exists, own id otherwise
-    MacNodeId getMuMimoPeer(const MacNodeId nodeId) const;
+    virtual MacNodeId getMuMimoPeer(const MacNodeId nodeId) const;
     // **********************************
 
     // ************** Resource Blocks Allocation Status **************
@@ -209,22 +209,22 @@ class LteAllocationModule
     unsigned int computeTotalRbs();
 
     // returns the amount of free blocks for the given band in the given plane
-    unsigned int availableBlocks(const MacNodeId nodeId, const Plane plane, const Band band);
+    virtual unsigned int availableBlocks(const MacNodeId nodeId, const Plane plane, const Band band);
 
     // returns the amount of free blocks for the given band and for the given antenna
-    unsigned int availableBlocks(const MacNodeId nodeId, const Remote antenna, const Band band);
+    virtual unsigned int availableBlocks(const MacNodeId nodeId, const Remote antenna, const Band band);
     // ***************************************************************
 
     // ************** Resource Blocks Allocation Methods **************
     // tries to satisfy the resource block request in the given band and for the given antenna
-    bool addBlocks(const Remote antenna, const Band band, const MacNodeId nodeId, const unsigned int blocks,
+    virtual bool addBlocks(const Remote antenna, const Band band, const MacNodeId nodeId, const unsigned int blocks,
             const unsigned int bytes);
 
     // tries to satisfy the resource block request in the first available antenna
-    bool addBlocks(const Band band, const MacNodeId nodeId, const unsigned int blocks, const unsigned int bytes);
+    virtual bool addBlocks(const Band band, const MacNodeId nodeId, const unsigned int blocks, const unsigned int bytes);
 
     // remove resource Blocks previously allocated in a band by a UE
-    unsigned int removeBlocks(const Remote antenna, const Band band, const MacNodeId nodeId);
+    virtual unsigned int removeBlocks(const Remote antenna, const Band band, const MacNodeId nodeId);
     // ****************************************************************
 
     // --- Get (Parameters) --------------------------------------------------------------------
@@ -238,7 +238,7 @@ class LteAllocationModule
      * @param nodeId the node id of the user
      * @return amount of blocks allocated
      */
-    unsigned int getBlocks(const Remote antenna, const Band band, const MacNodeId nodeId)
+    virtual unsigned int getBlocks(const Remote antenna, const Band band, const MacNodeId nodeId)
     {
         Plane plane = allocatedRbsUe_[nodeId].secondaryUser_ ? MU_MIMO_PLANE : MAIN_PLANE;
         return allocatedRbsPerBand_[plane][antenna][band].ueAllocatedRbsMap_[nodeId];
@@ -247,17 +247,17 @@ class LteAllocationModule
     /*
      * Returns the amount of blocks allocated in a Band
      */
-    unsigned int getAllocatedBlocks(Plane plane, const Remote antenna, const Band band);
-    unsigned int getInterferingBlocks(Plane plane, const Remote antenna, const Band band);
+    virtual unsigned int getAllocatedBlocks(Plane plane, const Remote antenna, const Band band);
+    virtual unsigned int getInterferingBlocks(Plane plane, const Remote antenna, const Band band);
 
-    unsigned int getBytes(const Remote antenna, const Band band, const MacNodeId nodeId)
+    virtual unsigned int getBytes(const Remote antenna, const Band band, const MacNodeId nodeId)
     {
         Plane plane = allocatedRbsUe_[nodeId].secondaryUser_ ? MU_MIMO_PLANE : MAIN_PLANE;
         return allocatedRbsPerBand_[plane][antenna][band].ueAllocatedBytesMap_[nodeId];
     }
 
     // computes the amount of blocks allocated by the given UE
-    unsigned int getBlocks(const MacNodeId nodeId)
+    virtual unsigned int getBlocks(const MacNodeId nodeId)
     {
         return allocatedRbsUe_[nodeId].allocatedBlocks_;
     }
@@ -268,7 +268,7 @@ class LteAllocationModule
         return allocatedRbsMatrix_[plane][antenna];
     }
 
-    unsigned int rbOccupation(const MacNodeId nodeId, RbMap& rbMap);
+    virtual unsigned int rbOccupation(const MacNodeId nodeId, RbMap& rbMap);
 
     // --------- Map Iteration Methods --------->
     AllocatedRbsPerUeMap::const_iterator getAllocatedBlocksUeBegin()
@@ -0,0 +1,426 @@
+//
+//                  Simu5G-NR-EDF (Extension of Simu5G)
+//
+// Original Authors: Giovanni Nardini, Giovanni Stea, Antonio Virdis (University of Pisa)
+// Extension Authors: Alaf Nascimento, Philippe Martins, Samuel Tardieu, Laurent Pautet (Institut Polytechnique de Paris)
+//
+// This file is part of a software released under the license included in file
+// "license.pdf". Please read LICENSE and README files before using it.
+// The above files and the present reference are part of the software itself,
+// and cannot be removed from it.
+//
+
+#include "stack/mac/allocator/LteAllocationModuleBitset.h"
+#include "stack/mac/LteMacEnb.h"
+
+namespace simu5g {
+
+using namespace omnetpp;
+
+LteAllocationModuleBitset::LteAllocationModuleBitset(LteMacEnb *mac, Direction direction) : LteAllocationModule(mac, direction)
+{
+}
+
+void LteAllocationModuleBitset::addSpace(std::vector<std::vector<BandSpace>>& spaces, const Plane plane, const Remote antenna)
+{
+    if (spaces.size() < (unsigned int)(plane + 1))
+        spaces.resize(plane + 1);
+    if (spaces[plane].size() < (unsigned int)(antenna + 1))
+        spaces[plane].resize(antenna + 1);
+
+    // size the newly created spaces
+    for (auto& space : spaces[plane]) {
+        if (space.used_.size() != words_) {
+            space.used_.assign(words_, 0);
+            space.owner_.resize(bands_, NODEID_NONE);
+            space.blocks_.resize(bands_, 0);
+            space.bytes_.resize(bands_, 0);
+        }
+    }
+}
+
+LteAllocationModuleBitset::UeState& LteAllocationModuleBitset::ueState(const MacNodeId nodeId)
+{
+    unsigned short id = num(nodeId);
+    if (id >= ueIndex_.size())
+        ueIndex_.resize(id + 1, 0);
+    if (ueIndex_[id] == 0) {
+        ues_.emplace_back();
+        ueIndex_[id] = ues_.size();
+    }
+
+    UeState& ue = ues_[ueIndex_[id] - 1];
+    // the state was left by a previous slot
+    if (ue.slot_ != slot_) {
+        ue = UeState();
+        ue.slot_ = slot_;
+    }
+    return ue;
+}
+
+const LteAllocationModuleBitset::UeState *LteAllocationModuleBitset::findUeState(const MacNodeId nodeId) const
+{
+    unsigned short id = num(nodeId);
+    if (id >= ueIndex_.size() || ueIndex_[id] == 0)
+        return nullptr;
+    const UeState& ue = ues_[ueIndex_[id] - 1];
+    return (ue.slot_ == slot_) ? &ue : nullptr;
+}
+
+unsigned int LteAllocationModuleBitset::bandBlocks(const BandSpace *space, const Band band, const MacNodeId nodeId)
+{
+    if (space == nullptr || band >= space->owner_.size() || !space->isUsed(band))
+        return 0;
+    if (nodeId != NODEID_NONE && space->owner_[band] != nodeId)
+        return 0;
+    return space->blocks_[band];
+}
+
+void LteAllocationModuleBitset::init(const unsigned int resourceBlocks, const unsigned int bands)
+{
+    // initialize the blocks counters of the main OFDMA space
+    LteAllocationModule::init(resourceBlocks, bands);
+
+    words_ = (bands_ + WORD_BITS - 1) / WORD_BITS;
+
+    spaces_.clear();
+    addSpace(spaces_, MAIN_PLANE, MACRO);
+    prevSpaces_.clear();
+    hasPrevSpaces_ = false;
+
+    // drop the UE states
+    ++slot_;
+}
+
+void LteAllocationModuleBitset::reset(const unsigned int resourceBlocks, const unsigned int bands)
+{
+    // keep the allocation of the last slot for the interference computation, and reuse the storage
+    // of the slot before it for the new one
+    prevSpaces_.swap(spaces_);
+    hasPrevSpaces_ = true;
+    for (unsigned int plane = 0; plane < prevSpaces_.size(); ++plane) {
+        for (unsigned int antenna = 0; antenna < prevSpaces_[plane].size(); ++antenna)
+            addSpace(spaces_, Plane(plane), Remote(antenna));
+    }
+
+    // free all the bands
+    for (auto& plane : spaces_) {
+        for (auto& space : plane)
+            std::fill(space.used_.begin(), space.used_.end(), 0);
+    }
+
+    if (usedInLastSlot_) {
+        for (auto& plane : totalRbsMatrix_) {
+            for (auto& antenna : plane)
+                antenna = resourceBlocks;
+        }
+        for (auto& plane : allocatedRbsMatrix_) {
+            for (auto& antenna : plane)
+                antenna = 0;
+        }
+    }
+
+    // drop the UE states
+    ++slot_;
+
+    usedInLastSlot_ = false;
+}
+
+void LteAllocationModuleBitset::configureOFDMplane(const Plane plane)
+{
+    // check if an OFDMA space exists with the given plane ID
+    if (totalRbsMatrix_.size() < (unsigned int)(plane + 1)) {
+        totalRbsMatrix_.resize(plane + 1);
+        totalRbsMatrix_.at(plane).resize(MACRO + 1);
+        allocatedRbsMatrix_.resize(plane + 1);
+        allocatedRbsMatrix_.at(plane).resize(MACRO + 1);
+        addSpace(spaces_, plane, MACRO);
+
+        // we set the newly created OFDMA space equal to its peer space
+        totalRbsMatrix_[plane][MACRO] = totalRbsMatrix_[MAIN_PLANE][MACRO];
+
+        usedInLastSlot_ = true;
+    }
+}
+
+void LteAllocationModuleBitset::setRemoteAntenna(const Plane plane, const Remote antenna)
+{
+    // create all antennas between the last one and the given one
+    for (int i = totalRbsMatrix_.at(plane).size(); i < antenna + 1; ++i) {
+        totalRbsMatrix_.at(plane).resize(i + 1);
+        allocatedRbsMatrix_.at(plane).resize(i + 1);
+        addSpace(spaces_, plane, Remote(i));
+        // initialize new antenna space with macro space
+        totalRbsMatrix_[plane][i] = totalRbsMatrix_[plane][MACRO];
+
+        usedInLastSlot_ = true;
+    }
+}
+
+bool LteAllocationModuleBitset::configureMuMimoPeering(const MacNodeId nodeId, const MacNodeId peer)
+{
+    // create both states first, so that the references below are not invalidated
+    ueState(nodeId);
+    ueState(peer);
+    UeState& nodeState = ueState(nodeId);
+    UeState& peerState = ueState(peer);
+
+    // peer user already set for the specified nodeId or for the specified peer
+    if (nodeState.muMimoEnabled_ || peerState.muMimoEnabled_)
+        return false;
+
+    nodeState.muMimoEnabled_ = true;
+    peerState.muMimoEnabled_ = true;
+    nodeState.peerId_ = peer;
+    peerState.peerId_ = nodeId;
+    nodeState.secondaryUser_ = false; // primary MU-MIMO user
+    peerState.secondaryUser_ = true;  // secondary MU-MIMO user
+
+    // set the peer's antennas to the main user's ones.
+    peerState.antennas_ = nodeState.antennas_;
+    unsigned char antennas = nodeState.antennas_;
+
+    // check if the mirror MIMO plane has to be created.
+    configureOFDMplane(MU_MIMO_PLANE);
+
+    // for each antenna of the main user, create a mirror MU-MIMO antenna space for the peer user
+    for (int r = 0; r <= UNKNOWN_RU; ++r) {
+        if (antennas & (1 << r))
+            setRemoteAntenna(MU_MIMO_PLANE, Remote(r));
+    }
+
+    usedInLastSlot_ = true;
+
+    return true;
+}
+
+Plane LteAllocationModuleBitset::getOFDMPlane(const MacNodeId nodeId)
+{
+    const UeState *ue = findUeState(nodeId);
+    return (ue != nullptr && ue->secondaryUser_) ? MU_MIMO_PLANE : MAIN_PLANE;
+}
+
+MacNodeId LteAllocationModuleBitset::getMuMimoPeer(const MacNodeId nodeId) const
+{
+    const UeState *ue = findUeState(nodeId);
+    return (ue != nullptr && ue->muMimoEnabled_) ? ue->peerId_ : nodeId;
+}
+
+unsigned int LteAllocationModuleBitset::availableBlocks(const MacNodeId nodeId, const Remote antenna, const Band band)
+{
+    const BandSpace *space = findSpace(getOFDMPlane(nodeId), antenna);
+    if (space == nullptr || band >= bands_ || space->isUsed(band))
+        return 0;
+    return 1;
+}
+
+unsigned int LteAllocationModuleBitset::availableBlocks(const MacNodeId nodeId, const Plane plane, const Band band)
+{
+    // compute available blocks on all antennas for the given user and plane.
+    const UeState *ue = findUeState(nodeId);
+    unsigned char antennas = (ue != nullptr) ? ue->antennas_ : (1 << MACRO);
+    unsigned int available = 0;
+    for (int r = 0; r <= UNKNOWN_RU; ++r) {
+        if (antennas & (1 << r))
+            available += availableBlocks(nodeId, Remote(r), band);
+    }
+    return available;
+}
+
+bool LteAllocationModuleBitset::addBlocks(const Band band, const MacNodeId nodeId, const unsigned int blocks,
+        const unsigned int bytes)
+{
+    const UeState *ue = findUeState(nodeId);
+    unsigned char antennas = (ue != nullptr) ? ue->antennas_ : (1 << MACRO);
+    for (int r = 0; r <= UNKNOWN_RU; ++r) {
+        if ((antennas & (1 << r)) && addBlocks(Remote(r), band, nodeId, blocks, bytes))
+            return true;
+    }
+    return false;
+}
+
+bool LteAllocationModuleBitset::addBlocks(const Remote antenna, const Band band, const MacNodeId nodeId,
+        const unsigned int blocks, const unsigned int bytes)
+{
+    // Check if the band exists
+    if (band >= bands_)
+        throw cRuntimeError("LteAllocator::addBlocks(): Invalid band %d", (int)band);
+
+    Plane plane = getOFDMPlane(nodeId);
+
+    // Check if the band can satisfy the request
+    if (availableBlocks(nodeId, antenna, band) == 0) {
+        EV << NOW << " LteAllocator::addBlocks " << dirToA(dir_) << " - Node " << nodeId <<
+            ", not enough space on band " << band << ": requested " << blocks << endl;
+        return false;
+    }
+    // check if UE is out of range. (CQI=0 => bytes=0)
+    if (bytes == 0) {
+        EV << NOW << " LteAllocator::addBlocks " << dirToA(dir_) << " - Node " << nodeId << " - 0 bytes available with " << blocks << " blocks" << endl;
+        return false;
+    }
+
+    // Note the request on the band
+    BandSpace& space = spaces_[plane][antenna];
+    space.used_[band / WORD_BITS] |= Word(1) << (band % WORD_BITS);
+    space.owner_[band] = nodeId;
+    space.blocks_[band] = blocks;
+    space.bytes_[band] = bytes;
+
+    UeState& ue = ueState(nodeId);
+    ue.allocatedBlocks_ += blocks;
+    ue.allocatedBytes_ += bytes;
+
+    // update the allocatedBlocks counter
+    allocatedRbsMatrix_[plane][antenna] += blocks;
+
+    usedInLastSlot_ = true;
+
+    EV << NOW << " LteAllocator::addBlocks " << dirToA(dir_) << " - Node " << nodeId << ", the request of " << blocks << " blocks on band " << band << " satisfied" << endl;
+
+    return true;
+}
+
+unsigned int LteAllocationModuleBitset::removeBlocks(const Remote antenna, const Band band, const MacNodeId nodeId)
+{
+    // Check if the band exists
+    if (band >= bands_) {
+        EV << NOW << " LteAllocator::removeBlocks " << dirToA(dir_) << " - Node " << nodeId << ", invalid band " << band << endl;
+        return 0;
+    }
+
+    Plane plane = getOFDMPlane(nodeId);
+    const BandSpace *space = findSpace(plane, antenna);
+    unsigned int toDrain = bandBlocks(space, band, nodeId);
+
+    // If the number of blocks allocated by the nodeId in the band is zero, do nothing!
+    if (toDrain == 0)
+        return toDrain;
+
+    // free the band
+    spaces_[plane][antenna].used_[band / WORD_BITS] &= ~(Word(1) << (band % WORD_BITS));
+
+    UeState& ue = ueState(nodeId);
+    ue.allocatedBlocks_ -= toDrain;
+    ue.allocatedBytes_ = 0;
+
+    // Update the allocatedBlocks counter
+    allocatedRbsMatrix_[plane][antenna] -= toDrain;
+
+    usedInLastSlot_ = true;
+
+    EV << NOW << " LteAllocator::removeBlocks " << dirToA(dir_) << " - Node " << nodeId << ", " << toDrain << " blocks drained from band " << band << endl;
+
+    return toDrain;
+}
+
+unsigned int LteAllocationModuleBitset::getBlocks(const Remote antenna, const Band band, const MacNodeId nodeId)
+{
+    return bandBlocks(findSpace(getOFDMPlane(nodeId), antenna), band, nodeId);
+}
+
+unsigned int LteAllocationModuleBitset::getAllocatedBlocks(Plane plane, const Remote antenna, const Band band)
+{
+    return bandBlocks(findSpace(plane, antenna), band, NODEID_NONE);
+}
+
+unsigned int LteAllocationModuleBitset::getInterferingBlocks(Plane plane, const Remote antenna, const Band band)
+{
+    if (!hasPrevSpaces_)
+        return 1000;
+    if (plane >= prevSpaces_.size() || antenna >= prevSpaces_[plane].size())
+        return 0;
+    return bandBlocks(&prevSpaces_[plane][antenna], band, NODEID_NONE);
+}
+
+unsigned int LteAllocationModuleBitset::getBytes(const Remote antenna, const Band band, const MacNodeId nodeId)
+{
+    const BandSpace *space = findSpace(getOFDMPlane(nodeId), antenna);
+    if (bandBlocks(space, band, nodeId) == 0)
+        return 0;
+    return space->bytes_[band];
+}
+
+unsigned int LteAllocationModuleBitset::getBlocks(const MacNodeId nodeId)
+{
+    const UeState *ue = findUeState(nodeId);
+    return (ue != nullptr) ? ue->allocatedBlocks_ : 0;
+}
+
+unsigned int LteAllocationModuleBitset::rbOccupation(const MacNodeId nodeId, RbMap& rbMap)
+{
+    // Compute allocated blocks on all antennas for the given user and logical band.
+    const UeState *ue = findUeState(nodeId);
+    unsigned char antennas = (ue != nullptr) ? ue->antennas_ : (1 << MACRO);
+
+    unsigned int blocks = 0;
+    for (int r = 0; r <= UNKNOWN_RU; ++r) {
+        if (!(antennas & (1 << r)))
+            continue;
+        Remote antenna = Remote(r);
+        for (Band b = 0; b < bands_; ++b)
+            blocks += (rbMap[antenna][b] = getBlocks(antenna, b, nodeId));
+    }
+    return blocks;
+}
+
+unsigned int LteAllocationModuleBitset::freeBands(const Plane plane, const Remote antenna) const
+{
+    const BandSpace *space = findSpace(plane, antenna);
+    if (space == nullptr)
+        return 0;
+
+    unsigned int used = 0;
+    for (Word word : space->used_)
+        used += __builtin_popcountll(word);
+    return bands_ - used;
+}
+
+bool LteAllocationModuleBitset::findFreeRun(const Plane plane, const Remote antenna, const unsigned int length, Band& first) const
+{
+    const BandSpace *space = findSpace(plane, antenna);
+    if (space == nullptr || length == 0)
+        return false;
+
+    // length of the run of free bands ending at the current position, and its first band
+    unsigned int run = 0;
+    unsigned int start = 0;
+    for (unsigned int i = 0; i < words_; ++i) {
+        unsigned int base = i * WORD_BITS;
+        unsigned int valid = std::min(WORD_BITS, bands_ - base);
+        Word freeBits = ~space->used_[i];
+        if (valid < WORD_BITS)
+            freeBits &= (Word(1) << valid) - 1;
+
+        unsigned int pos = 0;
+        while (pos < valid) {
+            Word rest = freeBits >> pos;
+            if (rest == 0) {
+                // no free band left in this word
+                run = 0;
+                break;
+            }
+            if ((rest & 1) == 0) {
+                // skip the allocated bands
+                run = 0;
+                pos += __builtin_ctzll(rest);
+                continue;
+            }
+            // count the free bands from pos
+            Word allocated = ~rest;
+            unsigned int len = (allocated == 0) ? WORD_BITS : __builtin_ctzll(allocated);
+            len = std::min(len, valid - pos);
+            if (run == 0)
+                start = base + pos;
+            run += len;
+            if (run >= length) {
+                first = Band(start);
+                return true;
+            }
+            pos += len;
+        }
+    }
+    return false;
+}
+
+} //namespace
@@ -0,0 +1,155 @@
+//
+//                  Simu5G-NR-EDF (Extension of Simu5G)
+//
+// Original Authors: Giovanni Nardini, Giovanni Stea, Antonio Virdis (University of Pisa)
+// Extension Authors: Alaf Nascimento, Philippe Martins, Samuel Tardieu, Laurent Pautet (Institut Polytechnique de Paris)
+//
+// This file is part of a software released under the license included in file
+// "license.pdf". Please read LICENSE and README files before using it.
+// The above files and the present reference are part of the software itself,
+// and cannot be removed from it.
+//
+
+#ifndef _LTE_LTEALLOCATIONMODULEBITSET_H_
+#define _LTE_LTEALLOCATIONMODULEBITSET_H_
+
+#include <algorithm>
+#include <cstdint>
+
+#include "common/LteCommon.h"
+#include "stack/mac/allocator/LteAllocationModule.h"
+
+namespace simu5g {
+
+/**
+ * Allocation module keeping the band occupation in bitsets.
+ *
+ * A band holds the blocks of a single UE per plane and antenna (see LteAllocationModule::availableBlocks()),
+ * so each plane/antenna space is a bitset of the allocated bands plus flat per-band arrays with the owner,
+ * blocks and bytes of the allocation, valid only where the bit is set. The per-UE state lives in a flat
+ * array stamped with the slot it belongs to. Resetting the allocator at each slot thus only clears the
+ * bitset words, whatever the number of bands and UEs, which matters for carriers with hundreds of bands.
+ *
+ * The per-UE and per-band maps of LteAllocationModule are left empty: the allocation lists returned by
+ * getAllocatedBlocksUeAllocationListBegin()/End() are not available with this module, nor is the
+ * frequency reuse support of LteAllocationModuleFrequencyReuse.
+ */
+class LteAllocationModuleBitset : public LteAllocationModule
+{
+  protected:
+
+    typedef uint64_t Word;
+    static constexpr unsigned int WORD_BITS = 64;
+
+    /// Allocation state of the bands of one antenna in one plane
+    struct BandSpace
+    {
+        /// bit b is set if band b is allocated
+        std::vector<Word> used_;
+        /// allocation of each band, valid only if its bit is set
+        std::vector<MacNodeId> owner_;
+        std::vector<unsigned int> blocks_;
+        std::vector<unsigned int> bytes_;
+
+        bool isUsed(Band b) const { return (used_[b / WORD_BITS] >> (b % WORD_BITS)) & 1; }
+    };
+
+    /// Allocation state of a UE in the current slot
+    struct UeState
+    {
+        /// slot the state refers to, the state is stale if it differs from the current one
+        unsigned int slot_ = 0;
+        unsigned int allocatedBlocks_ = 0;
+        unsigned int allocatedBytes_ = 0;
+        bool muMimoEnabled_ = false;
+        bool secondaryUser_ = false;
+        MacNodeId peerId_ = NODEID_NONE;
+        /// bit r is set if remote antenna r is available for this UE
+        unsigned char antennas_ = 1 << MACRO;
+    };
+
+    /// number of words of the bitsets
+    unsigned int words_ = 0;
+
+    /// e.g. spaces_[ <plane> ] [ <antenna> ]
+    std::vector<std::vector<BandSpace>> spaces_;
+
+    /// Spaces of the previous slot, used for the interference computation
+    std::vector<std::vector<BandSpace>> prevSpaces_;
+    bool hasPrevSpaces_ = false;
+
+    /// Index in ues_ (plus one) of each UE, by MacNodeId, 0 if the UE has no state
+    std::vector<unsigned short> ueIndex_;
+    std::vector<UeState> ues_;
+
+    /// current slot, UE states of other slots are reset when accessed
+    unsigned int slot_ = 1;
+
+    /// Creates the space of the given plane and antenna, if needed
+    void addSpace(std::vector<std::vector<BandSpace>>& spaces, const Plane plane, const Remote antenna);
+
+    /// Returns the space of the given plane and antenna, nullptr if it does not exist
+    const BandSpace *findSpace(const Plane plane, const Remote antenna) const
+    {
+        if (plane >= spaces_.size() || antenna >= spaces_[plane].size())
+            return nullptr;
+        return &spaces_[plane][antenna];
+    }
+
+    /// Returns the state of the UE in the current slot, creating it if needed
+    UeState& ueState(const MacNodeId nodeId);
+
+    /// Returns the state of the UE in the current slot, nullptr if it has none
+    const UeState *findUeState(const MacNodeId nodeId) const;
+
+    /// Returns the blocks allocated to the UE (or to any UE if nodeId is NODEID_NONE) in the band of the space
+    static unsigned int bandBlocks(const BandSpace *space, const Band band, const MacNodeId nodeId);
+
+  public:
+
+    LteAllocationModuleBitset(LteMacEnb *mac, const Direction direction);
+
+    void init(const unsigned int resourceBlocks, const unsigned int bands) override;
+    void reset(const unsigned int resourceBlocks, const unsigned int bands) override;
+
+    bool configureMuMimoPeering(const MacNodeId nodeId, const MacNodeId peer) override;
+    void configureOFDMplane(const Plane plane) override;
+    void setRemoteAntenna(const Plane plane, const Remote antenna) override;
+    Plane getOFDMPlane(const MacNodeId nodeId) override;
+    MacNodeId getMuMimoPeer(const MacNodeId nodeId) const override;
+
+    unsigned int availableBlocks(const MacNodeId nodeId, const Plane plane, const Band band) override;
+    unsigned int availableBlocks(const MacNodeId nodeId, const Remote antenna, const Band band) override;
+
+    bool addBlocks(const Remote antenna, const Band band, const MacNodeId nodeId, const unsigned int blocks,
+            const unsigned int bytes) override;
+    bool addBlocks(const Band band, const MacNodeId nodeId, const unsigned int blocks, const unsigned int bytes) override;
+    unsigned int removeBlocks(const Remote antenna, const Band band, const MacNodeId nodeId) override;
+
+    unsigned int getBlocks(const Remote antenna, const Band band, const MacNodeId nodeId) override;
+    unsigned int getAllocatedBlocks(Plane plane, const Remote antenna, const Band band) override;
+    unsigned int getInterferingBlocks(Plane plane, const Remote antenna, const Band band) override;
+    unsigned int getBytes(const Remote antenna, const Band band, const MacNodeId nodeId) override;
+    unsigned int getBlocks(const MacNodeId nodeId) override;
+    unsigned int rbOccupation(const MacNodeId nodeId, RbMap& rbMap) override;
+
+    /**
+     * Returns the number of free bands of the given plane and antenna.
+     */
+    unsigned int freeBands(const Plane plane, const Remote antenna) const;
+
+    /**
+     * Searches the first run of contiguous free bands of the given length (type-1 allocation).
+     *
+     * @param plane OFDMA plane
+     * @param antenna remote antenna
+     * @param length number of contiguous bands requested
+     * @param first set to the first band of the run, if found
+     * @return true if such a run exists
+     */
+    bool findFreeRun(const Plane plane, const Remote antenna, const unsigned int length, Band& first) const;
+};
+
+} //namespace
+
+#endif
@@ -0,0 +1,79 @@
+//
+//                  Simu5G-NR-EDF (Extension of Simu5G)
+//
+// Original Authors: Giovanni Nardini, Giovanni Stea, Antonio Virdis (University of Pisa)
+// Extension Authors: Alaf Nascimento, Philippe Martins, Samuel Tardieu, Laurent Pautet (Institut Polytechnique de Paris)
+//
+// This file is part of a software released under the license included in file
+// "license.pdf". Please read LICENSE and README files before using it.
+// The above files and the present reference are part of the software itself,
+// and cannot be removed from it.
+//
+
+#ifndef _LTE_FEEDBACKHISTORY_H_
+#define _LTE_FEEDBACKHISTORY_H_
+
+#include <algorithm>
+#include <vector>
+
+#include "common/LteCommon.h"
+#include "stack/phy/feedback/LteSummaryBuffer.h"
+
+namespace simu5g {
+
+using namespace omnetpp;
+
+/**
+ * Feedback Historical Base of one carrier: a summary buffer per antenna, UE and transmission mode.
+ *
+ * The buffers of an antenna are stored contiguously, UE by UE, at [ueIndex * numTxModes + txMode].
+ * Antennas without buffers are the ones not in the remote set of the history.
+ */
+class FeedbackHistory
+{
+    unsigned int numTxModes_ = 0;
+    std::vector<LteSummaryBuffer> buffers_[UNKNOWN_RU + 1];
+
+  public:
+    FeedbackHistory() {}
+
+    explicit FeedbackHistory(unsigned int numTxModes) : numTxModes_(numTxModes) {}
+
+    //! Appends a UE with the given (empty) buffer for each transmission mode, on the given antennas.
+    void addUe(const RemoteSet& remotes, const LteSummaryBuffer& empty)
+    {
+        for (Remote antenna : remotes)
+            buffers_[antenna].insert(buffers_[antenna].end(), numTxModes_, empty);
+    }
+
+    //! Resets the buffers of a UE to the given (empty) one, on every antenna.
+    void resetUe(unsigned int ueIndex, const LteSummaryBuffer& empty)
+    {
+        for (auto& buffers : buffers_) {
+            if ((ueIndex + 1) * numTxModes_ <= buffers.size())
+                std::fill_n(buffers.begin() + ueIndex * numTxModes_, numTxModes_, empty);
+        }
+    }
+
+    //! Returns the number of UEs of an antenna.
+    unsigned int getNumUes(Remote antenna) const
+    {
+        return numTxModes_ == 0 ? 0 : buffers_[antenna].size() / numTxModes_;
+    }
+
+    LteSummaryBuffer& at(Remote antenna, unsigned int ueIndex, TxMode txMode)
+    {
+        if (antenna > UNKNOWN_RU || txMode >= numTxModes_)
+            throw cRuntimeError("FeedbackHistory::at - no buffer for antenna %d and tx mode %d", antenna, txMode);
+        return buffers_[antenna].at(ueIndex * numTxModes_ + txMode);
+    }
+
+    const LteSummaryBuffer& at(Remote antenna, unsigned int ueIndex, TxMode txMode) const
+    {
+        return const_cast<FeedbackHistory *>(this)->at(antenna, ueIndex, txMode);
+    }
+};
+
+} //namespace
+
+#endif
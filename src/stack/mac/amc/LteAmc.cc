@@ -71,6 +71,7 @@ void LteAmc::printParameters()
     EV << "RbAllocationType: " << allocationType_ << endl;
     EV << "FBHB capacity DL: " << fbhbCapacityDl_ << endl;
     EV << "FBHB capacity UL: " << fbhbCapacityUl_ << endl;
+    EV << "FBHB summary: " << mac_->par("fbhbSummary").stdstringValue() << endl;
     EV << "PmiWeight: " << pmiComputationWeight_ << endl;
     EV << "CqiWeight: " << cqiComputationWeight_ << endl;
     EV << "DL MCS scale: " << mcsScaleDl_ << endl;
@@ -85,7 +86,7 @@ void LteAmc::printFbhb(Direction dir)
     EV << "# AMC Feedback Historical Base (" << dirToA(dir) << ")" << endl;
     EV << "###################################" << endl;
 
-    std::map<double, History_> *history;
+    CarrierArray<FeedbackHistory> *history;
     std::vector<MacNodeId> *revIndex;
 
     if (dir == DL) {
@@ -100,23 +101,24 @@ void LteAmc::printFbhb(Direction dir)
         throw cRuntimeError("LteAmc::printFbhb(): Unrecognized direction");
     }
 
-    for (auto& [carrier, hist] : *history) { // for each antenna
-        EV << simTime() << " # Carrier: " << carrier << "\n";
-        for (auto& histItem : hist) {
-            EV << simTime() << " # Remote: " << dasToA(histItem.first) << "\n";
-            for (size_t i = 0; i < histItem.second.size(); i++) { // for each UE
+    unsigned int numTxModes = (dir == DL) ? DL_NUM_TXMODE : UL_NUM_TXMODE;
+    for (auto& [carrier, hist] : *history) {
+        EV << simTime() << " # Carrier: " << binder_->getCarrierFrequency(carrier) << "\n";
+        for (auto remote : remoteSet_) { // for each antenna
+            EV << simTime() << " # Remote: " << dasToA(remote) << "\n";
+            for (unsigned int i = 0; i < hist.getNumUes(remote); i++) { // for each UE
                 EV << "Ue index: " << i << ", MacNodeId: " << (*revIndex)[i] << endl;
-                auto& txVec = histItem.second[i];
-                for (size_t t = 0; t < txVec.size(); t++) { // for each tx mode
+                for (unsigned int t = 0; t < numTxModes; t++) { // for each tx mode
                     TxMode txMode = TxMode(t);
+                    const LteSummaryFeedback& summary = hist.at(remote, i, txMode).get();
 
                     // Print only non-empty feedback summary! (all cqi are != NOSIGNALCQI)
-                    Cqi testCqi = txVec[t].get().getCqi(Codeword(0), Band(0));
+                    Cqi testCqi = summary.getCqi(Codeword(0), Band(0));
                     if (testCqi == NOSIGNALCQI)
                         continue;
 
                     EV << "@TxMode " << txMode << endl;
-                    txVec[t].get().print(NODEID_NONE, (*revIndex)[i], dir, txMode, "LteAmc::printAmcFbhb");
+                    summary.print(NODEID_NONE, (*revIndex)[i], dir, txMode, "LteAmc::printAmcFbhb");
                 }
             }
         }
@@ -131,17 +133,18 @@ void LteAmc::printTxParams(Direction dir, double carrierFrequency)
 
     std::vector<UserTxParams> *userInfo;
     std::vector<MacNodeId> *revIndex;
+    CarrierIndex carrierIndex = getCarrierIndex(carrierFrequency);
 
     if (dir == DL) {
-        userInfo = &dlTxParams_[carrierFrequency];
+        userInfo = &dlTxParams_[carrierIndex];
         revIndex = &dlRevNodeIndex_;
     }
     else if (dir == UL) {
-        userInfo = &ulTxParams_[carrierFrequency];
+        userInfo = &ulTxParams_[carrierIndex];
         revIndex = &ulRevNodeIndex_;
     }
     else if (dir == D2D) {
-        userInfo = &d2dTxParams_[carrierFrequency];
+        userInfo = &d2dTxParams_[carrierIndex];
         revIndex = &d2dRevNodeIndex_;
     }
     else {
@@ -220,6 +223,8 @@ LteAmc& LteAmc::operator=(const LteAmc& other)
     fbhbCapacityDl_ = other.fbhbCapacityDl_;
     fbhbCapacityUl_ = other.fbhbCapacityUl_;
     fbhbCapacityD2D_ = other.fbhbCapacityD2D_;
+    fbhbSummaryMode_ = other.fbhbSummaryMode_;
+    fbhbEwmaWeight_ = other.fbhbEwmaWeight_;
     lb_ = other.lb_;
     ub_ = other.ub_;
     pmiComputationWeight_ = other.pmiComputationWeight_;
@@ -252,6 +257,10 @@ void LteAmc::initialize()
     fbhbCapacityDl_ = mac_->par("fbhbCapacityDl");
     fbhbCapacityUl_ = mac_->par("fbhbCapacityUl");
     fbhbCapacityD2D_ = mac_->par("fbhbCapacityD2D");
+    fbhbSummaryMode_ = getFeedbackSummaryMode(mac_->par("fbhbSummary").stdstringValue());
+    fbhbEwmaWeight_ = mac_->par("fbhbEwmaWeight");
+    if (fbhbEwmaWeight_ <= 0 || fbhbEwmaWeight_ > 1)
+        throw cRuntimeError("LteAmc::initialize - fbhbEwmaWeight must be in (0,1], %f given", fbhbEwmaWeight_);
     pmiComputationWeight_ = mac_->par("pmiWeight");
     cqiComputationWeight_ = mac_->par("cqiWeight");
     pilot_ = getAmcPilot(mac_->par("amcMode"));
@@ -332,43 +341,44 @@ void LteAmc::rescaleMcs(double rePerRb, Direction dir)
 *    Functions for feedback management    *
 *******************************************/
 
-History_ *LteAmc::getHistory(Direction dir, double carrierFrequency)
+CarrierIndex LteAmc::getCarrierIndex(double carrierFrequency)
 {
-    History_ history;
-    std::map<double, History_> *historyMap = (dir == DL) ? &dlFeedbackHistory_ : &ulFeedbackHistory_;
-    if (historyMap->find(carrierFrequency) == historyMap->end()) {
+    CarrierIndex carrierIndex = binder_->getCarrierIndex(carrierFrequency);
+    if (carrierIndex == CARRIER_INDEX_NONE)
+        throw cRuntimeError("LteAmc::getCarrierIndex - Carrier [%fGHz] not found", carrierFrequency);
+    return carrierIndex;
+}
+
+FeedbackHistory *LteAmc::getHistory(Direction dir, CarrierIndex carrierIndex)
+{
+    CarrierArray<FeedbackHistory> *historyMap = (dir == DL) ? &dlFeedbackHistory_ : &ulFeedbackHistory_;
+    if (!historyMap->contains(carrierIndex)) {
         // initialize new entry
 
         ConnectedUesMap *connectedUe = (dir == DL) ? &dlConnectedUe_ : &ulConnectedUe_;
         const unsigned char num_tx_mode = (dir == DL) ? DL_NUM_TXMODE : UL_NUM_TXMODE;
         int fbhbCapacity = (dir == DL) ? fbhbCapacityDl_ : fbhbCapacityUl_;
 
-        ConnectedUesMap::const_iterator it, et;
-        RemoteSet::const_iterator ait, aet;
-
-        it = connectedUe->begin();
-        et = connectedUe->end();
-        for ( ; it != et; it++) { // For all UEs (DL)
-            for (auto remote : remoteSet_) {
-                // initialize historical feedback base for this UE (index) for all tx modes and for all RUs
-                history[remote].push_back(
-                        std::vector<LteSummaryBuffer>(num_tx_mode,
-                                LteSummaryBuffer(fbhbCapacity, MAXCW, numBands_, lb_, ub_)));
-            }
+        FeedbackHistory history(num_tx_mode);
+        LteSummaryBuffer empty = newSummaryBuffer(fbhbCapacity);
+        for (size_t i = 0; i < connectedUe->size(); i++) { // For all UEs (DL)
+            // initialize historical feedback base for this UE (index) for all tx modes and for all RUs
+            history.addUe(remoteSet_, empty);
         }
-        (*historyMap)[carrierFrequency] = history;
+        (*historyMap)[carrierIndex] = std::move(history);
     }
-    return &(historyMap->at(carrierFrequency));
+    return &(historyMap->at(carrierIndex));
 }
 
-void LteAmc::pushFeedback(MacNodeId id, Direction dir, LteFeedback fb, double carrierFrequency)
+void LteAmc::pushFeedback(MacNodeId id, Direction dir, const LteFeedback& fb, double carrierFrequency)
 {
     EV << "Feedback from MacNodeId " << id << " (direction " << dirToA(dir) << ")" << endl;
 
-    History_ *history;
+    FeedbackHistory *history;
     std::map<MacNodeId, unsigned int> *nodeIndex;
+    CarrierIndex carrierIndex = getCarrierIndex(carrierFrequency);
 
-    history = getHistory(dir, carrierFrequency);
+    history = getHistory(dir, carrierIndex);
     if (dir == DL) {
         nodeIndex = &dlNodeIndex_;
     }
@@ -389,12 +399,12 @@ void LteAmc::pushFeedback(MacNodeId id, Direction dir, LteFeedback fb, double ca
 
     EV << "ID: " << id << endl;
     EV << "index: " << index << endl;
-    (*history)[antenna].at(index).at(txMode).put(fb);
+    history->at(antenna, index, txMode).put(fb);
 
     // delete the old UserTxParam for this <UE_dir_carrierFreq>, so that it will be recomputed next time it's needed
-    std::map<double, std::vector<UserTxParams>> *txParams = (dir == DL) ? &dlTxParams_ : (dir == UL) ? &ulTxParams_ : throw cRuntimeError("LteAmc::pushFeedback(): Unrecognized direction");
-    if (txParams->find(carrierFrequency) != txParams->end() && txParams->at(carrierFrequency).at(index).isSet())
-        (*txParams)[carrierFrequency].at(index).restoreDefaultValues();
+    CarrierArray<std::vector<UserTxParams>> *txParams = (dir == DL) ? &dlTxParams_ : (dir == UL) ? &ulTxParams_ : throw cRuntimeError("LteAmc::pushFeedback(): Unrecognized direction");
+    if (txParams->contains(carrierIndex) && txParams->at(carrierIndex).at(index).isSet())
+        txParams->at(carrierIndex).at(index).restoreDefaultValues();
 
     // DEBUG
     EV << "Antenna: " << dasToA(antenna) << ", TxMode: " << txMode << ", Index: " << index << endl;
@@ -402,11 +412,12 @@ void LteAmc::pushFeedback(MacNodeId id, Direction dir, LteFeedback fb, double ca
     fb.print(cellId_, id, dir, "LteAmc::pushFeedback");
 }
 
-void LteAmc::pushFeedbackD2D(MacNodeId id, LteFeedback fb, MacNodeId peerId, double carrierFrequency)
+void LteAmc::pushFeedbackD2D(MacNodeId id, const LteFeedback& fb, MacNodeId peerId, double carrierFrequency)
 {
     EV << "Feedback from MacNodeId " << id << " (direction D2D), peerId = " << peerId << endl;
 
-    std::map<MacNodeId, History_> *history = &d2dFeedbackHistory_[carrierFrequency];
+    CarrierIndex carrierIndex = getCarrierIndex(carrierFrequency);
+    std::map<MacNodeId, FeedbackHistory> *history = &d2dFeedbackHistory_[carrierIndex];
     std::map<MacNodeId, unsigned int> *nodeIndex = &d2dNodeIndex_;
 
     // Put the feedback in the FBHB
@@ -419,21 +430,18 @@ void LteAmc::pushFeedbackD2D(MacNodeId id, LteFeedback fb, MacNodeId peerId, dou
 
     if (history->find(peerId) == history->end()) {
         // initialize new history for this peer UE
-        History_ newHist;
-
-        ConnectedUesMap::const_iterator it, et;
-        it = d2dConnectedUe_.begin();
-        et = d2dConnectedUe_.end();
-        for ( ; it != et; it++) { // For all UEs (D2D)
-            newHist[antenna].push_back(std::vector<LteSummaryBuffer>(UL_NUM_TXMODE, LteSummaryBuffer(fbhbCapacityD2D_, MAXCW, numBands_, lb_, ub_)));
+        FeedbackHistory newHist(UL_NUM_TXMODE);
+        LteSummaryBuffer empty = newSummaryBuffer(fbhbCapacityD2D_);
+        for (size_t i = 0; i < d2dConnectedUe_.size(); i++) { // For all UEs (D2D)
+            newHist.addUe({antenna}, empty);
         }
-        (*history)[peerId] = newHist;
+        (*history)[peerId] = std::move(newHist);
     }
-    (*history)[peerId][antenna].at(index).at(txMode).put(fb);
+    (*history)[peerId].at(antenna, index, txMode).put(fb);
 
     // delete the old UserTxParam for this <UE_dir_carrierFreq>, so that it will be recomputed next time it's needed
-    if (d2dTxParams_.find(carrierFrequency) != d2dTxParams_.end() && d2dTxParams_.at(carrierFrequency).at(index).isSet())
-        d2dTxParams_[carrierFrequency].at(index).restoreDefaultValues();
+    if (d2dTxParams_.contains(carrierIndex) && d2dTxParams_.at(carrierIndex).at(index).isSet())
+        d2dTxParams_.at(carrierIndex).at(index).restoreDefaultValues();
 
     // DEBUG
     EV << "PeerId: " << peerId << ", Antenna: " << dasToA(antenna) << ", TxMode: " << txMode << ", Index: " << index << endl;
@@ -451,10 +459,10 @@ const LteSummaryFeedback& LteAmc::getFeedback(MacNodeId id, Remote antenna, TxMo
     if (dir != DL && dir != UL)
         throw cRuntimeError("LteAmc::getFeedback(): Unrecognized direction");
 
-    History_ *history = getHistory(dir, carrierFrequency);
+    FeedbackHistory *history = getHistory(dir, getCarrierIndex(carrierFrequency));
     std::map<MacNodeId, unsigned int> *nodeIndex = (dir == DL) ? &dlNodeIndex_ : &ulNodeIndex_;
 
-    return (*history).at(antenna).at((*nodeIndex).at(id)).at(txMode).get();
+    return history->at(antenna, (*nodeIndex).at(id), txMode).get();
 }
 
 const LteSummaryFeedback& LteAmc::getFeedbackD2D(MacNodeId id, Remote antenna, TxMode txMode, MacNodeId peerId, double carrierFrequency)
@@ -465,9 +473,10 @@ const LteSummaryFeedback& LteAmc::getFeedbackD2D(MacNodeId id, Remote antenna, T
         EV << NOW << " LteAmc::getFeedbackD2D detected " << nh << " as next hop for " << id << "\n";
     id = nh;
 
+    const std::map<MacNodeId, FeedbackHistory>& d2dHistory = d2dFeedbackHistory_.at(getCarrierIndex(carrierFrequency));
     if (peerId == NODEID_NONE) {
         // we return the first feedback stored in the structure
-        for (const auto& [histNodeId, history] : d2dFeedbackHistory_.at(carrierFrequency)) {
+        for (const auto& [histNodeId, history] : d2dHistory) {
             if (histNodeId == NODEID_NONE) // skip fake UE 0
                 continue;
 
@@ -479,9 +488,9 @@ const LteSummaryFeedback& LteAmc::getFeedbackD2D(MacNodeId id, Remote antenna, T
 
         // default feedback: when there is no feedback from peers yet (NOSIGNALCQI)
         if (peerId == NODEID_NONE)
-            return d2dFeedbackHistory_.at(carrierFrequency).at(NODEID_NONE).at(MACRO).at(0).at(txMode).get();
+            return d2dHistory.at(NODEID_NONE).at(MACRO, 0, txMode).get();
     }
-    return d2dFeedbackHistory_.at(carrierFrequency).at(peerId).at(antenna).at(d2dNodeIndex_.at(id)).at(txMode).get();
+    return d2dHistory.at(peerId).at(antenna, d2dNodeIndex_.at(id), txMode).get();
 }
 
 /*******************************************
@@ -513,13 +522,14 @@ bool LteAmc::existTxParams(MacNodeId id, const Direction dir, double carrierFreq
         EV << NOW << " LteAmc::existTxParams detected " << nh << " as next hop for " << id << "\n";
     id = nh;
 
-    std::map<double, std::vector<UserTxParams>> *txParams = (dir == DL) ? &dlTxParams_ : (dir == UL) ? &ulTxParams_ : (dir == D2D) ? &d2dTxParams_ : throw cRuntimeError("LteAmc::existTxParams(): Unrecognized direction");
-    if (txParams->find(carrierFrequency) == txParams->end())
+    CarrierArray<std::vector<UserTxParams>> *txParams = (dir == DL) ? &dlTxParams_ : (dir == UL) ? &ulTxParams_ : (dir == D2D) ? &d2dTxParams_ : throw cRuntimeError("LteAmc::existTxParams(): Unrecognized direction");
+    CarrierIndex carrierIndex = getCarrierIndex(carrierFrequency);
+    if (!txParams->contains(carrierIndex))
         return false;
 
     std::map<MacNodeId, unsigned int>& nodeIndex = (dir == DL) ? dlNodeIndex_ : (dir == UL) ? ulNodeIndex_ : d2dNodeIndex_;
 
-    return (*txParams)[carrierFrequency].at(nodeIndex.at(id)).isSet();
+    return txParams->at(carrierIndex).at(nodeIndex.at(id)).isSet();
 }
 
 const UserTxParams& LteAmc::setTxParams(MacNodeId id, const Direction dir, UserTxParams& info, double carrierFrequency)
@@ -544,16 +554,17 @@ const UserTxParams& LteAmc::setTxParams(MacNodeId id, const Direction dir, UserT
     }
     EV << endl;
 
-    std::map<double, std::vector<UserTxParams>> *txParams = (dir == DL) ? &dlTxParams_ : (dir == UL) ? &ulTxParams_ : (dir == D2D) ? &d2dTxParams_ : throw cRuntimeError("LteAmc::setTxParams(): Unrecognized direction");
+    CarrierArray<std::vector<UserTxParams>> *txParams = (dir == DL) ? &dlTxParams_ : (dir == UL) ? &ulTxParams_ : (dir == D2D) ? &d2dTxParams_ : throw cRuntimeError("LteAmc::setTxParams(): Unrecognized direction");
     std::map<MacNodeId, unsigned int>& nodeIndex = (dir == DL) ? dlNodeIndex_ : (dir == UL) ? ulNodeIndex_ : d2dNodeIndex_;
-    if (txParams->find(carrierFrequency) == txParams->end()) {
+    CarrierIndex carrierIndex = getCarrierIndex(carrierFrequency);
+    if (!txParams->contains(carrierIndex)) {
         // Initialize user transmission parameters structures
         ConnectedUesMap& connectedUe = (dir == DL) ? dlConnectedUe_ : ulConnectedUe_;
         std::vector<UserTxParams> tmp;
         tmp.resize(connectedUe.size(), UserTxParams());
-        (*txParams)[carrierFrequency] = tmp;
+        (*txParams)[carrierIndex] = tmp;
     }
-    return (*txParams)[carrierFrequency].at(nodeIndex.at(id)) = info;
+    return txParams->at(carrierIndex).at(nodeIndex.at(id)) = info;
 }
 
 const UserTxParams& LteAmc::computeTxParams(MacNodeId id, const Direction dir, double carrierFrequency)
@@ -850,12 +861,13 @@ const UserTxParams& LteAmc::getTxParams(MacNodeId id, const Direction dir, doubl
         EV << NOW << " LteAmc::getTxParams detected " << nh << " as next hop for " << id << "\n";
     id = nh;
 
+    CarrierIndex carrierIndex = getCarrierIndex(carrierFrequency);
     if (dir == DL)
-        return dlTxParams_[carrierFrequency].at(dlNodeIndex_.at(id));
+        return dlTxParams_[carrierIndex].at(dlNodeIndex_.at(id));
     else if (dir == UL)
-        return ulTxParams_[carrierFrequency].at(ulNodeIndex_.at(id));
+        return ulTxParams_[carrierIndex].at(ulNodeIndex_.at(id));
     else if (dir == D2D)
-        return d2dTxParams_[carrierFrequency].at(d2dNodeIndex_.at(id));
+        return d2dTxParams_[carrierIndex].at(d2dNodeIndex_.at(id));
     else
         throw cRuntimeError("LteAmc::getTxParams(): Unrecognized direction");
 }
@@ -1107,28 +1119,32 @@ void LteAmc::detachUser(MacNodeId nodeId, Direction dir)
     EV << "##################################" << endl;
     try {
         ConnectedUesMap *connectedUe;
-        std::map<double, std::vector<UserTxParams>> *userInfoVec;
-        std::map<double, History_> *history;
-        std::map<double, std::map<MacNodeId, History_>> *d2dHistory;
+        CarrierArray<std::vector<UserTxParams>> *userInfoVec;
+        CarrierArray<FeedbackHistory> *history;
+        CarrierArray<std::map<MacNodeId, FeedbackHistory>> *d2dHistory;
         unsigned int nodeIndex;
+        unsigned int fbhbCapacity;
 
         if (dir == DL) {
             connectedUe = &dlConnectedUe_;
             userInfoVec = &dlTxParams_;
             history = &dlFeedbackHistory_;
             nodeIndex = dlNodeIndex_.at(nodeId);
+            fbhbCapacity = fbhbCapacityDl_;
         }
         else if (dir == UL) {
             connectedUe = &ulConnectedUe_;
             userInfoVec = &ulTxParams_;
             history = &ulFeedbackHistory_;
             nodeIndex = ulNodeIndex_.at(nodeId);
+            fbhbCapacity = fbhbCapacityUl_;
         }
         else if (dir == D2D) {
             connectedUe = &d2dConnectedUe_;
             userInfoVec = &d2dTxParams_;
             d2dHistory = &d2dFeedbackHistory_;
             nodeIndex = d2dNodeIndex_.at(nodeId);
+            fbhbCapacity = fbhbCapacityD2D_;
         }
         else {
             throw cRuntimeError("LteAmc::detachUser(): Unrecognized direction");
@@ -1137,11 +1153,10 @@ void LteAmc::detachUser(MacNodeId nodeId, Direction dir)
         (*connectedUe).at(nodeId) = false;
 
         // clear feedback data from history
+        LteSummaryBuffer empty = newSummaryBuffer(fbhbCapacity);
         if (dir == UL || dir == DL) {
             for (auto& hit : *history) {
-                for (auto remote : remoteSet_) {
-                    hit.second.at(remote).at(nodeIndex).clear();
-                }
+                hit.second.resetUe(nodeIndex, empty);
             }
         }
         else { // D2D
@@ -1150,9 +1165,7 @@ void LteAmc::detachUser(MacNodeId nodeId, Direction dir)
                     if (ht.first == NODEID_NONE)                                          // skip fake UE 0
                         continue;
 
-                    for (auto remote : remoteSet_) {
-                        ht.second.at(remote).at(nodeIndex).clear();
-                    }
+                    ht.second.resetUe(nodeIndex, empty);
                 }
             }
         }
@@ -1176,9 +1189,9 @@ void LteAmc::attachUser(MacNodeId nodeId, Direction dir)
     ConnectedUesMap *connectedUe;
     std::map<MacNodeId, unsigned int> *nodeIndexMap;
     std::vector<MacNodeId> *revIndexVec;
-    std::map<double, std::vector<UserTxParams>> *userInfoVec;
-    std::map<double, History_> *history;
-    std::map<double, std::map<MacNodeId, History_>> *d2dHistory;
+    CarrierArray<std::vector<UserTxParams>> *userInfoVec;
+    CarrierArray<FeedbackHistory> *history;
+    CarrierArray<std::map<MacNodeId, FeedbackHistory>> *d2dHistory;
     unsigned int nodeIndex;
     unsigned int fbhbCapacity;
     unsigned int numTxModes;
@@ -1214,9 +1227,8 @@ void LteAmc::attachUser(MacNodeId nodeId, Direction dir)
         throw cRuntimeError("LteAmc::attachUser(): Unrecognized direction");
     }
 
-    // Prepare iterators and empty feedback data
-    LteSummaryBuffer b = LteSummaryBuffer(fbhbCapacity, MAXCW, numBands_, lb_, ub_);
-    std::vector<LteSummaryBuffer> v = std::vector<LteSummaryBuffer>(numTxModes, b);
+    // Prepare empty feedback data
+    LteSummaryBuffer empty = newSummaryBuffer(fbhbCapacity);
 
     // check if the UE is known (it has been here before)
     if ((*connectedUe).find(nodeId) != (*connectedUe).end()) {
@@ -1233,9 +1245,7 @@ void LteAmc::attachUser(MacNodeId nodeId, Direction dir)
         // initialize empty feedback structures
         if (dir == UL || dir == DL) {
             for (auto&  hist : *history) {
-                for (auto remote : remoteSet_) {
-                    (hist.second)[remote].at(nodeIndex) = v;
-                }
+                hist.second.resetUe(nodeIndex, empty);
             }
         }
         else { // D2D
@@ -1244,9 +1254,7 @@ void LteAmc::attachUser(MacNodeId nodeId, Direction dir)
                     if (ht.first == NODEID_NONE)                                          // skip fake UE 0
                         continue;
 
-                    for (auto remote : remoteSet_) {
-                        (ht.second)[remote].at(nodeIndex) = v;
-                    }
+                    ht.second.resetUe(nodeIndex, empty);
                 }
             }
         }
@@ -1268,20 +1276,16 @@ void LteAmc::attachUser(MacNodeId nodeId, Direction dir)
         // initialize empty feedback structures
         if (dir == UL || dir == DL) {
             for (auto& [key, hist] : *history) {
-                for (auto remote : remoteSet_) {
-                    hist[remote].push_back(v); // XXX DEBUG THIS!!
-                }
+                hist.addUe(remoteSet_, empty);
             }
         }
         else { // D2D
             // initialize an empty feedback for a fake user (id 0), in order to manage
             // the case of transmission before a feedback has been reported
             for (auto& [key, hist] : *d2dHistory) {
-                hist[NODEID_NONE] = History_();
+                hist[NODEID_NONE] = FeedbackHistory(numTxModes);
                 for (auto& [key2, d2dHistory] : hist) {
-                    for (auto remote : remoteSet_) {
-                        d2dHistory[remote].push_back(v); // XXX DEBUG THIS!!
-                    }
+                    d2dHistory.addUe(remoteSet_, empty);
                 }
             }
         }
@@ -1298,9 +1302,9 @@ void LteAmc::testUe(MacNodeId nodeId, Direction dir)
     ConnectedUesMap *connectedUe;
     std::map<MacNodeId, unsigned int> *nodeIndexMap;
     std::vector<MacNodeId> *revIndexVec;
-    std::map<double, std::vector<UserTxParams>> *userInfoVec;
-    std::map<double, History_> *history;
-    std::map<double, std::map<MacNodeId, History_>> *d2dHistory;
+    CarrierArray<std::vector<UserTxParams>> *userInfoVec;
+    CarrierArray<FeedbackHistory> *history;
+    CarrierArray<std::map<MacNodeId, FeedbackHistory>> *d2dHistory;
     int numTxModes;
 
     if (dir == DL) {
@@ -1346,27 +1350,27 @@ void LteAmc::testUe(MacNodeId nodeId, Direction dir)
     // If connected compute and print user transmission parameters and history
     for (const auto& [key, value] : *userInfoVec) {
         UserTxParams info = value.at(nodeIndex);
-        EV << "UserTxParams - carrier[" << key << "]" << endl;
+        EV << "UserTxParams - carrier[" << binder_->getCarrierFrequency(key) << "]" << endl;
         info.print("LteAmc::testUe");
     }
 
     if (dir == UL || dir == DL) {
         RemoteSet::iterator it = remoteSet_.begin();
         RemoteSet::iterator et = remoteSet_.end();
-        std::vector<LteSummaryBuffer> feedback;
 
         for (const auto& hit : *history) {
             EV << "History" << endl;
             for ( ; it != et; it++ ) {
                 EV << "Remote: " << dasToA(*it) << endl;
-                feedback = (hit.second).at(*it).at(nodeIndex);
                 for (int i = 0; i < numTxModes; i++) {
+                    const LteSummaryFeedback& feedback = (hit.second).at(*it, nodeIndex, TxMode(i)).get();
+
                     // Print only non-empty feedback summary! (all cqi are != NOSIGNALCQI)
-                    Cqi testCqi = (feedback.at(i).get()).getCqi(Codeword(0), Band(0));
+                    Cqi testCqi = feedback.getCqi(Codeword(0), Band(0));
                     if (testCqi == NOSIGNALCQI)
                         continue;
 
-                    feedback.at(i).get().print(NODEID_NONE, nodeId, dir, TxMode(i), "LteAmc::testUe");
+                    feedback.print(NODEID_NONE, nodeId, dir, TxMode(i), "LteAmc::testUe");
                 }
             }
         }
@@ -1374,20 +1378,20 @@ void LteAmc::testUe(MacNodeId nodeId, Direction dir)
     else { // D2D
         for (const auto& hit : *d2dHistory) {
             for (const auto& ht : hit.second) {
-                const History_& d2dHistory = ht.second;
-                std::vector<LteSummaryBuffer> feedback;
+                const FeedbackHistory& d2dHistory = ht.second;
 
                 EV << "History" << endl;
                 for (auto remote : remoteSet_) {
                     EV << "Remote: " << dasToA(remote) << endl;
-                    feedback = d2dHistory.at(remote).at(nodeIndex);
                     for (int i = 0; i < numTxModes; i++) {
+                        const LteSummaryFeedback& feedback = d2dHistory.at(remote, nodeIndex, TxMode(i)).get();
+
                         // Print only non-empty feedback summary! (all cqi are != NOSIGNALCQI)
-                        Cqi testCqi = (feedback.at(i).get()).getCqi(Codeword(0), Band(0));
+                        Cqi testCqi = feedback.getCqi(Codeword(0), Band(0));
                         if (testCqi == NOSIGNALCQI)
                             continue;
 
-                        feedback.at(i).get().print(NODEID_NONE, nodeId, dir, TxMode(i), "LteAmc::testUe");
+                        feedback.print(NODEID_NONE, nodeId, dir, TxMode(i), "LteAmc::testUe");
                     }
                 }
             }
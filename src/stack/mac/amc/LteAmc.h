@@ -17,11 +17,13 @@
 #include "common/cellInfo/CellInfo.h"
 #include "stack/phy/feedback/LteFeedback.h"
 #include "stack/phy/feedback/LteSummaryBuffer.h"
+#include "stack/mac/amc/FeedbackHistory.h"
 #include "stack/mac/amc/AmcPilot.h"
 #include "stack/mac/amc/LteMcs.h"
 #include "stack/mac/amc/UserTxParams.h"
 #include "stack/mac/LteMacEnb.h"
 #include "common/binder/Binder.h"
+#include "common/CarrierArray.h"
 
 namespace simu5g {
 
@@ -34,8 +36,6 @@ class CellInfo;
 /// Forward declaration of LteMacEnb class, used by LteAmc.
 class LteMacEnb;
 
-typedef std::map<Remote, std::vector<std::vector<LteSummaryBuffer>>> History_;
-
 /**
  * @class LteAMC
  * @brief Lte AMC module for Omnet++ simulator
@@ -82,20 +82,22 @@ class LteAmc
     std::vector<MacNodeId> d2dRevNodeIndex_;
 
     // one tx param per carrier
-    std::map<double, std::vector<UserTxParams>> dlTxParams_;
-    std::map<double, std::vector<UserTxParams>> ulTxParams_;
-    std::map<double, std::vector<UserTxParams>> d2dTxParams_;
+    CarrierArray<std::vector<UserTxParams>> dlTxParams_;
+    CarrierArray<std::vector<UserTxParams>> ulTxParams_;
+    CarrierArray<std::vector<UserTxParams>> d2dTxParams_;
 
     int fType_; //CQI synchronization Debugging
 
     // one History per carrier
-    std::map<double, History_> dlFeedbackHistory_;
-    std::map<double, History_> ulFeedbackHistory_;
-    std::map<double, std::map<MacNodeId, History_>> d2dFeedbackHistory_;
+    CarrierArray<FeedbackHistory> dlFeedbackHistory_;
+    CarrierArray<FeedbackHistory> ulFeedbackHistory_;
+    CarrierArray<std::map<MacNodeId, FeedbackHistory>> d2dFeedbackHistory_;
 
     unsigned int fbhbCapacityDl_;
     unsigned int fbhbCapacityUl_;
     unsigned int fbhbCapacityD2D_;
+    FeedbackSummaryMode fbhbSummaryMode_;
+    double fbhbEwmaWeight_;
     simtime_t lb_;
     simtime_t ub_;
     double pmiComputationWeight_;
@@ -104,7 +106,16 @@ class LteAmc
     LteMuMimoMatrix muMimoUlMatrix_;
     LteMuMimoMatrix muMimoD2DMatrix_;
 
-    History_ *getHistory(Direction dir, double carrierFrequency);
+    FeedbackHistory *getHistory(Direction dir, CarrierIndex carrierIndex);
+
+    // empty summary buffer of the given capacity
+    LteSummaryBuffer newSummaryBuffer(unsigned int capacity) const
+    {
+        return LteSummaryBuffer(capacity, MAXCW, numBands_, lb_, ub_, fbhbSummaryMode_, fbhbEwmaWeight_);
+    }
+
+    // maps a carrier frequency to the index of its per-carrier state
+    CarrierIndex getCarrierIndex(double carrierFrequency);
 
   public:
     LteAmc(LteMacEnb *mac, Binder *binder, CellInfo *cellInfo, int numAntennas);
@@ -125,8 +136,8 @@ class LteAmc
     // CodeRate MCS rescaling
     void rescaleMcs(double rePerRb, Direction dir = DL);
 
-    void pushFeedback(MacNodeId id, Direction dir, LteFeedback fb, double carrierFrequency);
-    void pushFeedbackD2D(MacNodeId id, LteFeedback fb, MacNodeId peerId, double carrierFrequency);
+    void pushFeedback(MacNodeId id, Direction dir, const LteFeedback& fb, double carrierFrequency);
+    void pushFeedbackD2D(MacNodeId id, const LteFeedback& fb, MacNodeId peerId, double carrierFrequency);
     const LteSummaryFeedback& getFeedback(MacNodeId id, Remote antenna, TxMode txMode, const Direction dir, double carrierFrequency);
     const LteSummaryFeedback& getFeedbackD2D(MacNodeId id, Remote antenna, TxMode txMode, MacNodeId peerId, double carrierFrequency);
 
@@ -151,6 +162,9 @@ class LteAmc
 
     virtual unsigned int computeBitsPerRbBackground(Cqi cqi, const Direction dir, double carrierFrequency);
 
+    // limits the symbols used by the TBS computation, e.g. for mini-slot transmissions (0: whole slot)
+    virtual void setSymbolLimit(unsigned int symbols) {}
+
     // multiband version of the above function. It returns the number of bytes that can fit in the given "blocks" of the given "band"
     virtual unsigned int computeBytesOnNRbs_MB(MacNodeId id, Band b, unsigned int blocks, const Direction dir, double carrierFrequency);
     virtual unsigned int computeBitsOnNRbs_MB(MacNodeId id, Band b, unsigned int blocks, const Direction dir, double carrierFrequency);
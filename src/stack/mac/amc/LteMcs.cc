@@ -318,54 +318,60 @@ const unsigned int *itbs2tbs(LteMod mod, TxMode txMode, unsigned char layers, un
 
 std::vector<unsigned char> cwMapping(const TxMode& txMode, const Rank& ri, const unsigned int antennaPorts)
 {
-    std::vector<unsigned char> res;
+    unsigned char layers[MAX_CODEWORDS];
+    unsigned int codewords = cwMapping(txMode, ri, antennaPorts, layers);
+    return std::vector<unsigned char>(layers, layers + codewords);
+}
 
+unsigned int cwMapping(const TxMode& txMode, const Rank& ri, const unsigned int antennaPorts, unsigned char layers[MAX_CODEWORDS])
+{
     if (ri <= 1) {
-        res.push_back(1);
+        layers[0] = 1;
+        return 1;
     }
-    else {
-        switch (txMode) {
-            // SISO and MU-MIMO support only rank 1 transmission (1 layer)
-            case SINGLE_ANTENNA_PORT0:
-            case SINGLE_ANTENNA_PORT5:
-            case MULTI_USER:
-                res.push_back(1);
-                break;
 
-            // TX Diversity uses a number of layers equal to antennaPorts
-            case TRANSMIT_DIVERSITY:
-                res.push_back(antennaPorts);
-                break;
+    switch (txMode) {
+        // SISO and MU-MIMO support only rank 1 transmission (1 layer)
+        case SINGLE_ANTENNA_PORT0:
+        case SINGLE_ANTENNA_PORT5:
+        case MULTI_USER:
+            layers[0] = 1;
+            return 1;
 
-            // Spatial MUX uses MIN(RI, antennaPorts) layers
-            case OL_SPATIAL_MULTIPLEXING:
-            case CL_SPATIAL_MULTIPLEXING: {
-                int usedRi = (antennaPorts < ri) ? antennaPorts : ri;
-                if (usedRi == 2) {
-                    res.push_back(1);
-                    res.push_back(1);
-                }
-                if (usedRi == 3) {
-                    res.push_back(1);
-                    res.push_back(2);
-                }
-                if (usedRi == 4) {
-                    res.push_back(2);
-                    res.push_back(2);
-                }
-                if (usedRi == 8) {
-                    res.push_back(4);
-                    res.push_back(4);
-                }
-                break;
-            }
+        // TX Diversity uses a number of layers equal to antennaPorts
+        case TRANSMIT_DIVERSITY:
+            layers[0] = antennaPorts;
+            return 1;
 
-            default:
-                res.push_back(1);
-                break;
+        // Spatial MUX uses MIN(RI, antennaPorts) layers
+        case OL_SPATIAL_MULTIPLEXING:
+        case CL_SPATIAL_MULTIPLEXING: {
+            int usedRi = (antennaPorts < ri) ? antennaPorts : ri;
+            if (usedRi == 2) {
+                layers[0] = 1;
+                layers[1] = 1;
+            }
+            else if (usedRi == 3) {
+                layers[0] = 1;
+                layers[1] = 2;
+            }
+            else if (usedRi == 4) {
+                layers[0] = 2;
+                layers[1] = 2;
+            }
+            else if (usedRi == 8) {
+                layers[0] = 4;
+                layers[1] = 4;
+            }
+            else
+                return 0;
+            return 2;
         }
+
+        default:
+            layers[0] = 1;
+            return 1;
     }
-    return res;
 }
 
 } //namespace
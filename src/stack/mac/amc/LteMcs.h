@@ -109,6 +109,13 @@ const unsigned int *itbs2tbs(LteMod mod, TxMode txMode, unsigned char layers, un
  */
 std::vector<unsigned char> cwMapping(const TxMode& txMode, const Rank& ri, const unsigned int antennaPorts);
 
+/**
+ * Same as above, without allocation.
+ * @param layers Filled with the number of layers of each codeword.
+ * @return The number of codewords.
+ */
+unsigned int cwMapping(const TxMode& txMode, const Rank& ri, const unsigned int antennaPorts, unsigned char layers[MAX_CODEWORDS]);
+
 } //namespace
 
 #endif
@@ -23,6 +23,13 @@ using namespace omnetpp;
 NRAmc::NRAmc(LteMacEnb *mac, Binder *binder, CellInfo *cellInfo, int numAntennas)
     : LteAmc(mac, binder, cellInfo, numAntennas)
 {
+    // TBS tables for the slot formats of the carriers, up to all the blocks of the cell
+    // and 2 layers per codeword (rank 4). Other shapes are added on their first lookup
+    for (const auto& [carrierFrequency, carrierInfo] : *cellInfo->getCarrierInfoMap()) {
+        const SlotFormat& sf = carrierInfo.slotFormat;
+        buildTbsTable(DL, sf.tdd ? sf.numDlSymbols : 14, 2, cellInfo->getNumBands());
+        buildTbsTable(UL, sf.tdd ? sf.numUlSymbols : 14, 2, cellInfo->getNumBands());
+    }
 }
 
 
@@ -32,99 +39,44 @@ unsigned int NRAmc::getSymbolsPerSlot(double carrierFrequency, Direction dir)
 
     // use a function from the binder
     SlotFormat sf = binder_->getSlotFormat(carrierFrequency);
-    if (!sf.tdd)
-        return totSymbols;
-
+    unsigned int symbols = totSymbols;
     // TODO handle FLEX symbols: so far, they are used as guard (hence, not used for scheduling)
-    if (dir == DL)
-        return sf.numDlSymbols;
-    // else UL
-    return sf.numUlSymbols;
-}
-
-unsigned int NRAmc::getResourceElementsPerBlock(unsigned int symbolsPerSlot)
-{
-    unsigned int numSubcarriers = 12;   // TODO get this parameter from CellInfo/Carrier
-    unsigned int reSignal = 1;
-    unsigned int nOverhead = 0;
-
-    if (symbolsPerSlot == 0)
-        return 0;
-    return (numSubcarriers * symbolsPerSlot) - reSignal - nOverhead;
-}
-
-unsigned int NRAmc::getResourceElements(unsigned int blocks, unsigned int symbolsPerSlot)
-{
-    unsigned int numRePerBlock = getResourceElementsPerBlock(symbolsPerSlot);
-
-    if (numRePerBlock > 156)
-        return 156 * blocks;
+    if (sf.tdd)
+        symbols = (dir == DL) ? sf.numDlSymbols : sf.numUlSymbols;
 
-    return numRePerBlock * blocks;
+    // a mini-slot transmission spans only part of the slot
+    if (symbolLimit_ > 0 && symbolLimit_ < symbols)
+        symbols = symbolLimit_;
+    return symbols;
 }
 
-unsigned int NRAmc::computeTbsFromNinfo(double nInfo, double coderate)
+void NRAmc::buildTbsTable(Direction dir, unsigned int symbols, unsigned int layers, unsigned int blocks)
 {
-    unsigned int tbs = 0;
-    unsigned int _nInfo = 0;
-    unsigned int n = 0;
-    if (nInfo == 0)
-        return 0;
-
-    if (nInfo <= 3824) {
-        n = std::max((int)3, (int)(floor(log2(nInfo) - 6)));
-        _nInfo = std::max((unsigned int)24, (unsigned int)((1 << n) * floor(nInfo / (1 << n))));
-
-        // get tbs from table
-        unsigned int j = 0;
-        for (j = 0; j < TBSTABLESIZE - 1; j++) {
-            if (nInfoToTbs[j] >= _nInfo)
-                break;
-        }
-
-        tbs = nInfoToTbs[j];
-    }
-    else {
-        unsigned int C;
-        n = floor(log2(nInfo - 24) - 5);
-        _nInfo = (1 << n) * round((nInfo - 24) / (1 << n));
-        if (coderate <= 0.25) {
-            C = ceil((_nInfo + 24) / 3816);
-            tbs = 8 * C * ceil((_nInfo + 24) / (8 * C)) - 24;
-        }
-        else {
-            if (_nInfo >= 8424) {
-                C = ceil((_nInfo + 24) / 8424);
-                tbs = 8 * C * ceil((_nInfo + 24) / (8 * C)) - 24;
-            }
-            else {
-                tbs = 8 * ceil((_nInfo + 24) / 8) - 24;
-            }
+    std::vector<TbsTable>& tables = tbsTables_[dir == DL ? 0 : 1];
+    if (symbols >= tables.size())
+        tables.resize(symbols + 1);
+    TbsTable& table = tables[symbols];
+
+    // grow geometrically, so that a sequence of larger requests is built only a few times
+    layers = std::max(layers, table.layers);
+    if (blocks > table.blocks)
+        blocks = std::max(blocks, 2 * table.blocks);
+    else
+        blocks = table.blocks;
+
+    EV << NOW << " NRAmc::buildTbsTable " << dirToA(dir) << " symbols " << symbols << " layers " << layers << " blocks " << blocks << endl;
+
+    table.layers = layers;
+    table.blocks = blocks;
+    table.tbs.assign((MAXCQI + 1) * layers * (blocks + 1), 0);
+    for (Cqi cqi = 1; cqi <= MAXCQI; cqi++) {
+        NRMCSelem mcsElem = getMcsElemPerCqi(cqi, dir);
+        for (unsigned int l = 1; l <= layers; l++) {
+            unsigned int *row = &table.tbs[(cqi * layers + l - 1) * (blocks + 1)];
+            for (unsigned int b = 1; b <= blocks; b++)
+                row[b] = computeNrTbs(mcsElem, l, getNrResourceElements(b, symbols));
         }
     }
-    return tbs;
-}
-
-unsigned int NRAmc::computeCodewordTbs(UserTxParams *info, Codeword cw, Direction dir, unsigned int numRe)
-{
-    std::vector<unsigned char> layers = info->getLayers();
-    NRMCSelem mcsElem = getMcsElemPerCqi(info->readCqiVector().at(cw), dir);
-    unsigned int modFactor;
-    switch (mcsElem.mod_) {
-        case _QPSK:   modFactor = 2;
-            break;
-        case _16QAM:  modFactor = 4;
-            break;
-        case _64QAM:  modFactor = 6;
-            break;
-        case _256QAM: modFactor = 8;
-            break;
-        default: throw cRuntimeError("NRAmc::computeCodewordTbs - unrecognized modulation.");
-    }
-    double coderate = mcsElem.coderate_ / 1024;
-    double nInfo = numRe * coderate * modFactor * layers.at(cw);
-
-    return computeTbsFromNinfo(floor(nInfo), coderate);
 }
 
 /*******************************************
@@ -141,22 +93,23 @@ unsigned int NRAmc::computeBitsOnNRbs(MacNodeId id, Band b, unsigned int blocks,
     EV << NOW << " NRAmc::computeBitsOnNRbs Band: " << b << "\n";
     EV << NOW << " NRAmc::computeBitsOnNRbs Direction: " << dirToA(dir) << "\n";
 
-    unsigned int numRe = getResourceElements(blocks, getSymbolsPerSlot(carrierFrequency, dir));
+    unsigned int symbols = getSymbolsPerSlot(carrierFrequency, dir);
 
     // Acquiring current user scheduling information
-    UserTxParams info = computeTxParams(id, dir, carrierFrequency);
+    const UserTxParams& info = computeTxParams(id, dir, carrierFrequency);
 
     unsigned int bits = 0;
-    unsigned int codewords = info.getLayers().size();
+    unsigned char layers[MAX_CODEWORDS];
+    unsigned int codewords = info.readLayers(layers);
     for (Codeword cw = 0; cw < codewords; ++cw) {
         // if CQI == 0 the UE is out of range, thus bits=0
-        if (info.readCqiVector().at(cw) == 0) {
+        Cqi cqi = info.readCqiVector().at(cw);
+        if (cqi == 0) {
             EV << NOW << " NRAmc::computeBitsOnNRbs - CQI equal to zero on cw " << cw << ", return no blocks available" << endl;
             continue;
         }
 
-        unsigned int tbs = computeCodewordTbs(&info, cw, dir, numRe);
-        bits += tbs;
+        bits += lookupTbs(dir, symbols, cqi, layers[cw], blocks);
     }
 
     // DEBUG
@@ -177,18 +130,21 @@ unsigned int NRAmc::computeBitsOnNRbs(MacNodeId id, Band b, Codeword cw, unsigne
     EV << NOW << " NRAmc::computeBitsOnNRbs Codeword: " << cw << "\n";
     EV << NOW << " NRAmc::computeBitsOnNRbs Direction: " << dirToA(dir) << "\n";
 
-    unsigned int numRe = getResourceElements(blocks, getSymbolsPerSlot(carrierFrequency, dir));
+    unsigned int symbols = getSymbolsPerSlot(carrierFrequency, dir);
 
     // Acquiring current user scheduling information
-    UserTxParams info = computeTxParams(id, dir, carrierFrequency);
+    const UserTxParams& info = computeTxParams(id, dir, carrierFrequency);
 
     // if CQI == 0 the UE is out of range, thus return 0
-    if (info.readCqiVector().at(cw) == 0) {
+    Cqi cqi = info.readCqiVector().at(cw);
+    if (cqi == 0) {
         EV << NOW << " NRAmc::computeBitsOnNRbs - CQI equal to zero, return no blocks available" << endl;
         return 0;
     }
 
-    unsigned int tbs = computeCodewordTbs(&info, cw, dir, numRe);
+    unsigned char layers[MAX_CODEWORDS];
+    info.readLayers(layers);
+    unsigned int tbs = lookupTbs(dir, symbols, cqi, layers[cw], blocks);
 
     // DEBUG
     EV << NOW << " NRAmc::computeBitsOnNRbs Resource Blocks: " << blocks << "\n";
@@ -212,25 +168,7 @@ unsigned int NRAmc::computeBitsPerRbBackground(Cqi cqi, const Direction dir, dou
     unsigned char layers = 1;
 
     // compute TBS
-
-    NRMCSelem mcsElem = getMcsElemPerCqi(cqi, dir);
-    unsigned int numRe = getResourceElements(blocks, getSymbolsPerSlot(carrierFrequency, dir));
-    unsigned int modFactor;
-    switch (mcsElem.mod_) {
-        case _QPSK:   modFactor = 2;
-            break;
-        case _16QAM:  modFactor = 4;
-            break;
-        case _64QAM:  modFactor = 6;
-            break;
-        case _256QAM: modFactor = 8;
-            break;
-        default: throw cRuntimeError("NRAmc::computeCodewordTbs - unrecognized modulation.");
-    }
-    double coderate = mcsElem.coderate_ / 1024;
-    double nInfo = numRe * coderate * modFactor * layers;
-
-    unsigned int tbs = computeTbsFromNinfo(floor(nInfo), coderate);
+    unsigned int tbs = lookupTbs(dir, getSymbolsPerSlot(carrierFrequency, dir), cqi, layers, blocks);
 
     EV << NOW << " NRAmc::computeBitsPerRbBackground Available space: " << tbs << "\n";
 
@@ -248,29 +186,7 @@ NRMCSelem NRAmc::getMcsElemPerCqi(Cqi cqi, const Direction dir)
     else {
         throw cRuntimeError("NRAmc::getIMcsPerCqi(): Unrecognized direction");
     }
-    CQIelem entry = mcsTable->getCqiElem(cqi);
-    LteMod mod = entry.mod_;
-    double rate = entry.rate_;
-
-    // Select the ranges for searching in the McsTable (extended reporting supported)
-    unsigned int min = mcsTable->getMinIndex(mod);
-    unsigned int max = mcsTable->getMaxIndex(mod);
-
-    // Initialize the working variables at the minimum value.
-    NRMCSelem ret = mcsTable->at(min);
-
-    // Search in the McsTable from min to max until the rate exceeds
-    // the coderate in an entry of the table.
-    for (unsigned int i = min; i <= max; i++) {
-        NRMCSelem elem = mcsTable->at(i);
-        if (elem.coderate_ <= rate)
-            ret = elem;
-        else
-            break;
-    }
-
-    // Return the MCSElem found.
-    return ret;
+    return mcsTable->getMcsElemPerCqi(cqi);
 }
 
 } //namespace
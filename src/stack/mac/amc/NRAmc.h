@@ -27,12 +27,43 @@ namespace simu5g {
  */
 class NRAmc : public LteAmc
 {
+    // symbols available to the current transmission, 0 for the whole slot
+    unsigned int symbolLimit_ = 0;
+
     unsigned int getSymbolsPerSlot(double carrierFrequency, Direction dir);
-    unsigned int getResourceElementsPerBlock(unsigned int symbolsPerSlot);
-    unsigned int getResourceElements(unsigned int blocks, unsigned int symbolsPerSlot);
-    unsigned int computeTbsFromNinfo(double nInfo, double coderate);
 
-    unsigned int computeCodewordTbs(UserTxParams *info, Codeword cw, Direction dir, unsigned int numRe);
+    /*
+     * TBS of every (CQI, layers, blocks) for one MCS table and one number of symbols per slot,
+     * at tbs[(cqi * layers + l - 1) * (blocks + 1) + b]
+     */
+    struct TbsTable
+    {
+        unsigned int layers = 0;
+        unsigned int blocks = 0;
+        std::vector<unsigned int> tbs;
+    };
+
+    static const unsigned int MAX_TABLE_BLOCKS = 4096;
+
+    // indexed by MCS table (0 for DL, 1 for UL and D2D), then by symbols per slot
+    std::vector<TbsTable> tbsTables_[2];
+
+    // (re)builds the table for at least the given layers and blocks
+    void buildTbsTable(Direction dir, unsigned int symbols, unsigned int layers, unsigned int blocks);
+
+    // TBS of a codeword, built on the first lookup of an unusual shape (e.g. mini-slots)
+    unsigned int lookupTbs(Direction dir, unsigned int symbols, Cqi cqi, unsigned int layers, unsigned int blocks)
+    {
+        // oversized requests are not worth a table
+        if (blocks > MAX_TABLE_BLOCKS)
+            return computeNrTbs(getMcsElemPerCqi(cqi, dir), layers, getNrResourceElements(blocks, symbols));
+
+        std::vector<TbsTable>& tables = tbsTables_[dir == DL ? 0 : 1];
+        if (symbols >= tables.size() || layers > tables[symbols].layers || blocks > tables[symbols].blocks)
+            buildTbsTable(dir, symbols, layers, blocks);
+        const TbsTable& table = tables[symbols];
+        return table.tbs[(cqi * table.layers + layers - 1) * (table.blocks + 1) + blocks];
+    }
 
   public:
 
@@ -48,6 +79,8 @@ class NRAmc : public LteAmc
     unsigned int computeBitsOnNRbs(MacNodeId id, Band b, Codeword cw, unsigned int blocks, const Direction dir, double carrierFrequency) override;
     unsigned int computeBitsPerRbBackground(Cqi cqi, const Direction dir, double carrierFrequency) override;
 
+    void setSymbolLimit(unsigned int symbols) override { symbolLimit_ = symbols; }
+
 };
 
 } //namespace
@@ -162,6 +162,117 @@ unsigned int NRMcsTable::getMaxIndex(LteMod mod)
     }
 }
 
+NRMCSelem NRMcsTable::getMcsElemPerCqi(Cqi cqi)
+{
+    CQIelem entry = getCqiElem(cqi);
+    LteMod mod = entry.mod_;
+    double rate = entry.rate_;
+
+    // Select the ranges for searching in the McsTable (extended reporting supported)
+    unsigned int min = getMinIndex(mod);
+    unsigned int max = getMaxIndex(mod);
+
+    // Initialize the working variables at the minimum value.
+    NRMCSelem ret = at(min);
+
+    // Search in the McsTable from min to max until the rate exceeds
+    // the coderate in an entry of the table.
+    for (unsigned int i = min; i <= max; i++) {
+        NRMCSelem elem = at(i);
+        if (elem.coderate_ <= rate)
+            ret = elem;
+        else
+            break;
+    }
+
+    // Return the MCSElem found.
+    return ret;
+}
+
+unsigned int getNrModulationOrder(LteMod mod)
+{
+    switch (mod) {
+        case _QPSK:   return 2;
+        case _16QAM:  return 4;
+        case _64QAM:  return 6;
+        case _256QAM: return 8;
+        default: throw cRuntimeError("getNrModulationOrder - unrecognized modulation.");
+    }
+}
+
+unsigned int getNrResourceElementsPerBlock(unsigned int symbolsPerSlot)
+{
+    unsigned int numSubcarriers = 12;   // TODO get this parameter from CellInfo/Carrier
+    unsigned int reSignal = 1;
+    unsigned int nOverhead = 0;
+
+    if (symbolsPerSlot == 0)
+        return 0;
+    return (numSubcarriers * symbolsPerSlot) - reSignal - nOverhead;
+}
+
+unsigned int getNrResourceElements(unsigned int blocks, unsigned int symbolsPerSlot)
+{
+    unsigned int numRePerBlock = getNrResourceElementsPerBlock(symbolsPerSlot);
+
+    if (numRePerBlock > 156)
+        return 156 * blocks;
+
+    return numRePerBlock * blocks;
+}
+
+unsigned int computeNrTbsFromNinfo(double nInfo, double coderate)
+{
+    unsigned int tbs = 0;
+    unsigned int _nInfo = 0;
+    unsigned int n = 0;
+    if (nInfo == 0)
+        return 0;
+
+    if (nInfo <= 3824) {
+        n = std::max((int)3, (int)(floor(log2(nInfo) - 6)));
+        _nInfo = std::max((unsigned int)24, (unsigned int)((1 << n) * floor(nInfo / (1 << n))));
+
+        // get tbs from table
+        unsigned int j = 0;
+        for (j = 0; j < TBSTABLESIZE - 1; j++) {
+            if (nInfoToTbs[j] >= _nInfo)
+                break;
+        }
+
+        tbs = nInfoToTbs[j];
+    }
+    else {
+        unsigned int C;
+        n = floor(log2(nInfo - 24) - 5);
+        _nInfo = (1 << n) * round((nInfo - 24) / (1 << n));
+        if (coderate <= 0.25) {
+            // at least one code block: the integer division is 0 for the shortest transport blocks
+            C = std::max(1u, (unsigned int)ceil((_nInfo + 24) / 3816));
+            tbs = 8 * C * ceil((_nInfo + 24) / (8 * C)) - 24;
+        }
+        else {
+            if (_nInfo >= 8424) {
+                C = ceil((_nInfo + 24) / 8424);
+                tbs = 8 * C * ceil((_nInfo + 24) / (8 * C)) - 24;
+            }
+            else {
+                tbs = 8 * ceil((_nInfo + 24) / 8) - 24;
+            }
+        }
+    }
+    return tbs;
+}
+
+unsigned int computeNrTbs(const NRMCSelem& mcsElem, unsigned int layers, unsigned int numRe)
+{
+    unsigned int modFactor = getNrModulationOrder(mcsElem.mod_);
+    double coderate = mcsElem.coderate_ / 1024;
+    double nInfo = numRe * coderate * modFactor * layers;
+
+    return computeNrTbsFromNinfo(floor(nInfo), coderate);
+}
+
 const unsigned int nInfoToTbs[TBSTABLESIZE] =
 {
     0, 24, 32, 40, 48, 56, 64, 72, 80, 88, 96, 104, 112, 120, 128, 136, 144, 152, 160, 168, 176, 184, 192, 208, 224, 240, 256, 272, 288, 304, 320,
@@ -59,6 +59,9 @@ class NRMcsTable
     unsigned int getMinIndex(LteMod mod);
     unsigned int getMaxIndex(LteMod mod);
 
+    /// Returns the entry with the highest code rate not exceeding the one of the given CQI
+    NRMCSelem getMcsElemPerCqi(Cqi cqi);
+
     /// MCS table seek operator
     NRMCSelem& at(Tbs tbs)
     {
@@ -70,6 +73,17 @@ class NRMcsTable
 const unsigned int TBSTABLESIZE = 94;
 extern const unsigned int nInfoToTbs[TBSTABLESIZE];
 
+/*
+ * TBS determination based on 3GPP TS 38.214 v15.6.0 (June 2019), section 5.1.3.2.
+ * These functions do not depend on the state of the AMC, so that they can
+ * also be used outside of a simulation (e.g. by offline analysis tools)
+ */
+unsigned int getNrModulationOrder(LteMod mod);
+unsigned int getNrResourceElementsPerBlock(unsigned int symbolsPerSlot);
+unsigned int getNrResourceElements(unsigned int blocks, unsigned int symbolsPerSlot);
+unsigned int computeNrTbsFromNinfo(double nInfo, double coderate);
+unsigned int computeNrTbs(const NRMCSelem& mcsElem, unsigned int layers, unsigned int numRe);
+
 } //namespace
 
 #endif
@@ -42,6 +42,7 @@ class UserTxParams
     Pmi pmi_;       // WB pmi
 
     std::set<Band> allowedBands_;     // bands on which the user can transmit
+    std::vector<bool> allowedBandMask_; // allowedBands_ indexed by band, for constant-time lookups
 
     bool isValid_; // indicates whether the user info is set
 
@@ -59,6 +60,7 @@ class UserTxParams
         this->cqiVector_ = other.cqiVector_;
         this->pmi_ = other.pmi_;
         this->allowedBands_ = other.allowedBands_;
+        this->allowedBandMask_ = other.allowedBandMask_;
         this->isValid_ = other.isValid_;
         this->antennaSet_ = other.antennaSet_;
         return *this;
@@ -91,6 +93,7 @@ class UserTxParams
     {
         cqiVector_.clear();
         allowedBands_.clear();
+        allowedBandMask_.clear();
 
         txMode_ = SINGLE_ANTENNA_PORT0;
         ri_ = NORANK;
@@ -139,6 +142,12 @@ class UserTxParams
         return allowedBands_;
     }
 
+    //! Tell whether the user can transmit on the given band.
+    bool isBandAllowed(Band b) const
+    {
+        return b < allowedBandMask_.size() && allowedBandMask_[b];
+    }
+
     //! Get the remote antenna set - DAS
     const std::set<Remote>& readAntennaSet() const
     {
@@ -179,6 +188,9 @@ class UserTxParams
     void writeBands(const std::set<Band>& bands)
     {
         allowedBands_ = bands;
+        allowedBandMask_.assign(bands.empty() ? 0 : *bands.rbegin() + 1, false);
+        for (Band b : bands)
+            allowedBandMask_[b] = true;
     }
 
     /** Get the modulation of the codeword. This function does not check if codeword is set.
@@ -207,6 +219,15 @@ class UserTxParams
         return cwMapping(txMode_, ri_, ri_);
     }
 
+    /** Gives the number of layers for each codeword, without allocation.
+     *  @param layers Filled with the number of layers of each codeword.
+     *  @return The number of codewords.
+     */
+    unsigned int readLayers(unsigned char layers[MAX_CODEWORDS]) const
+    {
+        return cwMapping(txMode_, ri_, ri_, layers);
+    }
+
     /** Print debug information - FOR DEBUG ONLY
      *  @param s The name of the invoking function.
      */
@@ -0,0 +1,192 @@
+//
+//                  Simu5G-NR-EDF (Extension of Simu5G)
+//
+// Original Authors: Giovanni Nardini, Giovanni Stea, Antonio Virdis (University of Pisa)
+// Extension Authors: Alaf Nascimento, Philippe Martins, Samuel Tardieu, Laurent Pautet (Institut Polytechnique de Paris)
+//
+// This file is part of a software released under the license included in file
+// "license.pdf". Please read LICENSE and README files before using it.
+// The above files and the present reference are part of the software itself,
+// and cannot be removed from it.
+//
+
+#include "stack/mac/buffer/MacPduMetaDataStore.h"
+#include "common/qos_data.h"
+
+namespace simu5g {
+
+using namespace omnetpp;
+
+simtime_t MacPduMetaDataStore::computeDeadline(const MacPduMetaData& meta)
+{
+    const auto& params = get_qos_parameters(meta.fiveQi);
+    if (params.fiveQI == 0 || params.packet_delay_budget <= 0)
+        return SIMTIME_MAX;
+
+    // packet delay budget is expressed in milliseconds
+    return meta.arrivalTime + SimTime(params.packet_delay_budget, SIMTIME_MS);
+}
+
+MacPduMetaDataStore::HeapElem MacPduMetaDataStore::makeHeapElem(MacCid cid, const Entry& entry)
+{
+    const auto& params = get_qos_parameters(entry.meta.fiveQi);
+    switch (params.resource_type) {
+        case qos_data::DCGBR:
+            return {0, entry.deadline.dbl(), cid, entry.seq};
+        case qos_data::GBR:
+            return {1, params.packet_error_rate_exp, cid, entry.seq};
+        case qos_data::NGBR:
+            return {2, params.default_priority_level, cid, entry.seq};
+        default:
+            return {3, 0.0, cid, entry.seq};
+    }
+}
+
+bool MacPduMetaDataStore::isValid(const HeapElem& elem) const
+{
+    auto it = fifos_.find(elem.cid);
+    return it != fifos_.end() && !it->second.empty() && it->second.front().seq == elem.seq;
+}
+
+void MacPduMetaDataStore::skipStale()
+{
+    while (!heap_.empty() && !isValid(heap_.top()))
+        heap_.pop();
+}
+
+void MacPduMetaDataStore::compact()
+{
+    if (heap_.size() <= 2 * activeFifos_ + 64)
+        return;
+
+    std::vector<HeapElem> valid;
+    valid.reserve(activeFifos_);
+    for (const auto& [cid, fifo] : fifos_) {
+        if (!fifo.empty())
+            valid.push_back(makeHeapElem(cid, fifo.front()));
+    }
+    heap_ = DeadlineHeap(std::greater<HeapElem>(), std::move(valid));
+}
+
+void MacPduMetaDataStore::pushHead(MacCid cid, const Entry& head)
+{
+    heap_.push(makeHeapElem(cid, head));
+    if (skipped_.empty())
+        compact();
+}
+
+void MacPduMetaDataStore::push(const MacPduMetaData& meta)
+{
+    Entry entry = {meta, computeDeadline(meta), nextSeq_++};
+
+    EntryFifo& fifo = fifos_[meta.cid];
+    fifo.push_back(entry);
+    size_++;
+
+    // a new head-of-line entry: its deadline enters the heap
+    if (fifo.size() == 1) {
+        activeFifos_++;
+        pushHead(meta.cid, entry);
+    }
+}
+
+const MacPduMetaDataStore::Entry *MacPduMetaDataStore::front(MacCid cid) const
+{
+    auto it = fifos_.find(cid);
+    if (it == fifos_.end() || it->second.empty())
+        return nullptr;
+    return &it->second.front();
+}
+
+void MacPduMetaDataStore::popFront(MacCid cid)
+{
+    auto it = fifos_.find(cid);
+    if (it == fifos_.end() || it->second.empty())
+        return;
+
+    EntryFifo& fifo = it->second;
+    fifo.pop_front();
+    size_--;
+
+    // the previous heap element of this connection is now stale
+    if (fifo.empty())
+        activeFifos_--;
+    else
+        pushHead(cid, fifo.front());
+}
+
+const MacPduMetaDataStore::EntryFifo *MacPduMetaDataStore::entries(MacCid cid) const
+{
+    auto it = fifos_.find(cid);
+    if (it == fifos_.end() || it->second.empty())
+        return nullptr;
+    return &it->second;
+}
+
+const MacPduMetaDataStore::Entry *MacPduMetaDataStore::top()
+{
+    skipStale();
+    if (heap_.empty())
+        return nullptr;
+    return front(heap_.top().cid);
+}
+
+void MacPduMetaDataStore::popTop()
+{
+    skipStale();
+    if (heap_.empty())
+        return;
+    MacCid cid = heap_.top().cid;
+    heap_.pop();
+    popFront(cid);
+}
+
+void MacPduMetaDataStore::skipTop()
+{
+    skipStale();
+    if (heap_.empty())
+        return;
+    skipped_.push_back(heap_.top());
+    heap_.pop();
+}
+
+void MacPduMetaDataStore::restoreSkipped()
+{
+    for (const HeapElem& elem : skipped_)
+        heap_.push(elem);
+    skipped_.clear();
+}
+
+void MacPduMetaDataStore::erase(MacCid cid)
+{
+    auto it = fifos_.find(cid);
+    if (it == fifos_.end() || it->second.empty())
+        return;
+
+    size_ -= it->second.size();
+    activeFifos_--;
+    it->second.clear();
+}
+
+void MacPduMetaDataStore::eraseNode(MacNodeId nodeId)
+{
+    for (auto it = fifos_.begin(); it != fifos_.end();) {
+        if (MacCidToNodeId(it->first) == nodeId) {
+            if (!it->second.empty()) {
+                size_ -= it->second.size();
+                activeFifos_--;
+            }
+            it = fifos_.erase(it);
+        }
+        else
+            ++it;
+    }
+}
+
+unsigned int MacPduMetaDataStore::size(MacCid cid) const
+{
+    auto it = fifos_.find(cid);
+    return (it == fifos_.end()) ? 0 : it->second.size();
+}
+
+} //namespace
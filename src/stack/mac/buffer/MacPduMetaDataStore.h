@@ -0,0 +1,179 @@
+//
+//                  Simu5G-NR-EDF (Extension of Simu5G)
+//
+// Original Authors: Giovanni Nardini, Giovanni Stea, Antonio Virdis (University of Pisa)
+// Extension Authors: Alaf Nascimento, Philippe Martins, Samuel Tardieu, Laurent Pautet (Institut Polytechnique de Paris)
+//
+// This file is part of a software released under the license included in file
+// "license.pdf". Please read LICENSE and README files before using it.
+// The above files and the present reference are part of the software itself,
+// and cannot be removed from it.
+//
+
+#ifndef _LTE_MACPDUMETADATASTORE_H_
+#define _LTE_MACPDUMETADATASTORE_H_
+
+#include <omnetpp.h>
+#include <unordered_map>
+#include <queue>
+#include "common/LteCommon.h"
+#include "common/RingBuffer.h"
+
+namespace simu5g {
+
+using namespace omnetpp;
+
+/**
+ * @class MacPduMetaDataStore
+ * @brief Per-connection index of the MAC PDU metadata used by deadline-based schedulers
+ *
+ * Metadata are kept in one FIFO per MacCid, in arrival order. A min-heap
+ * holds the head-of-line entry of every non-empty FIFO, so that the most urgent
+ * entry of the whole cell is found without scanning all the connections.
+ * The heap follows the NR-EDF ordering: DC-GBR entries come first, sorted by
+ * absolute deadline (arrival time + 5QI packet delay budget), then GBR entries
+ * sorted by packet error rate, then non-GBR entries sorted by priority level.
+ *
+ * Heap entries are invalidated lazily: an entry is valid only while it refers
+ * to the current head of its FIFO. The heap persists across TTIs, so a
+ * scheduler can walk it from the top (skipTop()/restoreSkipped()) and only
+ * touch the connections it actually serves. Entries leave the store when
+ * their SDU is fully granted (LteSchedulerEnb::scheduleGrant), dropped
+ * (edfDropExpired) or when their connection becomes inactive.
+ */
+class MacPduMetaDataStore
+{
+  public:
+    struct Entry
+    {
+        MacPduMetaData meta;
+        /// absolute deadline. SIMTIME_MAX for 5QIs without a packet delay budget
+        simtime_t deadline;
+        /// insertion sequence number, unique within the store
+        uint64_t seq;
+    };
+
+    typedef RingBuffer<Entry> EntryFifo;
+
+  protected:
+    struct HeapElem
+    {
+        /// resource type rank: 0 DC-GBR, 1 GBR, 2 non-GBR, 3 unknown 5QI
+        unsigned char rank;
+        /// ordering key within the rank (lower is more urgent)
+        double key;
+        MacCid cid;
+        uint64_t seq;
+
+        bool operator>(const HeapElem& other) const
+        {
+            if (rank != other.rank)
+                return rank > other.rank;
+            if (key != other.key)
+                return key > other.key;
+            return seq > other.seq; // FIFO among equal keys
+        }
+    };
+
+    typedef std::priority_queue<HeapElem, std::vector<HeapElem>, std::greater<HeapElem>> DeadlineHeap;
+
+    /// per-connection FIFOs
+    std::unordered_map<MacCid, EntryFifo> fifos_;
+
+    /// head-of-line entries of non-empty FIFOs (may contain stale elements)
+    DeadlineHeap heap_;
+
+    /// total number of stored entries
+    unsigned int size_ = 0;
+
+    /// number of non-empty FIFOs
+    unsigned int activeFifos_ = 0;
+
+    /// next sequence number
+    uint64_t nextSeq_ = 0;
+
+    /// valid elements removed from the heap by skipTop()
+    std::vector<HeapElem> skipped_;
+
+    static HeapElem makeHeapElem(MacCid cid, const Entry& entry);
+
+    bool isValid(const HeapElem& elem) const;
+
+    /// removes stale elements from the top of the heap
+    void skipStale();
+
+    /// rebuilds the heap when stale elements outnumber valid ones
+    void compact();
+
+    void pushHead(MacCid cid, const Entry& head);
+
+  public:
+    MacPduMetaDataStore() {}
+
+    /**
+     * Computes the absolute deadline of a PDU from its 5QI
+     */
+    static simtime_t computeDeadline(const MacPduMetaData& meta);
+
+    /**
+     * Appends a metadata entry to the FIFO of its connection
+     */
+    void push(const MacPduMetaData& meta);
+
+    /**
+     * Returns the oldest entry of the given connection, nullptr if none
+     */
+    const Entry *front(MacCid cid) const;
+
+    /**
+     * Removes the oldest entry of the given connection
+     */
+    void popFront(MacCid cid);
+
+    /**
+     * Returns all the entries of the given connection, in arrival order, nullptr if none
+     */
+    const EntryFifo *entries(MacCid cid) const;
+
+    /**
+     * Returns the most urgent head-of-line entry among all connections,
+     * nullptr if the store is empty
+     */
+    const Entry *top();
+
+    /**
+     * Removes the entry returned by top()
+     */
+    void popTop();
+
+    /**
+     * Hides the entry returned by top(), so that top() returns the next most urgent
+     * connection. Hidden entries come back with restoreSkipped()
+     */
+    void skipTop();
+
+    /**
+     * Restores the entries hidden by skipTop(), at the end of the scheduling walk.
+     * push() and popFront() may be called during the walk, e.g. when a grant serves
+     * the head of a connection: hidden entries made stale meanwhile are dropped later
+     */
+    void restoreSkipped();
+
+    /**
+     * Removes all the entries of the given connection
+     */
+    void erase(MacCid cid);
+
+    /**
+     * Removes all the entries of the connections belonging to the given node
+     */
+    void eraseNode(MacNodeId nodeId);
+
+    unsigned int size() const { return size_; }
+    unsigned int size(MacCid cid) const;
+    bool empty() const { return size_ == 0; }
+};
+
+} //namespace
+
+#endif // _LTE_MACPDUMETADATASTORE_H_
@@ -236,6 +236,11 @@ bool LteHarqProcessTx::isUnitMarked(Codeword cw)
     return units_[cw]->isMarked();
 }
 
+void LteHarqProcessTx::markPunctured(Codeword cw)
+{
+    units_[cw]->markPunctured();
+}
+
 bool LteHarqProcessTx::isDropped()
 {
     return dropped_;
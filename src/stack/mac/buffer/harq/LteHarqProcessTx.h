@@ -179,6 +179,7 @@ class LteHarqProcessTx : noncopyable
     int64_t getPduLength(Codeword cw);
     simtime_t getTxTime(Codeword cw);
     bool isUnitMarked(Codeword cw);
+    void markPunctured(Codeword cw);
     bool isDropped();
 
     /**
@@ -111,6 +111,12 @@ bool LteHarqUnitTx::pduFeedback(HarqAcknowledgment a)
     if (!(status_ == TXHARQ_PDU_WAITING))
         throw cRuntimeError("Feedback sent to an H-ARQ unit not waiting for it");
 
+    if (punctured_ && a == HARQACK) {
+        EV << "\t pdu_ has been punctured by a preempting transmission, handled as NACK " << endl;
+        a = HARQNACK;
+    }
+    punctured_ = false;
+
     if (a == HARQACK) {
         // pdu_ has been sent and received correctly
         EV << "\t pdu_ has been sent and received correctly " << endl;
@@ -261,6 +267,7 @@ void LteHarqUnitTx::resetUnit()
 
     status_ = TXHARQ_PDU_EMPTY;
     pduLength_ = 0;
+    punctured_ = false;
 }
 
 } //namespace
@@ -65,6 +65,9 @@ class LteHarqUnitTx : noncopyable
     /// TTI at which the pdu has been transmitted
     simtime_t txTime_;
 
+    /// true if part of the transmission has been preempted, so that it cannot be acknowledged
+    bool punctured_ = false;
+
     // reference to the eNB module
     opp_component_ptr<cModule> nodeB_;
 
@@ -158,6 +161,12 @@ class LteHarqUnitTx : noncopyable
 
     virtual void forceDropUnit();
 
+    /**
+     * Marks the transmission as punctured by a preempting transmission: the next
+     * feedback is handled as a NACK, so that the pdu is retransmitted
+     */
+    virtual void markPunctured() { punctured_ = true; }
+
     virtual Packet *getPdu();
 
     virtual unsigned char getAcid()
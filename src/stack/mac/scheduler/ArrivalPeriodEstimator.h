@@ -0,0 +1,82 @@
+//
+//                  Simu5G-NR-EDF (Extension of Simu5G)
+//
+// Original Authors: Giovanni Nardini, Giovanni Stea, Antonio Virdis (University of Pisa)
+// Extension Authors: Alaf Nascimento, Philippe Martins, Samuel Tardieu, Laurent Pautet (Institut Polytechnique de Paris)
+//
+// This file is part of a software released under the license included in file
+// "license.pdf". Please read LICENSE and README files before using it.
+// The above files and the present reference are part of the software itself,
+// and cannot be removed from it.
+//
+
+#ifndef _LTE_ARRIVALPERIODESTIMATOR_H_
+#define _LTE_ARRIVALPERIODESTIMATOR_H_
+
+#include <cmath>
+#include <omnetpp.h>
+
+namespace simu5g {
+
+using namespace omnetpp;
+
+/**
+ * @class ArrivalPeriodEstimator
+ * @brief Detects flows whose data arrive at a stable interval
+ *
+ * A flow is considered periodic once PERIODIC_HITS consecutive inter-arrival
+ * times stay within a quarter of the previous one.
+ */
+class ArrivalPeriodEstimator
+{
+  public:
+    /// consecutive matching intervals after which a flow is considered periodic
+    static const unsigned int PERIODIC_HITS = 2;
+
+  protected:
+    /// (estimated) arrival time of the last data, negative if none
+    simtime_t lastArrival_ = -1;
+
+    /// interval between the last two arrivals
+    simtime_t period_ = 0;
+
+    /// number of consecutive intervals matching the period
+    unsigned int hits_ = 0;
+
+  public:
+    /**
+     * Records an observed arrival
+     */
+    void update(simtime_t arrival)
+    {
+        if (lastArrival_ >= 0) {
+            simtime_t interval = arrival - lastArrival_;
+            if (period_ > 0 && std::fabs((interval - period_).dbl()) <= period_.dbl() / 4)
+                hits_++;
+            else
+                hits_ = 0;
+            period_ = interval;
+        }
+        lastArrival_ = arrival;
+    }
+
+    /**
+     * Records an arrival predicted from the period, leaving the period unchanged
+     */
+    void predict(simtime_t arrival) { lastArrival_ = arrival; }
+
+    /**
+     * Forgets the periodicity, e.g. when predictions turned out to be wrong
+     */
+    void reset() { hits_ = 0; }
+
+    bool isPeriodic() const { return hits_ >= PERIODIC_HITS && period_ > 0; }
+    simtime_t getPeriod() const { return period_; }
+    unsigned int getHits() const { return hits_; }
+    simtime_t getLastArrival() const { return lastArrival_; }
+    simtime_t getNextArrival() const { return lastArrival_ + period_; }
+};
+
+} //namespace
+
+#endif // _LTE_ARRIVALPERIODESTIMATOR_H_
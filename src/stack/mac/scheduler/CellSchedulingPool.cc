@@ -0,0 +1,133 @@
+//
+//                  Simu5G-NR-EDF (Extension of Simu5G)
+//
+// Original Authors: Giovanni Nardini, Giovanni Stea, Antonio Virdis (University of Pisa)
+// Extension Authors: Alaf Nascimento, Philippe Martins, Samuel Tardieu, Laurent Pautet (Institut Polytechnique de Paris)
+//
+// This file is part of a software released under the license included in file
+// "license.pdf". Please read LICENSE and README files before using it.
+// The above files and the present reference are part of the software itself,
+// and cannot be removed from it.
+//
+
+#include "stack/mac/scheduler/CellSchedulingPool.h"
+#include "stack/mac/LteMacEnb.h"
+
+namespace simu5g {
+
+thread_local std::mt19937_64 *CellSchedulingPool::currentRng_ = nullptr;
+
+CellSchedulingPool::CellSchedulingPool(cSimulation *simulation, unsigned int threads) : simulation_(simulation)
+{
+    // the simulation thread is one of the threads
+    for (unsigned int i = 1; i < threads; i++)
+        workers_.emplace_back(&CellSchedulingPool::workerLoop, this);
+}
+
+CellSchedulingPool::~CellSchedulingPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    workReady_.notify_all();
+    for (auto& worker : workers_)
+        worker.join();
+}
+
+bool CellSchedulingPool::add(LteMacEnb *mac)
+{
+    auto it = rngs_.find(mac);
+    if (it == rngs_.end())
+        it = rngs_.emplace(mac, std::mt19937_64(intuniform(getEnvir()->getRNG(0), 0, INT_MAX))).first;
+
+    tasks_.push_back({mac, &it->second});
+    return tasks_.size() == 1;
+}
+
+void CellSchedulingPool::workerLoop()
+{
+    // NOW, the modules and the parameters are reached through the active simulation
+    cSimulation::setActiveSimulation(simulation_);
+
+    unsigned int generation = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            workReady_.wait(lock, [&] { return stop_ || generation_ != generation; });
+            if (stop_)
+                return;
+            generation = generation_;
+        }
+
+        runTasks();
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (--running_ == 0)
+            workDone_.notify_one();
+    }
+}
+
+void CellSchedulingPool::runTasks()
+{
+    size_t i;
+    while ((i = next_.fetch_add(1)) < tasks_.size()) {
+        currentRng_ = tasks_[i].rng;
+        try {
+            tasks_[i].mac->scheduleDownlink();
+        }
+        catch (...) {
+            errors_[i] = std::current_exception();
+        }
+        currentRng_ = nullptr;
+    }
+}
+
+void CellSchedulingPool::run()
+{
+    errors_.assign(tasks_.size(), nullptr);
+
+    // the log is not thread-safe
+    LogLevel logLevel = cLog::logLevel;
+    if (!workers_.empty())
+        cLog::logLevel = LOGLEVEL_OFF;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        next_ = 0;
+        running_ = workers_.size();
+        ++generation_;
+    }
+    workReady_.notify_all();
+
+    runTasks();
+
+    // wait for all the workers to leave the tasks, so that the next barrier starts afresh
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        workDone_.wait(lock, [&] { return running_ == 0; });
+    }
+    cLog::logLevel = logLevel;
+
+    std::vector<Task> tasks;
+    tasks.swap(tasks_);
+    for (auto& error : errors_) {
+        if (error != nullptr)
+            std::rethrow_exception(error);
+    }
+
+    // completion in tick order
+    for (auto& task : tasks)
+        task.mac->endDownlinkScheduling();
+}
+
+double CellSchedulingPool::uniform(double a, double b)
+{
+    if (currentRng_ == nullptr)
+        return omnetpp::uniform(getEnvir()->getRNG(0), a, b);
+
+    // 53 random bits, as a double in [0,1)
+    return a + (b - a) * ((*currentRng_)() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+} //namespace
@@ -0,0 +1,126 @@
+//
+//                  Simu5G-NR-EDF (Extension of Simu5G)
+//
+// Original Authors: Giovanni Nardini, Giovanni Stea, Antonio Virdis (University of Pisa)
+// Extension Authors: Alaf Nascimento, Philippe Martins, Samuel Tardieu, Laurent Pautet (Institut Polytechnique de Paris)
+//
+// This file is part of a software released under the license included in file
+// "license.pdf". Please read LICENSE and README files before using it.
+// The above files and the present reference are part of the software itself,
+// and cannot be removed from it.
+//
+
+#ifndef _LTE_CELLSCHEDULINGPOOL_H_
+#define _LTE_CELLSCHEDULINGPOOL_H_
+
+#include <atomic>
+#include <climits>
+#include <condition_variable>
+#include <exception>
+#include <map>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include <omnetpp.h>
+
+namespace simu5g {
+
+using namespace omnetpp;
+
+class LteMacEnb;
+
+/**
+ * Runs the downlink schedulers of the cells due in the same slot on a pool of threads.
+ *
+ * With parallel scheduling enabled (Binder parameter "schedulingThreads"), the slot tick of each
+ * eNB/gNB only queues its downlink scheduling here (see LteMacEnb::handleSelfMessage()). The Binder
+ * then runs the queued cells in one barrier event, after all the slot ticks of that time and before
+ * the HARQ buffers are flushed:
+ *  - the LteSchedulerEnb::schedule() calls run concurrently, each cell only touching its own MAC,
+ *    scheduler, allocator and AMC. Logging is suppressed, statistics are buffered by the scheduler
+ *    and random draws come from a generator owned by the cell (see uniform());
+ *  - the cells are then completed one at a time, in the order their ticks were executed: buffered
+ *    statistics are emitted and the SDUs are requested to the RLC.
+ * Since no decision depends on the interleaving of the threads, results do not depend on the number
+ * of threads, and a single thread gives the same results as sixteen. Background UEs are refused at
+ * initialization (LteMacEnb): every grant updates their traffic generators, which are modules that
+ * emit signals, draw from their RNG and schedule events.
+ */
+class CellSchedulingPool
+{
+  protected:
+    struct Task
+    {
+        LteMacEnb *mac;
+        std::mt19937_64 *rng;
+    };
+
+    /// simulation the workers run in
+    cSimulation *simulation_;
+
+    std::vector<std::thread> workers_;
+
+    /// cells queued for the next barrier, in tick order
+    std::vector<Task> tasks_;
+
+    /// error raised by each task, rethrown by run() in task order
+    std::vector<std::exception_ptr> errors_;
+
+    /// random generator of each cell, seeded from RNG 0 when the cell is first queued
+    std::map<LteMacEnb *, std::mt19937_64> rngs_;
+
+    std::mutex mutex_;
+    std::condition_variable workReady_;
+    std::condition_variable workDone_;
+
+    /// index of the next task to run
+    std::atomic<size_t> next_{0};
+
+    /// incremented at each barrier to wake up the workers
+    unsigned int generation_ = 0;
+
+    /// number of workers still running tasks of the current barrier
+    unsigned int running_ = 0;
+
+    bool stop_ = false;
+
+    /// generator of the cell scheduled by this thread, nullptr out of the parallel phase
+    static thread_local std::mt19937_64 *currentRng_;
+
+    void workerLoop();
+
+    /// runs queued tasks until none is left
+    void runTasks();
+
+  public:
+    /**
+     * @param threads number of threads scheduling the cells, including the simulation thread
+     */
+    CellSchedulingPool(cSimulation *simulation, unsigned int threads);
+
+    ~CellSchedulingPool();
+
+    /**
+     * Queues the downlink scheduling of the cell for the next barrier.
+     *
+     * @return true if this is the first cell queued for the barrier
+     */
+    bool add(LteMacEnb *mac);
+
+    /**
+     * Schedules the queued cells, then completes them in tick order.
+     */
+    void run();
+
+    /**
+     * Uniform draw for the scheduling decisions: from the generator of the cell being scheduled
+     * by the pool, from RNG 0 otherwise.
+     */
+    static double uniform(double a, double b);
+};
+
+} //namespace
+
+#endif
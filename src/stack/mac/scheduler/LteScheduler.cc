@@ -25,6 +25,47 @@ void LteScheduler::setEnbScheduler(LteSchedulerEnb *eNbScheduler)
     mac_ = eNbScheduler_->mac_;
 }
 
+bool LteScheduler::readConnectionView(MacCid cid, ConnectionView& view)
+{
+    MacNodeId nodeId = MacCidToNodeId(cid);
+
+    // if we are allocating the UL subframe, this connection may be either UL or D2D
+    Direction dir;
+    if (direction_ == UL)
+        dir = (MacCidToLcid(cid) == D2D_SHORT_BSR) ? D2D : (MacCidToLcid(cid) == D2D_MULTI_SHORT_BSR) ? D2D_MULTI : direction_;
+    else
+        dir = DL;
+
+    const UserTxParams& info = mac_->getAmc()->computeTxParams(nodeId, dir, carrierFrequency_);
+    unsigned int codeword = info.getLayers().size();
+    if (eNbScheduler_->allocatedCws(nodeId, carrierFrequency_) == codeword)
+        return false;
+    for (unsigned int i = 0; i < codeword; i++) {
+        if (info.readCqiVector()[i] == 0)
+            return false;
+    }
+
+    view.cid = cid;
+    view.nodeId = nodeId;
+    view.dir = dir;
+    view.txParams = &info;
+    view.availableBytes = 0;
+    view.availableBlocks = 0;
+    for (auto antenna : info.readAntennaSet()) {
+        for (Band band : info.readBands()) {
+            unsigned int blocks = eNbScheduler_->readAvailableRbs(nodeId, antenna, band);
+            view.availableBlocks += blocks;
+            view.availableBytes += mac_->getAmc()->computeBytesOnNRbs(nodeId, band, blocks, dir, carrierFrequency_);
+        }
+    }
+    return true;
+}
+
+void LteScheduler::emitStatistic(simsignal_t signal, double value)
+{
+    eNbScheduler_->emitStatistic(signal, value);
+}
+
 void LteScheduler::setCarrierFrequency(double carrierFrequency)
 {
     carrierFrequency_ = carrierFrequency;
@@ -152,7 +193,7 @@ bool LteScheduler::scheduleRacRequests()
 void LteScheduler::schedule()
 {
     activeConnectionSet_ = eNbScheduler_->readActiveConnections();
-    macPduMetaDataSet_ = eNbScheduler_->readMacPduMetaDataList(); // alaf
+    macPduMetaDataStore_ = eNbScheduler_->readMacPduMetaDataStore(); // alaf
 
     // obtain the list of cids that can be scheduled on this carrier
     buildCarrierActiveConnectionSet();
@@ -169,9 +210,11 @@ void LteScheduler::buildCarrierActiveConnectionSet()
     // put in the activeConnectionSet only connections that are active
     // and whose UE is enabled to use this carrier
 
+    // connections served by their configured grant are left out of dynamic scheduling
+
     const UeSet& carrierUeSet = binder_->getCarrierUeSet(carrierFrequency_);
     for (auto& activeConnection : *activeConnectionSet_) {
-        if (carrierUeSet.find(MacCidToNodeId(activeConnection)) != carrierUeSet.end())
+        if (carrierUeSet.find(MacCidToNodeId(activeConnection)) != carrierUeSet.end() && !eNbScheduler_->isCoveredByConfiguredGrant(activeConnection))
             carrierActiveConnectionSet_.insert(activeConnection);
     }
 }
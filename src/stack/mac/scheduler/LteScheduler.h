@@ -15,6 +15,8 @@
 
 #include "common/LteCommon.h"
 #include "stack/mac/LteMacEnb.h"
+#include "stack/mac/buffer/MacPduMetaDataStore.h"
+#include "stack/mac/scheduler/CellSchedulingPool.h"
 
 namespace simu5g
 {
@@ -41,7 +43,7 @@ namespace simu5g
       if (score_ < y.score_)
         return true;
       if (score_ == y.score_)
-        return uniform(getEnvir()->getRNG(0), 0, 1) < 0.5;
+        return CellSchedulingPool::uniform(0, 1) < 0.5;
       return false;
     }
 
@@ -55,6 +57,21 @@ namespace simu5g
     }
   };
 
+  /**
+   * What a scheduling metric knows about a connection when scoring it.
+   */
+  struct ConnectionView
+  {
+    MacCid cid;
+    MacNodeId nodeId;
+    /// DL, UL, D2D or D2D_MULTI
+    Direction dir;
+    const UserTxParams *txParams;
+    /// bytes and blocks the connection could get on the free blocks of the carrier
+    unsigned int availableBytes;
+    unsigned int availableBlocks;
+  };
+
   /**
    * @class LteScheduler
    */
@@ -79,11 +96,11 @@ namespace simu5g
     //! General Active set. Temporary variable used in the two-phase scheduling operations
     ActiveSet activeConnectionTempSet_;
 
-    //! Set of MacPduMetaData
-    MacPduMetaDataList *macPduMetaDataSet_ = {};
+    //! Per-connection MacPduMetaData store
+    MacPduMetaDataStore *macPduMetaDataStore_ = nullptr;
 
-    // Temporary list for storing MacPduMetaData during scheduling
-    MacPduMetaDataList macPduMetaDataTempSet_;
+    //! Connections whose MacPduMetaData must be dropped. Temporary variable used in the two-phase scheduling operations
+    std::vector<MacCid> macPduMetaDataTempErase_;
 
     //! Per-carrier Active set. Temporary variable used for storing the set of connections allowed in this carrier
     ActiveSet carrierActiveConnectionSet_;
@@ -164,6 +181,7 @@ namespace simu5g
      * Set the numerology index for this scheduler
      */
     void setNumerologyIndex(unsigned int numerologyIndex) { numerologyIndex_ = numerologyIndex; }
+    unsigned int getNumerologyIndex() { return numerologyIndex_; }
 
     // Scheduling functions ********************************************************************
 
@@ -219,6 +237,19 @@ namespace simu5g
      * Used by scheduling modules
      */
     void buildCarrierActiveConnectionSet();
+
+    /*
+     * Fills the view of a connection: direction, transmission parameters and bytes/blocks it could get
+     * on the free blocks of the carrier. Returns false if the connection cannot be served in this slot
+     * (no codeword left, or null CQI)
+     */
+    bool readConnectionView(MacCid cid, ConnectionView &view);
+
+    /*
+     * Emits a statistic of the scheduling period through LteSchedulerEnb, which defers it if the
+     * downlink is scheduled in parallel
+     */
+    void emitStatistic(simsignal_t signal, double value);
   };
 
 } // namespace
@@ -13,7 +13,9 @@
 #include "stack/mac/scheduler/LteSchedulerEnb.h"
 #include "stack/mac/allocator/LteAllocationModule.h"
 #include "stack/mac/allocator/LteAllocationModuleFrequencyReuse.h"
+#include "stack/mac/allocator/LteAllocationModuleBitset.h"
 #include "stack/mac/scheduler/LteScheduler.h"
+#include "stack/mac/scheduler/LteSchedulerFactory.h"
 #include "stack/mac/scheduling_modules/LteDrr.h"
 #include "stack/mac/scheduling_modules/LteMaxCi.h"
 #include "stack/mac/scheduling_modules/LtePf.h"
@@ -25,6 +27,8 @@
 #include "stack/mac/buffer/LteMacBuffer.h"
 #include "stack/mac/buffer/LteMacQueue.h"
 #include "stack/phy/LtePhyBase.h"
+#include "common/qos_data.h"
+#include <algorithm>
 
 namespace simu5g
 {
@@ -34,6 +38,8 @@ namespace simu5g
     // Initialize statistics
     simsignal_t LteSchedulerEnb::avgServedBlocksDlSignal_ = cComponent::registerSignal("avgServedBlocksDl");
     simsignal_t LteSchedulerEnb::avgServedBlocksUlSignal_ = cComponent::registerSignal("avgServedBlocksUl");
+    simsignal_t LteSchedulerEnb::expiredSduDropDlSignal_ = cComponent::registerSignal("expiredSduDropDl");
+    simsignal_t LteSchedulerEnb::miniSlotPreemptedBlocksDlSignal_ = cComponent::registerSignal("miniSlotPreemptedBlocksDl");
 
     LteSchedulerEnb::LteSchedulerEnb() : mac_(nullptr)
     {
@@ -51,12 +57,22 @@ namespace simu5g
         activeConnectionSet_ = other.activeConnectionSet_;
         scheduleList_ = other.scheduleList_;
         allocatedCws_ = other.allocatedCws_;
+        carrierAllocatedCws_ = other.carrierAllocatedCws_;
         vbuf_ = other.vbuf_;
         bsrbuf_ = other.bsrbuf_;
         harqTxBuffers_ = other.harqTxBuffers_;
         harqRxBuffers_ = other.harqRxBuffers_;
         resourceBlocks_ = other.resourceBlocks_;
-        macPduMetaDataSet_ = other.macPduMetaDataSet_; // alaf
+        macPduMetaDataStore_ = other.macPduMetaDataStore_; // alaf
+        dropExpiredPdus_ = other.dropExpiredPdus_;
+        edfCrossCarrier_ = other.edfCrossCarrier_;
+        configuredGrant_ = other.configuredGrant_;
+        configuredGrants_ = other.configuredGrants_;
+        miniSlotPreemption_ = other.miniSlotPreemption_;
+        slotNodes_ = other.slotNodes_;
+        preemptable_ = other.preemptable_;
+        parallel_ = other.parallel_;
+        connectionFiveQi_ = other.connectionFiveQi_;
         emptyBandLim_ = other.emptyBandLim_;
 
         // Copy schedulers
@@ -75,10 +91,8 @@ namespace simu5g
         }
 
         // Copy Allocator
-        if (discipline == ALLOCATOR_BESTFIT) // NOTE: create this type of allocator for every scheduler using Frequency Reuse
-            allocator_ = new LteAllocationModuleFrequencyReuse(mac_, direction_);
-        else
-            allocator_ = new LteAllocationModule(mac_, direction_);
+        bitsetAllocator_ = other.bitsetAllocator_;
+        createAllocator(discipline);
 
         return *this;
     }
@@ -103,8 +117,15 @@ namespace simu5g
         harqTxBuffers_ = mac_->getHarqTxBuffers();
         harqRxBuffers_ = mac_->getHarqRxBuffers();
 
+        // MAC PDU metadata are only collected for the downlink
+        dropExpiredPdus_ = (direction_ == DL) && mac_->par("edfDropExpired").boolValue();
+
         // Create LteScheduler. One per carrier
         SchedDiscipline discipline = mac_->getSchedDiscipline(direction_);
+        edfCrossCarrier_ = (direction_ == DL) && discipline == EDF && mac_->par("edfCrossCarrier").boolValue();
+        configuredGrant_ = mac_->par("configuredGrant").boolValue();
+        miniSlotPreemption_ = (direction_ == DL) && mac_->par("miniSlotPreemption").boolValue();
+        parallel_ = (direction_ == DL) && binder_->getCellSchedulingPool() != nullptr;
 
         LteScheduler *newSched = nullptr;
         const CarrierInfoMap *carriers = mac_->getCellInfo()->getCarrierInfoMap();
@@ -119,12 +140,24 @@ namespace simu5g
         }
 
         // Create Allocator
-        if (discipline == ALLOCATOR_BESTFIT) // NOTE: create this type of allocator for every scheduler using Frequency Reuse
-            allocator_ = new LteAllocationModuleFrequencyReuse(mac_, direction_);
-        else
-            allocator_ = new LteAllocationModule(mac_, direction_);
+        bitsetAllocator_ = mac_->par("bitsetAllocator").boolValue();
+        if (bitsetAllocator_ && discipline == ALLOCATOR_BESTFIT)
+            throw cRuntimeError("LteSchedulerEnb::initialize - the bitset allocator does not support the frequency reuse of ALLOCATOR_BESTFIT");
+        createAllocator(discipline);
 
         initializeAllocator();
+
+        // one trace per cell and direction
+        std::string traceFile = mac_->par("schedulerTraceFile").stdstringValue();
+        if (!traceFile.empty())
+        {
+            SchedulerTraceHeader header;
+            header.direction = direction_;
+            header.cellId = mac_->getMacCellId();
+            header.numBands = mac_->getCellInfo()->getNumBands();
+            trace_ = std::make_unique<SchedulerTraceWriter>();
+            trace_->open(traceFile + "." + std::to_string(num(header.cellId)) + "." + dirToA(direction_), header);
+        }
     }
 
     void LteSchedulerEnb::initializeSchedulerPeriodCounter(NumerologyIndex maxNumerologyIndex)
@@ -141,10 +174,20 @@ namespace simu5g
         for (auto &[key, value] : scheduleList_)
             value.clear();
         allocatedCws_.clear();
+        carrierAllocatedCws_.clear();
+        slotNodes_.clear();
+        preemptable_.clear();
 
         // clean the allocator
         resetAllocator();
 
+        // in parallel mode, the MAC has already dropped them
+        if (!parallel_)
+            dropExpiredPdus();
+
+        // carriers left to the cross-carrier NR-EDF pass
+        std::vector<NrEDF *> edfCarriers;
+
         // schedule one carrier at a time
         LteScheduler *scheduler = nullptr;
         for (auto &schedulerPtr : scheduler_)
@@ -165,24 +208,98 @@ namespace simu5g
             {
                 EV << "___________________________end RAC+RTX ________________________________" << endl;
                 EV << "___________________________start SCHED ________________________________" << endl;
+                if (configuredGrant_)
+                    scheduleConfiguredGrants(scheduler);
                 scheduler->updateSchedulingInfo();
-                scheduler->schedule();
+                if (trace_)
+                    recordTrace(scheduler);
+                if (edfCrossCarrier_)
+                    edfCarriers.push_back(static_cast<NrEDF *>(scheduler));
+                else
+                    scheduler->schedule();
                 EV << "____________________________ end SCHED ________________________________" << endl;
             }
         }
 
+        // new transmissions on all the carriers due in this slot, in one deadline-ordered pass
+        if (!edfCarriers.empty())
+            NrEDF::scheduleCrossCarrier(edfCarriers);
+
         // record assigned resource blocks statistics
         resourceBlockStatistics();
 
         return &scheduleList_;
     }
 
+    void LteSchedulerEnb::recordTrace(LteScheduler *scheduler)
+    {
+        double carrierFrequency = scheduler->getCarrierFrequency();
+        SchedulerTraceRecord &record = traceRecord_;
+        record.time = NOW.dbl();
+        record.carrierFrequency = carrierFrequency;
+        record.numerologyIndex = scheduler->getNumerologyIndex();
+
+        // retransmissions and configured grants are already allocated
+        unsigned int numBands = mac_->getCellInfo()->getNumBands();
+        record.freeBands.resize(numBands);
+        for (Band b = 0; b < numBands; b++)
+            record.freeBands[b] = allocator_->getAllocatedBlocks(MAIN_PLANE, MACRO, b) == 0;
+
+        record.connections.clear();
+        LteMacBufferMap *buffers = (direction_ == DL) ? vbuf_ : bsrbuf_;
+        const UeSet &carrierUeSet = binder_->getCarrierUeSet(carrierFrequency);
+        for (MacCid cid : activeConnectionSet_)
+        {
+            MacNodeId nodeId = MacCidToNodeId(cid);
+            if (carrierUeSet.find(nodeId) == carrierUeSet.end() || binder_->getOmnetId(nodeId) == 0)
+                continue;
+
+            SchedulerTraceConnection &connection = record.connections.emplace_back();
+            connection.cid = cid;
+
+            auto bit = buffers->find(cid);
+            if (bit != buffers->end())
+            {
+                connection.bufferedBytes = bit->second->getQueueOccupancy();
+                connection.bufferedSdus = bit->second->getQueueLength();
+                connection.headSduBytes = bit->second->isEmpty() ? 0 : bit->second->front().first;
+            }
+
+            const MacPduMetaDataStore::EntryFifo *entries = macPduMetaDataStore_.entries(cid);
+            if (entries != nullptr && !entries->empty())
+            {
+                const MacPduMetaDataStore::Entry &head = (*entries)[0];
+                connection.pendingPdus = entries->size();
+                connection.fiveQi = head.meta.fiveQi;
+                connection.arrivalTime = head.meta.arrivalTime.dbl();
+                connection.deadline = head.deadline.dbl();
+            }
+
+            Direction dir = direction_;
+            if (dir == UL && MacCidToLcid(cid) == D2D_SHORT_BSR)
+                dir = D2D;
+            else if (dir == UL && MacCidToLcid(cid) == D2D_MULTI_SHORT_BSR)
+                dir = D2D_MULTI;
+
+            const UserTxParams &txParams = mac_->getAmc()->computeTxParams(nodeId, dir, carrierFrequency);
+            for (Cqi cqi : txParams.readCqiVector())
+                connection.cqi.push_back(cqi);
+            for (Band b : txParams.readBands())
+                connection.bands.emplace_back(b, mac_->getAmc()->computeBytesOnNRbs(nodeId, b, 1, dir, carrierFrequency));
+        }
+
+        trace_->write(record);
+    }
+
     /*  COMPLETE:        scheduleGrant(cid,bytes,terminate,active,eligible,band_limit,antenna);
      *  ANTENNA UNAWARE: scheduleGrant(cid,bytes,terminate,active,eligible,band_limit);
      *  BAND UNAWARE:    scheduleGrant(cid,bytes,terminate,active,eligible);
      */
     unsigned int LteSchedulerEnb::scheduleGrant(MacCid cid, unsigned int bytes, bool &terminate, bool &active, bool &eligible, double carrierFrequency, BandLimitVector *bandLim, Remote antenna, bool limitBl)
     {
+        // codewords already allocated in this slot
+        LteMacAllocatedCws &cws = codewordList(carrierFrequency);
+
         // Get the node ID and logical connection ID
         MacNodeId nodeId = MacCidToNodeId(cid);
         LogicalCid flowId = MacCidToLcid(cid);
@@ -201,55 +318,21 @@ namespace simu5g
 
         // Get user transmission parameters
         const UserTxParams &txParams = mac_->getAmc()->computeTxParams(nodeId, dir, carrierFrequency);
-        const std::set<Band> &allowedBands = txParams.readBands();
-
-        // get the number of codewords
-        unsigned int numCodewords = txParams.getLayers().size();
 
-        // TEST: check the number of codewords
-        numCodewords = 1;
+        // TEST: the number of codewords is forced to 1, hence the layer mapping of txParams is not computed
+        unsigned int numCodewords = 1;
 
-        EV << "LteSchedulerEnb::grant - deciding allowed Bands" << endl;
-        std::string bands_msg = "BAND_LIMIT_SPECIFIED";
-        std::vector<BandLimit> tempBandLim;
+        EV_DEBUG << "LteSchedulerEnb::grant - deciding allowed Bands" << endl;
+        const char *bands_msg = "BAND_LIMIT_SPECIFIED";
         if (bandLim == nullptr)
         {
             bands_msg = "NO_BAND_SPECIFIED";
-
+#ifndef NDEBUG
             txParams.print("grant()");
-
-            emptyBandLim_.clear();
-            // Create a vector of band limit using all bands
-            if (emptyBandLim_.empty())
-            {
-                unsigned int numBands = mac_->getCellInfo()->getNumBands();
-                // for each band of the band vector provided
-                for (unsigned int i = 0; i < numBands; i++)
-                {
-                    BandLimit elem;
-                    // copy the band
-                    elem.band_ = Band(i);
-                    EV << "Putting band " << i << endl;
-                    // mark as unlimited
-                    for (unsigned int j = 0; j < numCodewords; j++)
-                    {
-                        EV << "- Codeword " << j << endl;
-                        if (allowedBands.find(elem.band_) != allowedBands.end())
-                        {
-                            EV << "\t" << i << " " << "yes" << endl;
-                            elem.limit_[j] = -1;
-                        }
-                        else
-                        {
-                            EV << "\t" << i << " " << "no" << endl;
-                            elem.limit_[j] = -2;
-                        }
-                    }
-                    emptyBandLim_.push_back(elem);
-                }
-            }
-            tempBandLim = emptyBandLim_;
-            bandLim = &tempBandLim;
+#endif
+            // use all the allowed bands, without limit
+            fillBandLimit(emptyBandLim_, &txParams, numCodewords);
+            bandLim = &emptyBandLim_;
         }
         else
         {
@@ -258,34 +341,25 @@ namespace simu5g
             for (unsigned int i = 0; i < numBands; i++)
             {
                 BandLimit &elem = bandLim->at(i);
+                bool allowed = txParams.isBandAllowed(elem.band_);
                 for (unsigned int j = 0; j < numCodewords; j++)
                 {
                     if (elem.limit_[j] == -2)
                         continue;
-
-                    if (allowedBands.find(elem.band_) != allowedBands.end())
-                    {
-                        EV << "\t" << i << " " << "yes" << endl;
-                        elem.limit_[j] = -1;
-                    }
-                    else
-                    {
-                        EV << "\t" << i << " " << "no" << endl;
-                        elem.limit_[j] = -2;
-                    }
+                    elem.limit_[j] = allowed ? -1 : -2;
                 }
             }
         }
-        EV << "LteSchedulerEnb::grant(" << cid << "," << bytes << "," << terminate << "," << active << "," << eligible << "," << bands_msg << "," << dasToA(antenna) << ")" << endl;
+        EV_DEBUG << "LteSchedulerEnb::grant(" << cid << "," << bytes << "," << terminate << "," << active << "," << eligible << "," << bands_msg << "," << dasToA(antenna) << ")" << endl;
 
         unsigned int totalAllocatedBytes = 0;  // total allocated data (in bytes)
         unsigned int totalAllocatedBlocks = 0; // total allocated data (in blocks)
 
         // === Perform normal operation for grant === //
 
-        EV << "LteSchedulerEnb::grant --------------------::[ START GRANT ]::--------------------" << endl;
-        EV << "LteSchedulerEnb::grant Cell: " << mac_->getMacCellId() << endl;
-        EV << "LteSchedulerEnb::grant CID: " << cid << "(UE: " << nodeId << ", Flow: " << flowId << ") current Antenna [" << dasToA(antenna) << "]" << endl;
+        EV_DEBUG << "LteSchedulerEnb::grant --------------------::[ START GRANT ]::--------------------" << endl;
+        EV_DEBUG << "LteSchedulerEnb::grant Cell: " << mac_->getMacCellId() << endl;
+        EV_DEBUG << "LteSchedulerEnb::grant CID: " << cid << "(UE: " << nodeId << ", Flow: " << flowId << ") current Antenna [" << dasToA(antenna) << "]" << endl;
 
         //! Multiuser MIMO support
         if (mac_->muMimo() && (txParams.readTxMode() == MULTI_USER))
@@ -297,13 +371,13 @@ namespace simu5g
                 // this user has a valid pairing
                 // 1) register pairing  - if pairing is already registered false is returned
                 if (allocator_->configureMuMimoPeering(nodeId, peer))
-                    EV << "LteSchedulerEnb::grant MU-MIMO pairing established: main user [" << nodeId << "], paired user [" << peer << "]" << endl;
+                    EV_DEBUG << "LteSchedulerEnb::grant MU-MIMO pairing established: main user [" << nodeId << "], paired user [" << peer << "]" << endl;
                 else
-                    EV << "LteSchedulerEnb::grant MU-MIMO pairing already exists between users [" << nodeId << "] and [" << peer << "]" << endl;
+                    EV_DEBUG << "LteSchedulerEnb::grant MU-MIMO pairing already exists between users [" << nodeId << "] and [" << peer << "]" << endl;
             }
             else
             {
-                EV << "LteSchedulerEnb::grant no MU-MIMO pairing available for user [" << nodeId << "]" << endl;
+                EV_DEBUG << "LteSchedulerEnb::grant no MU-MIMO pairing available for user [" << nodeId << "]" << endl;
             }
         }
 
@@ -313,8 +387,9 @@ namespace simu5g
 
         // search for already allocated codeword
         unsigned int cwAlreadyAllocated = 0;
-        if (allocatedCws_.find(nodeId) != allocatedCws_.end())
-            cwAlreadyAllocated = allocatedCws_.at(nodeId);
+        auto cwIt = cws.find(nodeId);
+        if (cwIt != cws.end())
+            cwAlreadyAllocated = cwIt->second;
 
         // Check OFDM space
         // OFDM space is not zero if this if we are trying to allocate the second cw in SPMUX or
@@ -325,7 +400,7 @@ namespace simu5g
                                                    (txParams.readTxMode() != MULTI_USER || plane != MU_MIMO_PLANE)))
         {
             terminate = true; // OFDM space ended, issuing terminate flag
-            EV << "LteSchedulerEnb::grant Space ended, no scheduling." << endl;
+            EV_DEBUG << "LteSchedulerEnb::grant Space ended, no scheduling." << endl;
             return 0;
         }
 
@@ -343,23 +418,23 @@ namespace simu5g
         if (debug)
         {
             if (limitBl)
-                EV << "LteSchedulerEnb::grant blocks: " << bytes << endl;
+                EV_DEBUG << "LteSchedulerEnb::grant blocks: " << bytes << endl;
             else
-                EV << "LteSchedulerEnb::grant Bytes: " << bytes << endl;
-            EV << "LteSchedulerEnb::grant Bands: {";
+                EV_DEBUG << "LteSchedulerEnb::grant Bytes: " << bytes << endl;
+            EV_DEBUG << "LteSchedulerEnb::grant Bands: {";
             unsigned int size = (*bandLim).size();
             if (size > 0)
             {
-                EV << (*bandLim).at(0).band_;
+                EV_DEBUG << (*bandLim).at(0).band_;
                 for (unsigned int i = 1; i < size; i++)
-                    EV << ", " << (*bandLim).at(i).band_;
+                    EV_DEBUG << ", " << (*bandLim).at(i).band_;
             }
-            EV << "}\n";
+            EV_DEBUG << "}\n";
         }
         // ===== END DEBUG OUTPUT ===== //
 
-        EV << "LteSchedulerEnb::grant TxMode: " << txModeToA(txParams.readTxMode()) << endl;
-        EV << "LteSchedulerEnb::grant Available codewords: " << numCodewords << endl;
+        EV_DEBUG << "LteSchedulerEnb::grant TxMode: " << txModeToA(txParams.readTxMode()) << endl;
+        EV_DEBUG << "LteSchedulerEnb::grant Available codewords: " << numCodewords << endl;
 
         // Retrieve the first free codeword checking the eligibility - check eligibility could modify current cw index.
         Codeword cw = 0; // current codeword, modified by reference by the checkEligibility function
@@ -367,10 +442,10 @@ namespace simu5g
         {
             eligible = false;
 
-            EV << "LteSchedulerEnb::grant @@@@@ CODEWORD " << cw << " @@@@@" << endl;
-            EV << "LteSchedulerEnb::grant Total allocation: " << totalAllocatedBytes << " bytes" << endl;
-            EV << "LteSchedulerEnb::grant NOT ELIGIBLE!!!" << endl;
-            EV << "LteSchedulerEnb::grant --------------------::[  END GRANT  ]::--------------------" << endl;
+            EV_DEBUG << "LteSchedulerEnb::grant @@@@@ CODEWORD " << cw << " @@@@@" << endl;
+            EV_DEBUG << "LteSchedulerEnb::grant Total allocation: " << totalAllocatedBytes << " bytes" << endl;
+            EV_DEBUG << "LteSchedulerEnb::grant NOT ELIGIBLE!!!" << endl;
+            EV_DEBUG << "LteSchedulerEnb::grant --------------------::[  END GRANT  ]::--------------------" << endl;
             return totalAllocatedBytes; // return the total number of served bytes
         }
 
@@ -382,8 +457,8 @@ namespace simu5g
         if (queueLength == 0)
         {
             active = false;
-            EV << "LteSchedulerEnb::scheduleGrant - scheduled connection is no longer active. Exiting grant " << endl;
-            EV << "LteSchedulerEnb::grant --------------------::[  END GRANT  ]::--------------------" << endl;
+            EV_DEBUG << "LteSchedulerEnb::scheduleGrant - scheduled connection is no longer active. Exiting grant " << endl;
+            EV_DEBUG << "LteSchedulerEnb::grant --------------------::[  END GRANT  ]::--------------------" << endl;
             return totalAllocatedBytes;
         }
 
@@ -391,11 +466,11 @@ namespace simu5g
         unsigned int toServe = 0;
         for (; cw < numCodewords; ++cw)
         {
-            EV << "LteSchedulerEnb::grant @@@@@ CODEWORD " << cw << " @@@@@" << endl;
+            EV_DEBUG << "LteSchedulerEnb::grant @@@@@ CODEWORD " << cw << " @@@@@" << endl;
 
             queueLength += MAC_HEADER + RLC_HEADER_UM;              // TODO RLC may be either UM or AM
             toServe = (queueLength <= bytes) ? queueLength : bytes; // do not serve more bytes than the maximum number of bytes requested
-            EV << "LteSchedulerEnb::scheduleGrant bytes to be allocated: " << toServe << endl;
+            EV_DEBUG << "LteSchedulerEnb::scheduleGrant bytes to be allocated: " << toServe << endl;
 
             unsigned int cwAllocatedBytes = 0;  // per codeword allocated bytes
             unsigned int cwAllocatedBlocks = 0; // used by uplink only, for signaling cw blocks usage to schedule list
@@ -408,18 +483,19 @@ namespace simu5g
                 // save the band and the relative limit
                 Band b = (*bandLim).at(i).band_;
                 int limit = (*bandLim).at(i).limit_.at(cw);
-                EV << "LteSchedulerEnb::grant --- BAND " << b << " LIMIT " << limit << "---" << endl;
+                EV_DEBUG << "LteSchedulerEnb::grant --- BAND " << b << " LIMIT " << limit << "---" << endl;
 
                 // if the limit flag is set to skip, jump off
                 if (limit == -2)
                 {
-                    EV << "LteSchedulerEnb::grant skipping logical band according to limit value" << endl;
+                    EV_DEBUG << "LteSchedulerEnb::grant skipping logical band according to limit value" << endl;
                     continue;
                 }
 
                 // search for already allocated codeword
-                if (allocatedCws_.find(nodeId) != allocatedCws_.end())
-                    allocatedCws = allocatedCws_.at(nodeId);
+                cwIt = cws.find(nodeId);
+                if (cwIt != cws.end())
+                    allocatedCws = cwIt->second;
 
                 unsigned int bandAvailableBytes = 0;
                 unsigned int bandAvailableBlocks = 0;
@@ -441,7 +517,7 @@ namespace simu5g
                 // if no allocation can be performed, notify to skip the band on next processing (if any)
                 if (bandAvailableBytes == 0)
                 {
-                    EV << "LteSchedulerEnb::grant Band " << b << " will be skipped since it has no space left." << endl;
+                    EV_DEBUG << "LteSchedulerEnb::grant Band " << b << " will be skipped since it has no space left." << endl;
                     (*bandLim).at(i).limit_.at(cw) = -2;
                     continue;
                 }
@@ -453,7 +529,7 @@ namespace simu5g
                     if (limit >= 0 && limit < (int)bandAvailableBytes)
                     {
                         bandAvailableBytes = limit;
-                        EV << "LteSchedulerEnb::grant Band space limited to " << bandAvailableBytes << " bytes according to limit cap" << endl;
+                        EV_DEBUG << "LteSchedulerEnb::grant Band space limited to " << bandAvailableBytes << " bytes according to limit cap" << endl;
                     }
                 }
                 else
@@ -462,11 +538,11 @@ namespace simu5g
                     if (limit >= 0 && limit < (int)bandAvailableBlocks)
                     {
                         bandAvailableBlocks = limit;
-                        EV << "LteSchedulerEnb::grant Band space limited to " << bandAvailableBlocks << " blocks according to limit cap" << endl;
+                        EV_DEBUG << "LteSchedulerEnb::grant Band space limited to " << bandAvailableBlocks << " blocks according to limit cap" << endl;
                     }
                 }
 
-                EV << "LteSchedulerEnb::grant Available Bytes: " << bandAvailableBytes << " available blocks " << bandAvailableBlocks << endl;
+                EV_DEBUG << "LteSchedulerEnb::grant Available Bytes: " << bandAvailableBytes << " available blocks " << bandAvailableBlocks << endl;
 
                 unsigned int uBytes = (bandAvailableBytes > toServe) ? toServe : bandAvailableBytes;
                 unsigned int uBlocks = 1;
@@ -521,8 +597,10 @@ namespace simu5g
                 {
                     // serve the entire vPkt, remove pkt info
                     conn->popFront();
+                    if (dir == DL)
+                        macPduMetaDataStore_.popFront(cid);
                     consumedBytes -= vPktSize;
-                    EV << "LteSchedulerEnb::grant - the first SDU/BSR is served entirely, remove it from the virtual buffer, remaining bytes to serve[" << consumedBytes << "]" << endl;
+                    EV_DEBUG << "LteSchedulerEnb::grant - the first SDU/BSR is served entirely, remove it from the virtual buffer, remaining bytes to serve[" << consumedBytes << "]" << endl;
                 }
                 else
                 {
@@ -531,38 +609,27 @@ namespace simu5g
                     newPktInfo.first = newPktInfo.first - consumedBytes;
                     conn->pushFront(newPktInfo);
                     consumedBytes = 0;
-                    EV << "LteSchedulerEnb::grant - the first SDU/BSR is partially served, update its size [" << newPktInfo.first << "]" << endl;
+                    EV_DEBUG << "LteSchedulerEnb::grant - the first SDU/BSR is partially served, update its size [" << newPktInfo.first << "]" << endl;
                 }
             }
 
-            EV << "LteSchedulerEnb::grant Codeword allocation: " << cwAllocatedBytes << " bytes" << endl;
+            EV_DEBUG << "LteSchedulerEnb::grant Codeword allocation: " << cwAllocatedBytes << " bytes" << endl;
             if (cwAllocatedBytes > 0)
             {
                 // mark codeword as used
-                if (allocatedCws_.find(nodeId) != allocatedCws_.end())
-                    allocatedCws_.at(nodeId)++;
-                else
-                    allocatedCws_[nodeId] = 1;
+                unsigned int &nodeCws = cws[nodeId];
+                nodeCws++;
 
                 totalAllocatedBytes += cwAllocatedBytes;
 
-                // create entry in the schedule list for this carrier
-                if (scheduleList_.find(carrierFrequency) == scheduleList_.end())
-                {
-                    LteMacScheduleList newScheduleList;
-                    scheduleList_[carrierFrequency] = newScheduleList;
-                }
-                // create entry in the schedule list for this pair <cid,cw>
-                std::pair<unsigned int, Codeword> scListId(cid, cw);
-                if (scheduleList_[carrierFrequency].find(scListId) == scheduleList_[carrierFrequency].end())
-                    scheduleList_[carrierFrequency][scListId] = 0;
-
-                // if direction is DL , then schedule list contains number of to-be-transmitted SDUs ,
+                // create, if needed, the entries for this carrier and for the pair <cid,cw> in the schedule list.
+                // If direction is DL , then schedule list contains number of to-be-transmitted SDUs ,
                 // otherwise it contains the number of granted blocks
+                std::pair<unsigned int, Codeword> scListId(cid, cw);
                 scheduleList_[carrierFrequency][scListId] += ((dir == DL) ? vQueueItemCounter : cwAllocatedBlocks);
 
-                EV << "LteSchedulerEnb::grant CODEWORD IS NOW BUSY: GO TO NEXT CODEWORD." << endl;
-                if (allocatedCws_.at(nodeId) == MAX_CODEWORDS)
+                EV_DEBUG << "LteSchedulerEnb::grant CODEWORD IS NOW BUSY: GO TO NEXT CODEWORD." << endl;
+                if (nodeCws == MAX_CODEWORDS)
                 {
                     eligible = false;
                     stop = true;
@@ -570,7 +637,7 @@ namespace simu5g
             }
             else
             {
-                EV << "LteSchedulerEnb::grant CODEWORD IS FREE: NO ALLOCATION IS POSSIBLE IN NEXT CODEWORD." << endl;
+                EV_DEBUG << "LteSchedulerEnb::grant CODEWORD IS FREE: NO ALLOCATION IS POSSIBLE IN NEXT CODEWORD." << endl;
                 eligible = false;
                 stop = true;
             }
@@ -578,46 +645,31 @@ namespace simu5g
                 break;
         } // Closes loop on Codewords
 
-        EV << "LteSchedulerEnb::grant Total allocation: " << totalAllocatedBytes << " bytes, " << totalAllocatedBlocks << " blocks" << endl;
-        EV << "LteSchedulerEnb::grant --------------------::[  END GRANT  ]::--------------------" << endl;
+        EV_DEBUG << "LteSchedulerEnb::grant Total allocation: " << totalAllocatedBytes << " bytes, " << totalAllocatedBlocks << " blocks" << endl;
+        EV_DEBUG << "LteSchedulerEnb::grant --------------------::[  END GRANT  ]::--------------------" << endl;
 
         return totalAllocatedBytes;
     }
 
     unsigned int LteSchedulerEnb::scheduleGrantBackground(MacCid bgCid, unsigned int bytes, bool &terminate, bool &active, bool &eligible, double carrierFrequency, BandLimitVector *bandLim, Remote antenna, bool limitBl)
     {
+        // codewords already allocated in this slot
+        LteMacAllocatedCws &cws = codewordList(carrierFrequency);
+
         MacNodeId bgUeId = MacCidToNodeId(bgCid);
 
         // Get the number of codewords
         unsigned int numCodewords = 1;
 
         EV << "LteSchedulerEnb::grant - deciding allowed Bands" << endl;
-        std::string bands_msg = "BAND_LIMIT_SPECIFIED";
-        std::vector<BandLimit> tempBandLim;
+        const char *bands_msg = "BAND_LIMIT_SPECIFIED";
         if (bandLim == nullptr)
         {
             bands_msg = "NO_BAND_SPECIFIED";
 
-            emptyBandLim_.clear();
-            // Create a vector of band limit using all bands
-            if (emptyBandLim_.empty())
-            {
-                unsigned int numBands = mac_->getCellInfo()->getNumBands();
-                // For each band of the band vector provided
-                for (unsigned int i = 0; i < numBands; i++)
-                {
-                    BandLimit elem;
-                    // Copy the band
-                    elem.band_ = Band(i);
-                    EV << "Putting band " << i << endl;
-                    // Mark all bands as unlimited
-                    for (unsigned int j = 0; j < numCodewords; j++)
-                        elem.limit_[j] = -1;
-                    emptyBandLim_.push_back(elem);
-                }
-            }
-            tempBandLim = emptyBandLim_;
-            bandLim = &tempBandLim;
+            // Mark all bands as unlimited
+            fillBandLimit(emptyBandLim_, nullptr, numCodewords);
+            bandLim = &emptyBandLim_;
         }
         // Else use the one passed to the function
 
@@ -639,8 +691,8 @@ namespace simu5g
 
         // Search for already allocated codeword
         unsigned int cwAlreadyAllocated = 0;
-        if (allocatedCws_.find(bgUeId) != allocatedCws_.end())
-            cwAlreadyAllocated = allocatedCws_.at(bgUeId);
+        if (cws.find(bgUeId) != cws.end())
+            cwAlreadyAllocated = cws.at(bgUeId);
 
         if (cwAlreadyAllocated > 0)
         {
@@ -719,8 +771,8 @@ namespace simu5g
                 }
 
                 // Search for already allocated codeword
-                if (allocatedCws_.find(bgUeId) != allocatedCws_.end())
-                    allocatedCws = allocatedCws_.at(bgUeId);
+                if (cws.find(bgUeId) != cws.end())
+                    allocatedCws = cws.at(bgUeId);
 
                 unsigned int bandAvailableBytes = 0;
                 unsigned int bandAvailableBlocks = 0;
@@ -834,13 +886,13 @@ namespace simu5g
             if (cwAllocatedBytes > 0)
             {
                 // Mark codeword as used
-                if (allocatedCws_.find(bgUeId) != allocatedCws_.end())
-                    allocatedCws_.at(bgUeId)++;
+                if (cws.find(bgUeId) != cws.end())
+                    cws.at(bgUeId)++;
                 else
-                    allocatedCws_[bgUeId] = 1;
+                    cws[bgUeId] = 1;
 
                 totalAllocatedBytes += cwAllocatedBytes;
-                if (allocatedCws_.at(bgUeId) == MAX_CODEWORDS)
+                if (cws.at(bgUeId) == MAX_CODEWORDS)
                 {
                     eligible = false;
                     stop = true;
@@ -930,22 +982,83 @@ namespace simu5g
      * OFDMA frame management
      */
 
+    void LteSchedulerEnb::dropExpiredPdus()
+    {
+        if (!dropExpiredPdus_)
+            return;
+
+        // DC-GBR entries are at the top of the store, sorted by deadline
+        const MacPduMetaDataStore::Entry *head;
+        while ((head = macPduMetaDataStore_.top()) != nullptr && head->deadline <= NOW)
+        {
+            if (get_qos_parameters(head->meta.fiveQi).resource_type != qos_data::DCGBR)
+                break;
+
+            MacCid cid = head->meta.cid;
+            unsigned int droppedBytes = mac_->discardHolSdu(cid);
+            if (droppedBytes == 0)
+            {
+                // already being transmitted, let it go
+                EV << NOW << " LteSchedulerEnb::dropExpiredPdus - cid[" << cid << "] expired SDU is partially sent, not discarded" << endl;
+                macPduMetaDataStore_.skipTop();
+                continue;
+            }
+
+            EV << NOW << " LteSchedulerEnb::dropExpiredPdus - cid[" << cid << "] discarded SDU with deadline " << head->deadline << endl;
+            emitStatistic(expiredSduDropDlSignal_, (long)droppedBytes);
+            macPduMetaDataStore_.popTop();
+        }
+        macPduMetaDataStore_.restoreSkipped();
+    }
+
+    void LteSchedulerEnb::emitDeferredSignals()
+    {
+        for (auto &[signal, value] : deferredSignals_)
+            mac_->emit(signal, value);
+        deferredSignals_.clear();
+    }
+
     void LteSchedulerEnb::initializeAllocator()
     {
         // Initialize the allocator
         allocator_->init(resourceBlocks_, mac_->getCellInfo()->getNumBands());
     }
 
+    void LteSchedulerEnb::createAllocator(SchedDiscipline discipline)
+    {
+        if (discipline == ALLOCATOR_BESTFIT) // NOTE: create this type of allocator for every scheduler using Frequency Reuse
+            allocator_ = new LteAllocationModuleFrequencyReuse(mac_, direction_);
+        else if (bitsetAllocator_)
+            allocator_ = new LteAllocationModuleBitset(mac_, direction_);
+        else
+            allocator_ = new LteAllocationModule(mac_, direction_);
+    }
+
     void LteSchedulerEnb::resetAllocator()
     {
         // Reset the allocator
         allocator_->reset(resourceBlocks_, mac_->getCellInfo()->getNumBands());
     }
 
+    void LteSchedulerEnb::fillBandLimit(BandLimitVector &bandLim, const UserTxParams *txParams, unsigned int numCodewords)
+    {
+        unsigned int numBands = mac_->getCellInfo()->getNumBands();
+        // elements are only added the first time, their limit vectors are then reused
+        bandLim.resize(numBands);
+        for (unsigned int i = 0; i < numBands; i++)
+        {
+            BandLimit &elem = bandLim[i];
+            elem.band_ = Band(i);
+            bool allowed = (txParams == nullptr) || txParams->isBandAllowed(elem.band_);
+            for (unsigned int j = 0; j < MAX_CODEWORDS; j++)
+                elem.limit_[j] = (j < numCodewords && !allowed) ? -2 : -1;
+        }
+    }
+
     unsigned int LteSchedulerEnb::availableBytes(const MacNodeId id,
                                                  Remote antenna, Band b, Codeword cw, Direction dir, double carrierFrequency, int limit)
     {
-        EV << "LteSchedulerEnb::availableBytes MacNodeId " << id << " Antenna " << dasToA(antenna) << " band " << b << " cw " << cw << endl;
+        EV_DEBUG << "LteSchedulerEnb::availableBytes MacNodeId " << id << " Antenna " << dasToA(antenna) << " band " << b << " cw " << cw << endl;
         // Retrieving this user available resource blocks
         int blocks = allocator_->availableBlocks(id, antenna, b);
         // Consistency Check
@@ -956,7 +1069,7 @@ namespace simu5g
             blocks = (blocks > limit) ? limit : blocks;
 
         unsigned int bytes = mac_->getAmc()->computeBytesOnNRbs(id, b, cw, blocks, dir, carrierFrequency);
-        EV << "LteSchedulerEnb::availableBytes MacNodeId " << id << " blocks [" << blocks << "], bytes [" << bytes << "]" << endl;
+        EV_DEBUG << "LteSchedulerEnb::availableBytes MacNodeId " << id << " blocks [" << blocks << "], bytes [" << bytes << "]" << endl;
 
         return bytes;
     }
@@ -1012,11 +1125,11 @@ namespace simu5g
         switch (discipline)
         {
         case EDF:
-            return new NrEDF(binder_);
+            return new NrEDF(binder_, mac_->par("edfIncremental").boolValue());
         case DRR:
             return new LteDrr(binder_);
         case PF:
-            return new LtePf(binder_, mac_->par("pfAlpha").doubleValue());
+            return new LtePf(binder_);
         case MAXCI:
             return new LteMaxCi(binder_);
         case MAXCI_MB:
@@ -1029,8 +1142,13 @@ namespace simu5g
             return new LteAllocatorBestFit(binder_);
 
         default:
-            throw cRuntimeError("LteScheduler not recognized");
-            return nullptr;
+        {
+            // policies registered in the factory, e.g. HIERARCHICAL
+            std::string name = mac_->getSchedDisciplineName(direction_);
+            if (LteScheduler *scheduler = LteSchedulerFactory::create(name, binder_))
+                return scheduler;
+            throw cRuntimeError("LteScheduler \"%s\" not recognized", name.c_str());
+        }
         }
     }
 
@@ -1039,7 +1157,7 @@ namespace simu5g
         if (sleep)
         {
             if (direction_ == DL)
-                mac_->emit(avgServedBlocksDlSignal_, (long)0);
+                emitStatistic(avgServedBlocksDlSignal_, (long)0);
             return;
         }
         // Get a reference to the beginning and the end of the map which stores the blocks allocated
@@ -1063,21 +1181,273 @@ namespace simu5g
         utilization_ /= (((double)(antenna)) * ((double)resourceBlocks_));
 
         if (direction_ == DL)
-            mac_->emit(avgServedBlocksDlSignal_, allocatedBlocks);
+            emitStatistic(avgServedBlocksDlSignal_, allocatedBlocks);
         else if (direction_ == UL)
-            mac_->emit(avgServedBlocksUlSignal_, allocatedBlocks);
+            emitStatistic(avgServedBlocksUlSignal_, allocatedBlocks);
         else
             throw cRuntimeError("LteSchedulerEnb::resourceBlockStatistics(): Unrecognized direction %d", direction_);
     }
 
-    MacPduMetaDataList *LteSchedulerEnb::readMacPduMetaDataList()
+    MacPduMetaDataStore *LteSchedulerEnb::readMacPduMetaDataStore()
+    {
+        return &macPduMetaDataStore_;
+    }
+
+    void LteSchedulerEnb::insertMacPduMetaData(const MacPduMetaData &meta)
     {
-        return &macPduMetaDataSet_;
+        macPduMetaDataStore_.push(meta);
+        connectionFiveQi_[meta.cid] = meta.fiveQi;
+
+        if (configuredGrant_ && direction_ == DL)
+        {
+            auto vit = vbuf_->find(meta.cid);
+            unsigned int bytes = (vit != vbuf_->end() && !vit->second->isEmpty()) ? vit->second->back().first : 0;
+            observeArrival(meta.cid, meta.fiveQi, meta.arrivalTime, bytes);
+            confirmConfiguredGrant(meta.cid);
+        }
     }
 
-    void LteSchedulerEnb::insertMacPduMetaData(MacPduMetaData meta)
+    void LteSchedulerEnb::observeArrival(MacCid cid, FiveQI fiveQi, simtime_t arrival, unsigned int bytes)
     {
-        macPduMetaDataSet_.push_back(meta);
+        if (!configuredGrant_ || get_qos_parameters(fiveQi).resource_type != qos_data::DCGBR)
+            return;
+
+        // SDUs arriving together make one burst
+        ConfiguredGrant &cg = configuredGrants_[cid];
+        if (arrival == cg.arrivals.getLastArrival())
+            cg.burst += bytes;
+        else
+        {
+            cg.arrivals.update(arrival);
+            cg.burst = bytes;
+        }
+        cg.bytes = std::max(cg.bytes, cg.burst);
+
+        if (!cg.configured && cg.arrivals.isPeriodic())
+        {
+            cg.configured = true;
+            cg.nextOccasion = cg.arrivals.getNextArrival();
+            cg.used = false;
+            cg.unused = 0;
+            EV << NOW << " LteSchedulerEnb::observeArrival - configured grant for cid " << cid << ": " << cg.bytes
+               << " bytes every " << cg.arrivals.getPeriod() << "s, first occasion " << cg.nextOccasion << endl;
+        }
+    }
+
+    void LteSchedulerEnb::confirmConfiguredGrant(MacCid cid)
+    {
+        auto it = configuredGrants_.find(cid);
+        if (it != configuredGrants_.end())
+            it->second.used = true;
+    }
+
+    bool LteSchedulerEnb::isCoveredByConfiguredGrant(MacCid cid)
+    {
+        auto it = configuredGrants_.find(cid);
+        if (it == configuredGrants_.end() || !it->second.configured)
+            return false;
+        const ConfiguredGrant &cg = it->second;
+
+        // the reservation is exceeded
+        LteMacBufferMap *buffers = (direction_ == DL) ? vbuf_ : bsrbuf_;
+        auto bit = buffers->find(cid);
+        if (bit != buffers->end() && bit->second->getQueueOccupancy() > cg.bytes)
+            return false;
+
+        // the next occasion comes too late
+        const MacPduMetaDataStore::Entry *head = macPduMetaDataStore_.front(cid);
+        return head == nullptr || cg.nextOccasion <= head->deadline;
+    }
+
+    void LteSchedulerEnb::scheduleConfiguredGrants(LteScheduler *scheduler)
+    {
+        const UeSet &carrierUeSet = binder_->getCarrierUeSet(scheduler->getCarrierFrequency());
+        LteMacBufferMap *buffers = (direction_ == DL) ? vbuf_ : bsrbuf_;
+
+        for (auto it = configuredGrants_.begin(); it != configuredGrants_.end();)
+        {
+            MacCid cid = it->first;
+            ConfiguredGrant &cg = it->second;
+            MacNodeId nodeId = MacCidToNodeId(cid);
+            if (binder_->getOmnetId(nodeId) == 0)
+            {
+                // UE has left the simulation
+                it = configuredGrants_.erase(it);
+                continue;
+            }
+            ++it;
+
+            if (!cg.configured || cg.nextOccasion > NOW || cg.servedAt == NOW || carrierUeSet.find(nodeId) == carrierUeSet.end())
+                continue;
+
+            // in the downlink, an occasion is served once the data have arrived, up to one period late
+            if (direction_ == DL && !cg.used && NOW < cg.nextOccasion + cg.arrivals.getPeriod())
+                continue;
+
+            if (cg.used)
+                cg.unused = 0;
+            else if (++cg.unused >= MAX_UNUSED_OCCASIONS)
+            {
+                EV << NOW << " LteSchedulerEnb::scheduleConfiguredGrants - releasing the configured grant of cid " << cid << endl;
+                cg.configured = false;
+                cg.arrivals.reset();
+                continue;
+            }
+            cg.used = false;
+            cg.servedAt = NOW;
+            cg.nextOccasion = std::max(cg.nextOccasion, cg.arrivals.getLastArrival()) + cg.arrivals.getPeriod();
+
+            fillConfiguredGrant(cid, cg.bytes);
+            auto bit = buffers->find(cid);
+            if (bit == buffers->end() || bit->second->isEmpty())
+                continue;
+
+            bool terminate = false, active = true, eligible = true;
+            unsigned int granted = scheduler->requestGrant(cid, cg.bytes + MAC_HEADER + RLC_HEADER_UM, terminate, active, eligible);
+            EV << NOW << " LteSchedulerEnb::scheduleConfiguredGrants - granted " << granted << " bytes to cid " << cid << endl;
+            if (terminate)
+                break;
+
+            // the connection is left out of dynamic scheduling, whose schedulers would otherwise
+            // remove it from the active set once its buffer is empty
+            if (!active)
+                activeConnectionSet_.erase(cid);
+        }
+    }
+
+    bool LteSchedulerEnb::hasMiniSlotTraffic()
+    {
+        const MacPduMetaDataStore::Entry *head = macPduMetaDataStore_.top();
+        return head != nullptr && get_qos_parameters(head->meta.fiveQi).resource_type == qos_data::DCGBR;
+    }
+
+    std::map<double, LteMacScheduleList> *LteSchedulerEnb::scheduleMiniSlot(unsigned int symbols)
+    {
+        EV << NOW << " LteSchedulerEnb::scheduleMiniSlot - " << symbols << " symbols" << endl;
+
+        // users granted in the slot (or in a previous mini-slot, the list then holds its grants only):
+        // DC-GBR/GBR ones are left alone, non-GBR ones may be preempted. Preempted users leave preemptable_
+        for (const auto &[carrierFrequency, list] : scheduleList_)
+        {
+            for (const auto &[key, blocks] : list)
+            {
+                MacCid cid = key.first;
+                MacNodeId nodeId = MacCidToNodeId(cid);
+                auto fit = connectionFiveQi_.find(cid);
+                if (miniSlotPreemption_ && fit != connectionFiveQi_.end() && get_qos_parameters(fit->second).resource_type == qos_data::NGBR
+                    && slotNodes_.find(nodeId) == slotNodes_.end())
+                    preemptable_[carrierFrequency].insert(nodeId);
+            }
+        }
+        for (const auto &[carrierFrequency, list] : scheduleList_)
+        {
+            for (const auto &[key, blocks] : list)
+            {
+                MacNodeId nodeId = MacCidToNodeId(key.first);
+                slotNodes_.insert(nodeId);
+                auto fit = connectionFiveQi_.find(key.first);
+                if (fit == connectionFiveQi_.end() || get_qos_parameters(fit->second).resource_type != qos_data::NGBR)
+                    preemptable_[carrierFrequency].erase(nodeId);
+            }
+        }
+
+        // the list only carries the mini-slot grants, while the allocator keeps the slot allocation
+        for (auto &[key, value] : scheduleList_)
+            value.clear();
+        allocatedCws_.clear();
+        carrierAllocatedCws_.clear();
+
+        LteAmc *amc = mac_->getAmc();
+        amc->setSymbolLimit(symbols);
+
+        NumerologyIndex maxNumerologyIndex = mac_->getCellInfo()->getMaxNumerologyIndex();
+        for (LteScheduler *scheduler : scheduler_)
+        {
+            // mini-slots are defined on the shortest slot
+            if (scheduler->getNumerologyIndex() != maxNumerologyIndex)
+                continue;
+
+            double carrierFrequency = scheduler->getCarrierFrequency();
+            const UeSet &carrierUeSet = binder_->getCarrierUeSet(carrierFrequency);
+
+            // DC-GBR entries are at the top of the store, sorted by deadline
+            const MacPduMetaDataStore::Entry *head;
+            while ((head = macPduMetaDataStore_.top()) != nullptr && get_qos_parameters(head->meta.fiveQi).resource_type == qos_data::DCGBR)
+            {
+                MacCid cid = head->meta.cid;
+                MacNodeId nodeId = MacCidToNodeId(cid);
+                macPduMetaDataStore_.skipTop();
+
+                // users served in the slot or in this mini-slot already have their transport block
+                if (slotNodes_.find(nodeId) != slotNodes_.end() || activeConnectionSet_.find(cid) == activeConnectionSet_.end()
+                    || carrierUeSet.find(nodeId) == carrierUeSet.end())
+                    continue;
+
+                // no free HARQ process
+                Codeword cw = 0;
+                if (!checkEligibility(nodeId, cw, carrierFrequency))
+                    continue;
+
+                bool terminate = false, active = true, eligible = true;
+                unsigned int granted = scheduler->requestGrant(cid, 4294967295U, terminate, active, eligible);
+                if (granted == 0 && active && carrierAvailableBlocks(nodeId, carrierFrequency) == 0)
+                {
+                    // no blocks left on this carrier: make room by preempting a non-GBR user
+                    if (!preemptNonGbr(scheduler, preemptable_[carrierFrequency]))
+                        break;
+                    terminate = false;
+                    eligible = true;
+                    granted = scheduler->requestGrant(cid, 4294967295U, terminate, active, eligible);
+                }
+                EV << NOW << " LteSchedulerEnb::scheduleMiniSlot - granted " << granted << " bytes to cid " << cid << endl;
+
+                // the next SDUs of the user come back to the top of the store, they wait for the next mini-slot
+                if (granted > 0)
+                    slotNodes_.insert(nodeId);
+            }
+            macPduMetaDataStore_.restoreSkipped();
+        }
+
+        amc->setSymbolLimit(0);
+
+        return &scheduleList_;
+    }
+
+    unsigned int LteSchedulerEnb::carrierAvailableBlocks(MacNodeId nodeId, double carrierFrequency)
+    {
+        CellInfo *cellInfo = mac_->getCellInfo();
+        unsigned int blocks = 0;
+        for (Band b = cellInfo->getCarrierStartingBand(carrierFrequency); b <= cellInfo->getCarrierLastBand(carrierFrequency); b++)
+            blocks += allocator_->availableBlocks(nodeId, MACRO, b);
+        return blocks;
+    }
+
+    bool LteSchedulerEnb::preemptNonGbr(LteScheduler *scheduler, std::set<MacNodeId> &candidates)
+    {
+        double carrierFrequency = scheduler->getCarrierFrequency();
+        CellInfo *cellInfo = mac_->getCellInfo();
+        Band firstBand = cellInfo->getCarrierStartingBand(carrierFrequency);
+        Band lastBand = cellInfo->getCarrierLastBand(carrierFrequency);
+
+        while (!candidates.empty())
+        {
+            MacNodeId nodeId = *candidates.begin();
+            candidates.erase(candidates.begin());
+
+            unsigned int blocks = 0;
+            for (Band b = firstBand; b <= lastBand; b++)
+                blocks += allocator_->removeBlocks(MACRO, b, nodeId);
+            if (blocks == 0)
+                continue;
+
+            // the slot transmission of the preempted user will be retransmitted
+            unsigned int punctured = mac_->punctureTransmission(nodeId, carrierFrequency);
+            EV << NOW << " LteSchedulerEnb::preemptNonGbr - node " << nodeId << ": " << blocks << " blocks preempted, "
+               << punctured << " codewords punctured" << endl;
+            emitStatistic(miniSlotPreemptedBlocksDlSignal_, (long)blocks);
+            return true;
+        }
+        return false;
     }
 
     ActiveSet *LteSchedulerEnb::readActiveConnections()
@@ -1109,19 +1479,29 @@ namespace simu5g
             {
                 EV << NOW << "LteSchedulerEnb::removeActiveConnections CID removed " << cid << endl;
                 it = activeConnectionSet_.erase(it);
-
-                // alaf : remove PDU metadata for this CID
-                for (auto pduMetaDataIt = macPduMetaDataSet_.begin(); pduMetaDataIt != macPduMetaDataSet_.end();)
-                {
-                    if (pduMetaDataIt->cid == cid)
-                        pduMetaDataIt = macPduMetaDataSet_.erase(pduMetaDataIt);
-                    else
-                        ++pduMetaDataIt;
-                }
             }
             else
                 ++it;
         }
+
+        // alaf : remove PDU metadata for this node
+        macPduMetaDataStore_.eraseNode(nodeId);
+
+        for (auto it = connectionFiveQi_.begin(); it != connectionFiveQi_.end();)
+        {
+            if (MacCidToNodeId(it->first) == nodeId)
+                it = connectionFiveQi_.erase(it);
+            else
+                ++it;
+        }
+
+        for (auto it = configuredGrants_.begin(); it != configuredGrants_.end();)
+        {
+            if (MacCidToNodeId(it->first) == nodeId)
+                it = configuredGrants_.erase(it);
+            else
+                ++it;
+        }
     }
 
 } // namespace
@@ -13,9 +13,14 @@
 #ifndef _LTE_LTESCHEDULERENB_H_
 #define _LTE_LTESCHEDULERENB_H_
 
+#include <memory>
+
 #include "common/LteCommon.h"
 #include "stack/mac/buffer/harq/LteHarqBufferTx.h"
 #include "stack/mac/allocator/LteAllocatorUtils.h"
+#include "stack/mac/buffer/MacPduMetaDataStore.h"
+#include "stack/mac/scheduler/ArrivalPeriodEstimator.h"
+#include "stack/mac/scheduler/SchedulerTrace.h"
 #include "stack/mac/LteMacEnb.h"
 
 namespace simu5g
@@ -41,8 +46,6 @@ namespace simu5g
     // Lte Scheduler Modules access grants
     friend class LteScheduler;
     friend class LteDrr;
-    friend class LtePf;
-    friend class LteMaxCi;
     friend class LteMaxCiMultiband;
     friend class LteMaxCiOptMB;
     friend class LteMaxCiComp;
@@ -91,8 +94,8 @@ namespace simu5g
     //! Set of active connections.
     ActiveSet activeConnectionSet_;
 
-    //! Set of MacPduMetaData
-    MacPduMetaDataList macPduMetaDataSet_;
+    //! Per-connection, deadline-indexed MacPduMetaData
+    MacPduMetaDataStore macPduMetaDataStore_;
 
     // Schedule list. One per carrier
     std::map<double, LteMacScheduleList> scheduleList_;
@@ -100,6 +103,10 @@ namespace simu5g
     // Codeword list
     LteMacAllocatedCws allocatedCws_;
 
+    // Codeword list of each carrier, used instead of allocatedCws_ by the cross-carrier NR-EDF,
+    // which may serve a UE on several carriers in the same slot
+    std::map<double, LteMacAllocatedCws> carrierAllocatedCws_;
+
     // Pointer to downlink virtual buffers (that are in LteMacBase)
     LteMacBufferMap *vbuf_ = nullptr;
 
@@ -116,11 +123,71 @@ namespace simu5g
     /// Initialized by LteMacEnb::handleSelfMessage() using resourceBlocks()
     unsigned int resourceBlocks_ = 0;
 
+    /// If true, DC-GBR SDUs whose delay budget has expired are discarded before scheduling
+    bool dropExpiredPdus_ = false;
+
+    /// If true, the NR-EDF schedulers of all the carriers are served by a single deadline-ordered pass
+    bool edfCrossCarrier_ = false;
+
+    /// If true, schedule() runs on a thread of CellSchedulingPool: statistics are kept until emitDeferredSignals()
+    bool parallel_ = false;
+
+    std::vector<std::pair<simsignal_t, double>> deferredSignals_;
+
+    /// Semi-persistent grant of a periodic DC-GBR flow
+    struct ConfiguredGrant
+    {
+        /// arrival times of the data of the flow
+        ArrivalPeriodEstimator arrivals;
+        /// bytes of the last burst
+        unsigned int burst = 0;
+        /// bytes reserved at each occasion (largest burst seen)
+        unsigned int bytes = 0;
+        /// true once the flow is periodic and the grant is configured
+        bool configured = false;
+        /// next transmission occasion
+        simtime_t nextOccasion = 0;
+        /// slot of the last served occasion
+        simtime_t servedAt = -1;
+        /// true if the flow has sent data since the last occasion
+        bool used = false;
+        /// consecutive occasions without data
+        unsigned int unused = 0;
+    };
+
+    /// occasions left unused after which a configured grant is released
+    static const unsigned int MAX_UNUSED_OCCASIONS = 4;
+
+    /// If true, periodic DC-GBR flows are served by configured grants
+    bool configuredGrant_ = false;
+
+    std::map<MacCid, ConfiguredGrant> configuredGrants_;
+
+    /// If true, mini-slot transmissions may take the blocks granted to non-GBR users in the slot
+    bool miniSlotPreemption_ = false;
+
+    /// Users granted in the ongoing slot or in its mini-slots, and per carrier the non-GBR ones that
+    /// can still be preempted. Filled from the schedule list by each mini-slot, reset by schedule()
+    std::set<MacNodeId> slotNodes_;
+    std::map<double, std::set<MacNodeId>> preemptable_;
+
+    /// 5QI of the downlink connections, as carried by their last SDU
+    std::map<MacCid, FiveQI> connectionFiveQi_;
+
+    /// Trace of the scheduler inputs, if the "schedulerTraceFile" parameter is set
+    std::unique_ptr<SchedulerTraceWriter> trace_;
+    SchedulerTraceRecord traceRecord_;
+
     /// Statistics
     static simsignal_t avgServedBlocksDlSignal_;
     static simsignal_t avgServedBlocksUlSignal_;
+    static simsignal_t expiredSduDropDlSignal_;
+    static simsignal_t miniSlotPreemptedBlocksDlSignal_;
 
-    // pre-made BandLimit structure used when no band limit is given to the scheduler
+    /// If true, blocks are tracked by LteAllocationModuleBitset
+    bool bitsetAllocator_ = false;
+
+    // BandLimit structure used when no band limit is given to the scheduler, refilled at each grant
     std::vector<BandLimit> emptyBandLim_;
 
     // @author Alessandro Noferi
@@ -153,7 +220,7 @@ namespace simu5g
      * @param mac pointer to MAC module
      * @param binder pointer to Binder module
      */
-    void initialize(Direction dir, LteMacEnb *mac, Binder *binder);
+    virtual void initialize(Direction dir, LteMacEnb *mac, Binder *binder);
 
     /*
      * Initialize counters for schedulers
@@ -276,8 +343,64 @@ namespace simu5g
 
     void removeActiveConnections(MacNodeId nodeId);
 
-    MacPduMetaDataList *readMacPduMetaDataList();
-    void insertMacPduMetaData(MacPduMetaData meta);
+    /*
+     * Getter for the MAC PDU metadata store
+     */
+    MacPduMetaDataStore *readMacPduMetaDataStore();
+
+    void insertMacPduMetaData(const MacPduMetaData &meta);
+
+    /**
+     * Records the arrival of a burst of data of a connection, so that periodic
+     * DC-GBR flows get a configured grant
+     */
+    void observeArrival(MacCid cid, FiveQI fiveQi, simtime_t arrival, unsigned int bytes);
+
+    /**
+     * Records that a connection has used its configured grant, if any
+     */
+    void confirmConfiguredGrant(MacCid cid);
+
+    /**
+     * Returns true if the backlog of the connection will be served by its configured grant
+     * before its deadline, so that dynamic scheduling can skip it
+     */
+    bool isCoveredByConfiguredGrant(MacCid cid);
+
+    /**
+     * Returns true if the most urgent head-of-line entry of the store is DC-GBR
+     */
+    bool hasMiniSlotTraffic();
+
+    /**
+     * Discards the head-of-line DC-GBR SDUs whose deadline has already passed, if enabled.
+     * Expired entries are found at the top of the MAC PDU metadata store,
+     * so that only the expired connections are visited.
+     * Called by schedule(), or by the MAC before queuing a parallel schedule, since the RLC
+     * cannot be reached from the worker threads.
+     */
+    void dropExpiredPdus();
+
+    /**
+     * Writes the inputs of the new transmissions of the carrier to the trace: free bands,
+     * active connections with their buffers, MAC PDU metadata and transmission parameters
+     */
+    void recordTrace(LteScheduler *scheduler);
+
+    /**
+     * Emits the statistics recorded by a parallel schedule()
+     */
+    void emitDeferredSignals();
+
+    /**
+     * Serves DC-GBR connections in a mini-slot of the ongoing slot, using the blocks
+     * left free by the slot schedule (and, if preemption is enabled, those of the
+     * non-GBR users scheduled in the slot). Returns one schedule list per carrier,
+     * containing the mini-slot grants only
+     *
+     * @param symbols number of OFDM symbols of the mini-slot
+     */
+    std::map<double, LteMacScheduleList> *scheduleMiniSlot(unsigned int symbols);
 
   protected:
     /**
@@ -324,16 +447,57 @@ namespace simu5g
      */
     void resourceBlockStatistics(bool sleep = false);
 
+    /**
+     * Emits the statistic from the MAC module, or keeps it for emitDeferredSignals() in parallel mode
+     */
+    template<typename T>
+    void emitStatistic(simsignal_t signal, T value)
+    {
+        if (parallel_)
+            deferredSignals_.emplace_back(signal, (double)value);
+        else
+            mac_->emit(signal, value);
+    }
+
     /**
      * Initializes the blocks-related structures allocation
      */
     void initializeAllocator();
 
+    /**
+     * Serves the configured grants whose occasion is due on the carrier of the given scheduler,
+     * before dynamic scheduling takes place
+     */
+    void scheduleConfiguredGrants(LteScheduler *scheduler);
+
+    /**
+     * Makes the bytes of a configured grant available to scheduleGrant()
+     * (used in the uplink, where no BSR precedes the occasion)
+     */
+    virtual void fillConfiguredGrant(MacCid cid, unsigned int bytes) {}
+
+    /**
+     * Frees the blocks of the first non-GBR user of the candidates that holds any
+     * on the carrier of the given scheduler, and punctures its transmission.
+     * @return TRUE if some blocks were freed
+     */
+    bool preemptNonGbr(LteScheduler *scheduler, std::set<MacNodeId> &candidates);
+
+    /**
+     * Returns the blocks of the given carrier still available to the given user
+     */
+    unsigned int carrierAvailableBlocks(MacNodeId nodeId, double carrierFrequency);
+
     /**
      * Resets the blocks-related structures allocation
      */
     void resetAllocator();
 
+    /**
+     * Creates the allocation module suited to the scheduling discipline
+     */
+    void createAllocator(SchedDiscipline discipline);
+
     /**
      * Returns the available space for a given user, antenna, logical band, and codeword, in bytes.
      *
@@ -355,9 +519,25 @@ namespace simu5g
      */
     unsigned int availableBytesBackgroundUe(const MacNodeId id, const Remote antenna, Band b, Direction dir, double carrierFrequency, int limit = -1);
 
-    unsigned int allocatedCws(MacNodeId nodeId)
+    /**
+     * Fills the band limit vector with all the bands of the cell, without limit.
+     * The storage of the vector is reused, so that no allocation takes place once it has been sized.
+     *
+     * @param bandLim band limit vector to fill
+     * @param txParams if given, the bands not allowed by these parameters are marked as unusable
+     * @param numCodewords number of codewords to set
+     */
+    void fillBandLimit(BandLimitVector &bandLim, const UserTxParams *txParams, unsigned int numCodewords);
+
+    // Codeword list to use for the given carrier
+    LteMacAllocatedCws &codewordList(double carrierFrequency)
+    {
+      return edfCrossCarrier_ ? carrierAllocatedCws_[carrierFrequency] : allocatedCws_;
+    }
+
+    unsigned int allocatedCws(MacNodeId nodeId, double carrierFrequency)
     {
-      return allocatedCws_[nodeId];
+      return codewordList(carrierFrequency)[nodeId];
     }
 
     // Get the bands already allocated
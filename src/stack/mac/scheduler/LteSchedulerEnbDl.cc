@@ -48,6 +48,9 @@ bool LteSchedulerEnbDl::checkEligibility(MacNodeId id, Codeword& cw, double carr
 unsigned int LteSchedulerEnbDl::schedulePerAcidRtx(MacNodeId nodeId, double carrierFrequency, Codeword cw, unsigned char acid,
         std::vector<BandLimit> *bandLim, Remote antenna, bool limitBl)
 {
+    // codewords already allocated in this slot
+    LteMacAllocatedCws& cws = codewordList(carrierFrequency);
+
     // Get user transmission parameters
     const UserTxParams& txParams = mac_->getAmc()->computeTxParams(nodeId, direction_, carrierFrequency);    // get the user info
     const std::set<Band>& allowedBands = txParams.readBands();
@@ -142,8 +145,8 @@ unsigned int LteSchedulerEnbDl::schedulePerAcidRtx(MacNodeId nodeId, double carr
 
     Codeword allocatedCw = 0;
     // search for already allocated codeword
-    if (allocatedCws_.find(nodeId) != allocatedCws_.end()) {
-        allocatedCw = allocatedCws_.at(nodeId);
+    if (cws.find(nodeId) != cws.end()) {
+        allocatedCw = cws.at(nodeId);
     }
     // for each band
     unsigned int size = bandLim->size();
@@ -242,11 +245,11 @@ unsigned int LteSchedulerEnbDl::schedulePerAcidRtx(MacNodeId nodeId, double carr
     currHarq->markSelected(signal, codewords);
 
     // mark codeword as used
-    if (allocatedCws_.find(nodeId) != allocatedCws_.end()) {
-        allocatedCws_.at(nodeId)++;
+    if (cws.find(nodeId) != cws.end()) {
+        cws.at(nodeId)++;
     }
     else {
-        allocatedCws_[nodeId] = 1;
+        cws[nodeId] = 1;
     }
 
     bytes = currHarq->pduLength(acid, cw);
@@ -258,6 +261,9 @@ unsigned int LteSchedulerEnbDl::schedulePerAcidRtx(MacNodeId nodeId, double carr
 
 unsigned int LteSchedulerEnbDl::scheduleBgRtx(MacNodeId bgUeId, double carrierFrequency, Codeword cw, std::vector<BandLimit> *bandLim, Remote antenna, bool limitBl)
 {
+    // codewords already allocated in this slot
+    LteMacAllocatedCws& cws = codewordList(carrierFrequency);
+
     try {
         IBackgroundTrafficManager *bgTrafficManager = mac_->getBackgroundTrafficManager(carrierFrequency);
         unsigned int bytesPerBlock = bgTrafficManager->getBackloggedUeBytesPerBlock(bgUeId, direction_);
@@ -367,10 +373,10 @@ unsigned int LteSchedulerEnbDl::scheduleBgRtx(MacNodeId bgUeId, double carrierFr
             // signal a retransmission
 
             // mark codeword as used
-            if (allocatedCws_.find(bgUeId) != allocatedCws_.end())
-                allocatedCws_.at(bgUeId)++;
+            if (cws.find(bgUeId) != cws.end())
+                cws.at(bgUeId)++;
             else
-                allocatedCws_[bgUeId] = 1;
+                cws[bgUeId] = 1;
 
             EV << NOW << " LteSchedulerEnbDl::scheduleBgRtx: " << allocatedBytes << " bytes served! " << endl;
 
@@ -385,6 +391,9 @@ unsigned int LteSchedulerEnbDl::scheduleBgRtx(MacNodeId bgUeId, double carrierFr
 
 bool LteSchedulerEnbDl::rtxschedule(double carrierFrequency, BandLimitVector *bandLim)
 {
+    // codewords already allocated in this slot
+    LteMacAllocatedCws& cws = codewordList(carrierFrequency);
+
     EV << NOW << " LteSchedulerEnbDl::rtxschedule --------------------::[ START RTX-SCHEDULE ]::--------------------" << endl;
     EV << NOW << " LteSchedulerEnbDl::rtxschedule Cell:  " << mac_->getMacCellId() << " Direction: " << (direction_ == DL ? "DL" : "UL") << endl;
 
@@ -420,11 +429,11 @@ bool LteSchedulerEnbDl::rtxschedule(double carrierFrequency, BandLimitVector *ba
                 // for each HARQ process
                 LteHarqProcessTx *currProc = (*processes)[process];
 
-                if (allocatedCws_[nodeId] == codewords)
+                if (cws[nodeId] == codewords)
                     break;
                 for (Codeword cw = 0; cw < codewords; ++cw) {
 
-                    if (allocatedCws_[nodeId] == codewords)
+                    if (cws[nodeId] == codewords)
                         break;
                     EV << NOW << " LteSchedulerEnbDl::rtxschedule process " << process << endl;
 
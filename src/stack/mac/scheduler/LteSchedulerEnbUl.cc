@@ -14,6 +14,7 @@
 #include "stack/mac/LteMacEnbD2D.h"
 #include "stack/mac/buffer/harq/LteHarqBufferRx.h"
 #include "stack/mac/allocator/LteAllocationModule.h"
+#include "stack/mac/buffer/LteMacBuffer.h"
 #include "stack/phy/LtePhyBase.h"
 
 namespace simu5g {
@@ -939,5 +940,11 @@ void LteSchedulerEnbUl::removePendingRac(MacNodeId nodeId)
     }
 }
 
-} //namespace
+void LteSchedulerEnbUl::fillConfiguredGrant(MacCid cid, unsigned int bytes)
+{
+    auto it = bsrbuf_->find(cid);
+    if (it != bsrbuf_->end() && it->second->isEmpty())
+        it->second->pushBack(PacketInfo(bytes, NOW));
+}
 
+} //namespace
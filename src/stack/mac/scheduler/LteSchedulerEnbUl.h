@@ -47,6 +47,12 @@ class LteSchedulerEnbUl : public LteSchedulerEnb
     //! RAC request flags: signals whether a UE shall be granted the RAC allocation
     std::map<double, RacStatus> racStatus_;
 
+    /**
+     * Books the bytes of a configured grant in the BSR buffer of the connection,
+     * unless the UE has already reported a backlog
+     */
+    void fillConfiguredGrant(MacCid cid, unsigned int bytes) override;
+
   public:
 
     //! Updates HARQ descriptor current process pointer (to be called every TTI by main loop).
@@ -105,6 +111,17 @@ class LteSchedulerEnbUl : public LteSchedulerEnb
             Remote antenna = MACRO, bool limitBl = false) override;
 
     void removePendingRac(MacNodeId nodeId);
+
+    /**
+     * signals the reception of a BSR reporting the given backlog (called by e/gNb before
+     * the BSR buffer is updated)
+     */
+    virtual void signalBsr(MacCid cid, unsigned int bytes, simtime_t timestamp) {}
+
+    /**
+     * signals the reception of uplink data from a UE, with the 5QI of its bearer (0 if unknown)
+     */
+    virtual void signalUplinkData(MacNodeId nodeId, FiveQI fiveQi) {}
 };
 
 } //namespace
@@ -0,0 +1,39 @@
+//
+//                  Simu5G-NR-EDF (Extension of Simu5G)
+//
+// Original Authors: Giovanni Nardini, Giovanni Stea, Antonio Virdis (University of Pisa)
+// Extension Authors: Alaf Nascimento, Philippe Martins, Samuel Tardieu, Laurent Pautet (Institut Polytechnique de Paris)
+//
+// This file is part of a software released under the license included in file
+// "license.pdf". Please read LICENSE and README files before using it.
+// The above files and the present reference are part of the software itself,
+// and cannot be removed from it.
+//
+
+#include <omnetpp.h>
+
+#include "stack/mac/scheduler/LteSchedulerFactory.h"
+
+namespace simu5g {
+
+using namespace omnetpp;
+
+std::map<std::string, LteSchedulerFactory::Creator>& LteSchedulerFactory::registry()
+{
+    static std::map<std::string, Creator> creators;
+    return creators;
+}
+
+void LteSchedulerFactory::registerScheduler(const std::string& name, Creator creator)
+{
+    if (!registry().emplace(name, creator).second)
+        throw cRuntimeError("LteSchedulerFactory::registerScheduler - scheduler \"%s\" already registered", name.c_str());
+}
+
+LteScheduler *LteSchedulerFactory::create(const std::string& name, Binder *binder)
+{
+    auto it = registry().find(name);
+    return (it == registry().end()) ? nullptr : it->second(binder);
+}
+
+} //namespace
@@ -0,0 +1,74 @@
+//
+//                  Simu5G-NR-EDF (Extension of Simu5G)
+//
+// Original Authors: Giovanni Nardini, Giovanni Stea, Antonio Virdis (University of Pisa)
+// Extension Authors: Alaf Nascimento, Philippe Martins, Samuel Tardieu, Laurent Pautet (Institut Polytechnique de Paris)
+//
+// This file is part of a software released under the license included in file
+// "license.pdf". Please read LICENSE and README files before using it.
+// The above files and the present reference are part of the software itself,
+// and cannot be removed from it.
+//
+
+#ifndef _LTE_LTESCHEDULERFACTORY_H_
+#define _LTE_LTESCHEDULERFACTORY_H_
+
+#include <map>
+#include <string>
+
+namespace simu5g {
+
+class Binder;
+class LteScheduler;
+
+/**
+ * Registry of the scheduling policies that are not part of the SchedDiscipline enum.
+ *
+ * A policy registers itself under the name used in the "schedulingDisciplineDl/Ul" parameters of the
+ * MAC, with the Register_LteScheduler() macro. LteSchedulerEnb::getScheduler() looks the name up here
+ * when it is not a built-in discipline. Policies built on MetricScheduler do not need any friend
+ * declaration in LteSchedulerEnb.
+ */
+class LteSchedulerFactory
+{
+  public:
+    typedef LteScheduler *(*Creator)(Binder *binder);
+
+  protected:
+    /// registered policies, a function-local static so that registration order does not matter
+    static std::map<std::string, Creator>& registry();
+
+  public:
+    /**
+     * Registers a policy. Throws if the name is already taken.
+     */
+    static void registerScheduler(const std::string& name, Creator creator);
+
+    /**
+     * Creates the policy registered under the given name, nullptr if there is none.
+     */
+    static LteScheduler *create(const std::string& name, Binder *binder);
+
+    /**
+     * Registers a policy when constructed, see Register_LteScheduler().
+     */
+    struct Registrar
+    {
+        Registrar(const char *name, Creator creator) { registerScheduler(name, creator); }
+    };
+};
+
+#define LTE_SCHEDULER_CONCAT2(a, b)    a##b
+#define LTE_SCHEDULER_CONCAT(a, b)     LTE_SCHEDULER_CONCAT2(a, b)
+
+/**
+ * Registers the LteScheduler subclass CLASSNAME, constructible from a Binder pointer, under NAME.
+ * To be used in a .cc file.
+ */
+#define Register_LteScheduler(NAME, CLASSNAME) \
+    static simu5g::LteSchedulerFactory::Registrar LTE_SCHEDULER_CONCAT(lteSchedulerRegistrar_, __LINE__)( \
+            NAME, [](simu5g::Binder *binder) -> simu5g::LteScheduler * { return new CLASSNAME(binder); })
+
+} //namespace
+
+#endif
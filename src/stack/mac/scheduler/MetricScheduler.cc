@@ -0,0 +1,98 @@
+//
+//                  Simu5G-NR-EDF (Extension of Simu5G)
+//
+// Original Authors: Giovanni Nardini, Giovanni Stea, Antonio Virdis (University of Pisa)
+// Extension Authors: Alaf Nascimento, Philippe Martins, Samuel Tardieu, Laurent Pautet (Institut Polytechnique de Paris)
+//
+// This file is part of a software released under the license included in file
+// "license.pdf". Please read LICENSE and README files before using it.
+// The above files and the present reference are part of the software itself,
+// and cannot be removed from it.
+//
+
+#include "stack/mac/scheduler/MetricScheduler.h"
+#include "stack/mac/scheduler/LteSchedulerEnb.h"
+#include "stack/backgroundTrafficGenerator/IBackgroundTrafficManager.h"
+
+namespace simu5g {
+
+using namespace omnetpp;
+
+void MetricSchedulerBase::beginPeriod()
+{
+    activeConnectionTempSet_ = *activeConnectionSet_;
+    scores_ = {};
+}
+
+bool MetricSchedulerBase::viewConnection(MacCid cid, ConnectionView& view)
+{
+    MacNodeId nodeId = MacCidToNodeId(cid);
+    if (nodeId == NODEID_NONE || binder_->getOmnetId(nodeId) == 0) {
+        // node has left the simulation - erase corresponding CIDs
+        activeConnectionSet_->erase(cid);
+        activeConnectionTempSet_.erase(cid);
+        carrierActiveConnectionSet_.erase(cid);
+        return false;
+    }
+    return readConnectionView(cid, view);
+}
+
+void MetricSchedulerBase::addScore(MacCid cid, double score)
+{
+    scores_.push(ScoreDesc(cid, score));
+}
+
+void MetricSchedulerBase::collectBackgroundUes()
+{
+    backgroundUes_.clear();
+
+    // D2D background traffic not supported
+    if (direction_ != UL && direction_ != DL)
+        return;
+
+    IBackgroundTrafficManager *bgTrafficManager = mac_->getBackgroundTrafficManager(carrierFrequency_);
+    for (auto it = bgTrafficManager->getBackloggedUesBegin(direction_); it != bgTrafficManager->getBackloggedUesEnd(direction_); ++it) {
+        MacNodeId bgUeId = BGUE_MIN_ID + *it;
+
+        // the cid of a background UE is its id in the 16 most significant bits, with lcid 0
+        MacCid bgCid = num(bgUeId) << 16;
+        backgroundUes_.emplace_back(bgCid, bgTrafficManager->getBackloggedUeBytesPerBlock(bgUeId, direction_));
+    }
+}
+
+unsigned int MetricSchedulerBase::grantNext(bool& terminate)
+{
+    const ScoreDesc current = scores_.top();
+    bool background = MacCidToNodeId(current.x_) >= BGUE_MIN_ID;
+
+    bool active = true;
+    bool eligible = true;
+    unsigned int granted;
+    if (background)
+        granted = requestGrantBackground(current.x_, 4294967295U, terminate, active, eligible);
+    else
+        granted = requestGrant(current.x_, 4294967295U, terminate, active, eligible);
+
+    EV << NOW << " MetricScheduler::prepareSchedule granted " << granted << " bytes to connection " << current.x_
+       << " with score " << current.score_ << endl;
+
+    if (terminate)
+        return granted;
+
+    // pop the descriptor if the active or eligible flag are clear
+    if (!active || !eligible)
+        scores_.pop();
+    if (!active && !background) {
+        carrierActiveConnectionSet_.erase(current.x_);
+        activeConnectionTempSet_.erase(current.x_);
+    }
+
+    return granted;
+}
+
+unsigned int MetricSchedulerBase::totalBlocks() const
+{
+    return eNbScheduler_->getResourceBlocks();
+}
+
+} //namespace
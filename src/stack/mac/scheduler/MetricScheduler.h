@@ -0,0 +1,135 @@
+//
+//                  Simu5G-NR-EDF (Extension of Simu5G)
+//
+// Original Authors: Giovanni Nardini, Giovanni Stea, Antonio Virdis (University of Pisa)
+// Extension Authors: Alaf Nascimento, Philippe Martins, Samuel Tardieu, Laurent Pautet (Institut Polytechnique de Paris)
+//
+// This file is part of a software released under the license included in file
+// "license.pdf". Please read LICENSE and README files before using it.
+// The above files and the present reference are part of the software itself,
+// and cannot be removed from it.
+//
+
+#ifndef _LTE_METRICSCHEDULER_H_
+#define _LTE_METRICSCHEDULER_H_
+
+#include <queue>
+#include <vector>
+
+#include "stack/mac/scheduler/LteScheduler.h"
+#include "stack/mac/scheduler/LteSchedulerFactory.h"
+
+namespace simu5g {
+
+/**
+ * Non-template part of MetricScheduler: the per-connection bookkeeping shared by the score-based
+ * policies (node-left cleanup, filtering of the connections that cannot be served, rate estimation)
+ * and the grant loop in score order.
+ */
+class MetricSchedulerBase : public LteScheduler
+{
+  protected:
+    typedef SortedDesc<MacCid, double> ScoreDesc;
+
+    /// connections to serve in the current period, ties between equal scores are broken at random
+    std::priority_queue<ScoreDesc> scores_;
+
+    /// backlogged background UEs of the current period: cid and bytes per block
+    std::vector<std::pair<MacCid, int>> backgroundUes_;
+
+    /// Starts the period: working copy of the active set, empty score list.
+    void beginPeriod();
+
+    /**
+     * Fills the view of the connection, see LteScheduler::readConnectionView(). Connections of nodes
+     * that left the simulation are removed from the active sets.
+     *
+     * @return false if the connection cannot be served in this period
+     */
+    bool viewConnection(MacCid cid, ConnectionView& view);
+
+    void addScore(MacCid cid, double score);
+
+    /// Fills backgroundUes_ with the backlogged background UEs of the carrier.
+    void collectBackgroundUes();
+
+    /**
+     * Grants the connection on top of scores_, which is popped when it has been served.
+     *
+     * @return granted bytes
+     */
+    unsigned int grantNext(bool& terminate);
+
+    /// Total number of blocks of the carrier, for the rate computations.
+    unsigned int totalBlocks() const;
+
+  public:
+    MetricSchedulerBase(Binder *binder) : LteScheduler(binder) {}
+};
+
+/**
+ * Score-based scheduler whose policy is given by the Metric type.
+ *
+ * The connections of the carrier are scored by the metric, then served in decreasing score order.
+ * Metric is called directly (no virtual call per connection) and must provide:
+ *
+ *   static constexpr bool servesBackground;                  // whether background UEs are scheduled
+ *   void initialize(LteMacEnb *mac);                          // reads the parameters of the policy
+ *   double score(const ConnectionView& connection);          // score of a connection, higher first
+ *   double backgroundScore(int bytesPerBlock);               // only used if servesBackground
+ *   void granted(MacCid cid, unsigned int bytes);            // bytes granted to a connection
+ *   void commit(unsigned int totalBlocks);                   // end of the scheduling period
+ *
+ * A new policy is thus a metric plus one Register_LteScheduler() line, see SchedulingMetrics.h.
+ */
+template<typename Metric>
+class MetricScheduler : public MetricSchedulerBase
+{
+  protected:
+    Metric metric_;
+
+  public:
+    MetricScheduler(Binder *binder) : MetricSchedulerBase(binder) {}
+
+    void setEnbScheduler(LteSchedulerEnb *eNbScheduler) override
+    {
+        MetricSchedulerBase::setEnbScheduler(eNbScheduler);
+        metric_.initialize(mac_.get());
+    }
+
+    void prepareSchedule() override
+    {
+        beginPeriod();
+
+        ConnectionView view;
+        for (MacCid cid : carrierActiveConnectionSet_) {
+            if (viewConnection(cid, view))
+                addScore(cid, metric_.score(view));
+        }
+
+        if constexpr (Metric::servesBackground) {
+            collectBackgroundUes();
+            for (const auto& [bgCid, bytesPerBlock] : backgroundUes_)
+                addScore(bgCid, metric_.backgroundScore(bytesPerBlock));
+        }
+
+        bool terminate = false;
+        while (!scores_.empty() && !terminate) {
+            MacCid cid = scores_.top().x_;
+            unsigned int granted = grantNext(terminate);
+            metric_.granted(cid, granted);
+        }
+    }
+
+    void commitSchedule() override
+    {
+        metric_.commit(totalBlocks());
+        *activeConnectionSet_ = activeConnectionTempSet_;
+    }
+
+    Metric& metric() { return metric_; }
+};
+
+} //namespace
+
+#endif
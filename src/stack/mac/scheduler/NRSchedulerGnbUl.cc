@@ -13,9 +13,161 @@
 #include "stack/mac/NRMacGnb.h"
 #include "stack/mac/buffer/harq/LteHarqBufferRx.h"
 #include "stack/mac/allocator/LteAllocationModule.h"
+#include "stack/mac/buffer/LteMacBuffer.h"
 
 namespace simu5g {
 
+void NRSchedulerGnbUl::initialize(Direction dir, LteMacEnb *mac, Binder *binder)
+{
+    LteSchedulerEnbUl::initialize(dir, mac, binder);
+
+    edfDeadlines_ = mac_->getSchedDiscipline(direction_) == EDF;
+    preGrant_ = edfDeadlines_ && mac_->par("edfUplinkPreGrant").boolValue();
+    defaultFiveQi_ = mac_->par("edfUplinkFiveQI").intValue();
+}
+
+std::map<double, LteMacScheduleList> *NRSchedulerGnbUl::schedule()
+{
+    if (preGrant_)
+        preIssueGrants();
+    return LteSchedulerEnbUl::schedule();
+}
+
+void NRSchedulerGnbUl::signalRac(MacNodeId nodeId, double carrierFrequency)
+{
+    // the data that triggered the RAC request arrived before it
+    if (edfDeadlines_ && racTime_.find(nodeId) == racTime_.end())
+        racTime_[nodeId] = NOW;
+    LteSchedulerEnbUl::signalRac(nodeId, carrierFrequency);
+}
+
+void NRSchedulerGnbUl::signalUplinkData(MacNodeId nodeId, FiveQI fiveQi)
+{
+    if (!edfDeadlines_)
+        return;
+
+    // BSRs are reported on LCID 0
+    MacCid cid = idToMacCid(nodeId, 0);
+    UlFlowInfo& flow = ulFlows_[cid];
+    if (fiveQi != 0)
+        flow.fiveQi = fiveQi;
+    flow.unconfirmedPreGrants = 0;
+    confirmConfiguredGrant(cid);
+}
+
+void NRSchedulerGnbUl::syncUlFlow(MacCid cid, UlFlowInfo& flow)
+{
+    unsigned int stored = macPduMetaDataStore_.size(cid);
+    while (flow.bursts.size() > stored) {
+        flow.backlog -= flow.bursts.front();
+        flow.bursts.pop_front();
+    }
+}
+
+void NRSchedulerGnbUl::addBurst(MacCid cid, UlFlowInfo& flow, unsigned int bytes, simtime_t arrival, bool predicted)
+{
+    MacPduMetaData meta;
+    meta.cid = cid;
+    meta.fiveQi = (flow.fiveQi != 0) ? flow.fiveQi : defaultFiveQi_;
+    meta.arrivalTime = arrival;
+    macPduMetaDataStore_.push(meta);
+
+    flow.bursts.push_back(bytes);
+    flow.backlog += bytes;
+    flow.lastBurst = bytes;
+
+    if (predicted)
+        flow.arrivals.predict(arrival);
+    else {
+        flow.arrivals.update(arrival);
+        flow.unconfirmedPreGrants = 0;
+        observeArrival(cid, meta.fiveQi, arrival, bytes);
+    }
+
+    EV << NOW << " NRSchedulerGnbUl::addBurst - cid " << cid << " burst " << bytes << " bytes, arrival " << arrival
+       << (predicted ? " (predicted)" : "") << ", period " << flow.arrivals.getPeriod() << " (" << flow.arrivals.getHits() << " hits)" << endl;
+}
+
+void NRSchedulerGnbUl::signalBsr(MacCid cid, unsigned int bytes, simtime_t timestamp)
+{
+    if (!edfDeadlines_)
+        return;
+
+    MacNodeId nodeId = MacCidToNodeId(cid);
+    UlFlowInfo& flow = ulFlows_[cid];
+    syncUlFlow(cid, flow);
+
+    if (bytes == 0) {
+        macPduMetaDataStore_.erase(cid);
+        flow.bursts.clear();
+        flow.backlog = 0;
+    }
+    else if (bytes < flow.backlog) {
+        // the oldest bursts have been served
+        unsigned int served = flow.backlog - bytes;
+        while (served > 0 && !flow.bursts.empty()) {
+            unsigned int& oldest = flow.bursts.front();
+            if (oldest > served) {
+                oldest -= served;
+                flow.backlog -= served;
+                break;
+            }
+            served -= oldest;
+            flow.backlog -= oldest;
+            flow.bursts.pop_front();
+            macPduMetaDataStore_.popFront(cid);
+        }
+    }
+    else if (bytes > flow.backlog) {
+        // new data arrived at the UE no later than the BSR was made, and before
+        // the RAC request that was sent to obtain the grant for it, if any
+        simtime_t arrival = (timestamp > 0 && timestamp < NOW) ? timestamp : NOW;
+        auto rit = racTime_.find(nodeId);
+        if (rit != racTime_.end() && rit->second < arrival)
+            arrival = rit->second;
+        addBurst(cid, flow, bytes - flow.backlog, arrival, false);
+    }
+    racTime_.erase(nodeId);
+}
+
+void NRSchedulerGnbUl::preIssueGrants()
+{
+    for (auto it = ulFlows_.begin(); it != ulFlows_.end();) {
+        MacCid cid = it->first;
+        UlFlowInfo& flow = it->second;
+        MacNodeId nodeId = MacCidToNodeId(cid);
+        if (binder_->getOmnetId(nodeId) == 0) {
+            // UE has left the simulation
+            racTime_.erase(nodeId);
+            it = ulFlows_.erase(it);
+            continue;
+        }
+        ++it;
+
+        if (!flow.arrivals.isPeriodic() || flow.arrivals.getNextArrival() > NOW)
+            continue;
+
+        if (flow.unconfirmedPreGrants >= MAX_UNCONFIRMED_PREGRANTS) {
+            EV << NOW << " NRSchedulerGnbUl::preIssueGrants - cid " << cid << " no longer periodic" << endl;
+            flow.arrivals.reset();
+            continue;
+        }
+
+        // the next burst is due: book its bytes as if a BSR had reported them,
+        // unless the UE still has a reported backlog to be served
+        auto bit = bsrbuf_->find(cid);
+        if (bit == bsrbuf_->end() || !bit->second->isEmpty())
+            continue;
+
+        syncUlFlow(cid, flow);
+        simtime_t arrival = flow.arrivals.getNextArrival();
+        bit->second->pushBack(PacketInfo(flow.lastBurst, arrival));
+        addBurst(cid, flow, flow.lastBurst, arrival, true);
+        flow.unconfirmedPreGrants++;
+        backlog(cid);
+    }
+}
+
 bool NRSchedulerGnbUl::checkEligibility(MacNodeId id, Codeword& cw, double carrierFrequency)
 {
     HarqRxBuffers *harqRxBuff = mac_->getHarqRxBuffers(carrierFrequency);
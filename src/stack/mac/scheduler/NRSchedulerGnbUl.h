@@ -13,6 +13,8 @@
 #define _NRSCHEDULER_GNB_UL_H_
 
 #include "stack/mac/scheduler/LteSchedulerEnbUl.h"
+#include "stack/mac/scheduler/ArrivalPeriodEstimator.h"
+#include "common/RingBuffer.h"
 
 namespace simu5g {
 
@@ -20,11 +22,73 @@ namespace simu5g {
  * @class NRSchedulerGnbUl
  *
  * NR gNB uplink scheduler.
+ *
+ * With the EDF discipline, the gNB has no per-packet arrival times for the uplink:
+ * each increase of the backlog reported by a BSR is recorded as a burst, whose arrival
+ * time is estimated from the BSR (or from the preceding RAC request) and whose deadline
+ * follows from the 5QI of the bearer. Bursts are stored as MAC PDU metadata, so that
+ * NrEDF schedules uplink grants by earliest deadline as in the downlink.
+ * Flows whose bursts arrive periodically can be granted at the predicted arrival time,
+ * without waiting for the RAC/BSR exchange.
  */
 class NRSchedulerGnbUl : public LteSchedulerEnbUl
 {
+  protected:
+    struct UlFlowInfo
+    {
+        /// 5QI of the bearer (0 if unknown)
+        FiveQI fiveQi = 0;
+        /// bytes of the backlog increments, aligned with the metadata entries of the flow
+        RingBuffer<unsigned int> bursts;
+        /// sum of the bursts
+        unsigned int backlog = 0;
+        /// size of the last burst
+        unsigned int lastBurst = 0;
+        /// (estimated) arrival times of the bursts
+        ArrivalPeriodEstimator arrivals;
+        /// grants issued ahead of a BSR and not yet followed by uplink data
+        unsigned int unconfirmedPreGrants = 0;
+    };
+
+    /// pre-issued grants left unused after which the flow is no longer considered periodic
+    static const unsigned int MAX_UNCONFIRMED_PREGRANTS = 4;
+
+    /// If true, uplink deadlines are derived from the BSRs (EDF discipline)
+    bool edfDeadlines_ = false;
+
+    /// If true, periodic flows are granted at the predicted arrival of their next burst
+    bool preGrant_ = false;
+
+    /// 5QI of the uplink bearers whose data do not carry one
+    FiveQI defaultFiveQi_ = 0;
+
+    std::map<MacCid, UlFlowInfo> ulFlows_;
+
+    /// reception time of the last RAC request of each UE, until its first BSR
+    std::map<MacNodeId, simtime_t> racTime_;
+
+    /// drops the bursts whose metadata have been removed by the scheduler
+    void syncUlFlow(MacCid cid, UlFlowInfo& flow);
+
+    /// records a new burst of the given size and estimated arrival time
+    void addBurst(MacCid cid, UlFlowInfo& flow, unsigned int bytes, simtime_t arrival, bool predicted);
+
+    /// issues the grants of the periodic flows whose next burst is due
+    void preIssueGrants();
+
   public:
 
+    void initialize(Direction dir, LteMacEnb *mac, Binder *binder) override;
+
+    std::map<double, LteMacScheduleList> *schedule() override;
+
+    void signalRac(MacNodeId nodeId, double carrierFrequency) override;
+
+    void signalBsr(MacCid cid, unsigned int bytes, simtime_t timestamp) override;
+
+    void signalUplinkData(MacNodeId nodeId, FiveQI fiveQi) override;
+
+
     // does nothing with asynchronous H-ARQ
     void updateHarqDescs() override {}
 
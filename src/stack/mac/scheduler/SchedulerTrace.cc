@@ -0,0 +1,162 @@
+//
+//                  Simu5G-NR-EDF (Extension of Simu5G)
+//
+// Original Authors: Giovanni Nardini, Giovanni Stea, Antonio Virdis (University of Pisa)
+// Extension Authors: Alaf Nascimento, Philippe Martins, Samuel Tardieu, Laurent Pautet (Institut Polytechnique de Paris)
+//
+// This file is part of a software released under the license included in file
+// "license.pdf". Please read LICENSE and README files before using it.
+// The above files and the present reference are part of the software itself,
+// and cannot be removed from it.
+//
+
+#include <cstring>
+
+#include "stack/mac/scheduler/SchedulerTrace.h"
+
+namespace simu5g {
+
+using namespace omnetpp;
+
+static const char traceMagic[8] = {'S', '5', 'G', 'S', 'C', 'H', 'T', 'R'};
+
+void SchedulerTraceWriter::open(const std::string& fileName, const SchedulerTraceHeader& header)
+{
+    out_.open(fileName, std::ios::binary | std::ios::trunc);
+    if (!out_)
+        throw cRuntimeError("SchedulerTraceWriter::open - cannot create \"%s\"", fileName.c_str());
+
+    buffer_.clear();
+    put(traceMagic, sizeof(traceMagic));
+    put<uint32_t>(SchedulerTraceHeader::version);
+    put<uint8_t>(header.direction);
+    put<uint16_t>(num(header.cellId));
+    put<uint16_t>(header.numBands);
+    out_.write(buffer_.data(), buffer_.size());
+}
+
+void SchedulerTraceWriter::write(const SchedulerTraceRecord& record)
+{
+    buffer_.clear();
+    put<double>(record.time);
+    put<double>(record.carrierFrequency);
+    put<uint8_t>(record.numerologyIndex);
+
+    put<uint16_t>(record.freeBands.size());
+    uint8_t bits = 0;
+    for (size_t b = 0; b < record.freeBands.size(); b++) {
+        if (record.freeBands[b])
+            bits |= 1 << (b % 8);
+        if (b % 8 == 7 || b + 1 == record.freeBands.size()) {
+            put<uint8_t>(bits);
+            bits = 0;
+        }
+    }
+
+    put<uint32_t>(record.connections.size());
+    for (const auto& connection : record.connections) {
+        put<uint32_t>(connection.cid);
+        put<uint32_t>(connection.bufferedBytes);
+        put<uint32_t>(connection.bufferedSdus);
+        put<uint32_t>(connection.headSduBytes);
+        put<uint32_t>(connection.pendingPdus);
+        if (connection.pendingPdus > 0) {
+            put<uint16_t>(connection.fiveQi);
+            put<double>(connection.arrivalTime);
+            put<double>(connection.deadline);
+        }
+        put<uint8_t>(connection.cqi.size());
+        for (uint8_t cqi : connection.cqi)
+            put<uint8_t>(cqi);
+        put<uint16_t>(connection.bands.size());
+        for (const auto& [band, bytes] : connection.bands) {
+            put<uint16_t>(band);
+            put<uint32_t>(bytes);
+        }
+    }
+
+    uint32_t length = buffer_.size();
+    out_.write(reinterpret_cast<const char *>(&length), sizeof(length));
+    out_.write(buffer_.data(), buffer_.size());
+}
+
+void SchedulerTraceReader::get(void *data, size_t size)
+{
+    if (pos_ + size > buffer_.size())
+        throw cRuntimeError("SchedulerTraceReader - truncated record");
+    memcpy(data, buffer_.data() + pos_, size);
+    pos_ += size;
+}
+
+void SchedulerTraceReader::open(const std::string& fileName, SchedulerTraceHeader& header)
+{
+    in_.open(fileName, std::ios::binary);
+    if (!in_)
+        throw cRuntimeError("SchedulerTraceReader::open - cannot open \"%s\"", fileName.c_str());
+
+    const size_t headerSize = sizeof(traceMagic) + sizeof(uint32_t) + sizeof(uint8_t) + 2 * sizeof(uint16_t);
+    buffer_.resize(headerSize);
+    pos_ = 0;
+    if (!in_.read(&buffer_[0], headerSize) || memcmp(buffer_.data(), traceMagic, sizeof(traceMagic)) != 0)
+        throw cRuntimeError("SchedulerTraceReader::open - \"%s\" is not a scheduler trace", fileName.c_str());
+    pos_ = sizeof(traceMagic);
+
+    uint32_t version = get<uint32_t>();
+    if (version != SchedulerTraceHeader::version)
+        throw cRuntimeError("SchedulerTraceReader::open - \"%s\" has version %u, %u expected", fileName.c_str(), version, SchedulerTraceHeader::version);
+    header.direction = static_cast<Direction>(get<uint8_t>());
+    header.cellId = MacNodeId(get<uint16_t>());
+    header.numBands = get<uint16_t>();
+}
+
+bool SchedulerTraceReader::next(SchedulerTraceRecord& record)
+{
+    uint32_t length;
+    if (!in_.read(reinterpret_cast<char *>(&length), sizeof(length)))
+        return false;
+    buffer_.resize(length);
+    pos_ = 0;
+    if (!in_.read(&buffer_[0], length))
+        throw cRuntimeError("SchedulerTraceReader::next - truncated trace");
+
+    record.time = get<double>();
+    record.carrierFrequency = get<double>();
+    record.numerologyIndex = get<uint8_t>();
+
+    record.freeBands.resize(get<uint16_t>());
+    uint8_t bits = 0;
+    for (size_t b = 0; b < record.freeBands.size(); b++) {
+        if (b % 8 == 0)
+            bits = get<uint8_t>();
+        record.freeBands[b] = (bits >> (b % 8)) & 1;
+    }
+
+    record.connections.resize(get<uint32_t>());
+    for (auto& connection : record.connections) {
+        connection.cid = get<uint32_t>();
+        connection.bufferedBytes = get<uint32_t>();
+        connection.bufferedSdus = get<uint32_t>();
+        connection.headSduBytes = get<uint32_t>();
+        connection.pendingPdus = get<uint32_t>();
+        if (connection.pendingPdus > 0) {
+            connection.fiveQi = get<uint16_t>();
+            connection.arrivalTime = get<double>();
+            connection.deadline = get<double>();
+        }
+        else {
+            connection.fiveQi = 0;
+            connection.arrivalTime = connection.deadline = 0;
+        }
+        connection.cqi.resize(get<uint8_t>());
+        for (auto& cqi : connection.cqi)
+            cqi = get<uint8_t>();
+        connection.bands.resize(get<uint16_t>());
+        for (auto& [band, bytes] : connection.bands) {
+            band = get<uint16_t>();
+            bytes = get<uint32_t>();
+        }
+    }
+    return true;
+}
+
+} //namespace
@@ -0,0 +1,131 @@
+//
+//                  Simu5G-NR-EDF (Extension of Simu5G)
+//
+// Original Authors: Giovanni Nardini, Giovanni Stea, Antonio Virdis (University of Pisa)
+// Extension Authors: Alaf Nascimento, Philippe Martins, Samuel Tardieu, Laurent Pautet (Institut Polytechnique de Paris)
+//
+// This file is part of a software released under the license included in file
+// "license.pdf". Please read LICENSE and README files before using it.
+// The above files and the present reference are part of the software itself,
+// and cannot be removed from it.
+//
+
+#ifndef _LTE_SCHEDULERTRACE_H_
+#define _LTE_SCHEDULERTRACE_H_
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "common/LteCommon.h"
+
+namespace simu5g {
+
+/**
+ * Binary trace of the inputs of the eNB/gNB scheduler, one record per carrier and scheduling period.
+ *
+ * The file starts with a header (magic "S5GSCHTR", version, direction, cell id, number of bands of the
+ * cell), followed by the records. Each record is prefixed by its length in bytes, so that a reader can
+ * skip it. The fields are fixed width, in host byte order:
+ *
+ *   record: time (double, s), carrier frequency (double, GHz), numerology (u8),
+ *           free bands (u16 count + bitmap, one bit per band of the cell), connections (u32 count + entries)
+ *   entry:  cid (u32), buffered bytes (u32), buffered SDUs (u32), head SDU bytes (u32),
+ *           pending metadata (u32), then if non zero: 5QI (u16), arrival time and deadline (double, s),
+ *           CQI per codeword (u8 count + u8), allowed bands (u16 count + band u16, bytes on one block u32)
+ *
+ * Written by LteSchedulerEnb when the "schedulerTraceFile" parameter of the MAC is set, and read by the
+ * replay tool in tools/replay.
+ */
+struct SchedulerTraceHeader
+{
+    static constexpr uint32_t version = 1;
+
+    Direction direction = DL;
+    MacNodeId cellId = NODEID_NONE;
+    uint16_t numBands = 0;
+};
+
+struct SchedulerTraceConnection
+{
+    MacCid cid = 0;
+    uint32_t bufferedBytes = 0;
+    uint32_t bufferedSdus = 0;
+    uint32_t headSduBytes = 0;
+
+    /// MAC PDU metadata of the connection (downlink only), the head-of-line entry if pendingPdus > 0
+    uint32_t pendingPdus = 0;
+    uint16_t fiveQi = 0;
+    double arrivalTime = 0;
+    double deadline = 0;
+
+    /// wideband CQI of each codeword
+    std::vector<uint8_t> cqi;
+    /// bands the UE can use on the carrier, with the bytes it gets on one block of each
+    std::vector<std::pair<uint16_t, uint32_t>> bands;
+};
+
+struct SchedulerTraceRecord
+{
+    double time = 0;
+    double carrierFrequency = 0;
+    uint8_t numerologyIndex = 0;
+    /// one entry per band of the cell, non zero if the band is free when the new transmissions are scheduled
+    std::vector<uint8_t> freeBands;
+    std::vector<SchedulerTraceConnection> connections;
+};
+
+class SchedulerTraceWriter
+{
+  protected:
+    std::ofstream out_;
+    /// serialized record, written at once with its length
+    std::string buffer_;
+
+    void put(const void *data, size_t size) { buffer_.append(static_cast<const char *>(data), size); }
+    template<typename T> void put(T value) { put(&value, sizeof(T)); }
+
+  public:
+    /**
+     * Creates the file and writes the header. Throws if the file cannot be created.
+     */
+    void open(const std::string& fileName, const SchedulerTraceHeader& header);
+
+    void write(const SchedulerTraceRecord& record);
+
+    bool isOpen() const { return out_.is_open(); }
+};
+
+class SchedulerTraceReader
+{
+  protected:
+    std::ifstream in_;
+    std::string buffer_;
+    size_t pos_ = 0;
+
+    void get(void *data, size_t size);
+    template<typename T> T get()
+    {
+        T value;
+        get(&value, sizeof(T));
+        return value;
+    }
+
+  public:
+    /**
+     * Opens the file and reads its header. Throws if the file is not a scheduler trace.
+     */
+    void open(const std::string& fileName, SchedulerTraceHeader& header);
+
+    /**
+     * Reads the next record, reusing the storage of the given one.
+     *
+     * @return false at the end of the trace
+     */
+    bool next(SchedulerTraceRecord& record);
+};
+
+} //namespace
+
+#endif
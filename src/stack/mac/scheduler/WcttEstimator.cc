@@ -0,0 +1,89 @@
+//
+//                  Simu5G-NR-EDF (Extension of Simu5G)
+//
+// Original Authors: Giovanni Nardini, Giovanni Stea, Antonio Virdis (University of Pisa)
+// Extension Authors: Alaf Nascimento, Philippe Martins, Samuel Tardieu, Laurent Pautet (Institut Polytechnique de Paris)
+//
+// This file is part of a software released under the license included in file
+// "license.pdf". Please read LICENSE and README files before using it.
+// The above files and the present reference are part of the software itself,
+// and cannot be removed from it.
+//
+
+#include <cmath>
+
+#include "stack/mac/scheduler/WcttEstimator.h"
+#include "stack/mac/LteMacEnb.h"
+#include "stack/mac/amc/LteAmc.h"
+#include "common/binder/Binder.h"
+#include "common/cellInfo/CellInfo.h"
+#include "common/qos_data.h"
+
+namespace simu5g {
+
+using namespace omnetpp;
+
+void WcttEstimator::initialize(Direction dir, LteMacEnb *mac, Binder *binder)
+{
+    direction_ = dir;
+    mac_ = mac;
+    binder_ = binder;
+
+    maxHarqRtx_ = mac_->par("maxHarqRtx").intValue();
+
+    // the receiver evaluates a PDU after harqFbEvaluationTimer slots, the
+    // retransmission can be scheduled in the slot following the feedback
+    harqRttSlots_ = mac_->par("harqFbEvaluationTimer").intValue() + 1;
+}
+
+double WcttEstimator::getBler(MacNodeId nodeId) const
+{
+    // the HARQ error rate is recorded by the MAC of the UE, for both directions
+    LteMacBase *ueMac = binder_->getMacFromMacNodeId(nodeId);
+    if (ueMac == nullptr)
+        return 0.0;
+
+    // NaN until the first feedback: charging maxHarqRtx round trips to every new flow would
+    // make most DC-GBR flows look unschedulable before any transmission took place
+    double bler = ueMac->getHarqErrorRate(direction_);
+    return std::isfinite(bler) ? bler : 0.0;
+}
+
+unsigned int WcttEstimator::getRetransmissions(double bler, FiveQI fiveQi) const
+{
+    if (bler <= 0.0)
+        return 0;
+    if (bler >= 1.0)
+        return maxHarqRtx_;
+
+    const auto& params = get_qos_parameters(fiveQi);
+    if (params.fiveQI == 0)
+        return maxHarqRtx_;
+
+    // smallest k such that bler^(k+1) <= per
+    double per = std::pow(10.0, params.packet_error_rate_exp);
+    double transmissions = std::ceil(std::log(per) / std::log(bler));
+    if (transmissions <= 1.0)
+        return 0;
+    return std::min((unsigned int)transmissions - 1, maxHarqRtx_);
+}
+
+simtime_t WcttEstimator::estimate(MacCid cid, FiveQI fiveQi, unsigned int bytes, double carrierFrequency) const
+{
+    MacNodeId nodeId = MacCidToNodeId(cid);
+
+    // bits carried in one slot when the whole carrier is granted to the UE
+    unsigned int numBands = mac_->getCellInfo()->getCarrierNumBands(carrierFrequency);
+    unsigned int bitsPerSlot = mac_->getAmc()->computeBitsOnNRbs(nodeId, 0, numBands, direction_, carrierFrequency);
+    if (bitsPerSlot == 0)
+        return SIMTIME_MAX;
+
+    unsigned int bits = (bytes + MAC_HEADER + RLC_HEADER_UM) * 8;
+    unsigned int txSlots = (bits + bitsPerSlot - 1) / bitsPerSlot;
+    unsigned int rtxSlots = getRetransmissions(getBler(nodeId), fiveQi) * harqRttSlots_;
+
+    double slotDuration = binder_->getSlotDurationFromNumerologyIndex(binder_->getNumerologyIndexFromCarrierFreq(carrierFrequency));
+    return (txSlots + rtxSlots) * slotDuration;
+}
+
+} //namespace
@@ -0,0 +1,77 @@
+//
+//                  Simu5G-NR-EDF (Extension of Simu5G)
+//
+// Original Authors: Giovanni Nardini, Giovanni Stea, Antonio Virdis (University of Pisa)
+// Extension Authors: Alaf Nascimento, Philippe Martins, Samuel Tardieu, Laurent Pautet (Institut Polytechnique de Paris)
+//
+// This file is part of a software released under the license included in file
+// "license.pdf". Please read LICENSE and README files before using it.
+// The above files and the present reference are part of the software itself,
+// and cannot be removed from it.
+//
+
+#ifndef _LTE_WCTTESTIMATOR_H_
+#define _LTE_WCTTESTIMATOR_H_
+
+#include <omnetpp.h>
+#include "common/LteCommon.h"
+
+namespace simu5g {
+
+using namespace omnetpp;
+
+class Binder;
+class LteMacEnb;
+
+/**
+ * @class WcttEstimator
+ * @brief Bounds the time needed to deliver a given amount of data to a UE
+ *
+ * The worst-case transmission time (WCTT) is the number of slots needed to carry
+ * the data when the whole carrier is granted to the UE, with the current
+ * transmission parameters of the AMC, plus one HARQ round trip for every
+ * retransmission the UE may need. The number of retransmissions is the smallest
+ * one that brings the residual error rate, given the BLER observed on the UE,
+ * below the packet error rate of the 5QI (capped by maxHarqRtx). No retransmission
+ * is accounted for until the UE has received some HARQ feedback.
+ */
+class WcttEstimator
+{
+  protected:
+    LteMacEnb *mac_ = nullptr;
+    Binder *binder_ = nullptr;
+    Direction direction_ = DL;
+
+    /// maximum number of HARQ retransmissions of a transport block
+    unsigned int maxHarqRtx_ = 0;
+
+    /// slots between a transmission and the retransmission of the same transport block
+    unsigned int harqRttSlots_ = 0;
+
+  public:
+    WcttEstimator() {}
+
+    void initialize(Direction dir, LteMacEnb *mac, Binder *binder);
+
+    /**
+     * Returns the HARQ error rate observed so far on the given UE, zero if it has not
+     * received any feedback yet
+     */
+    double getBler(MacNodeId nodeId) const;
+
+    /**
+     * Returns the number of HARQ retransmissions to account for,
+     * given the BLER of the UE and the packet error rate of the 5QI
+     */
+    unsigned int getRetransmissions(double bler, FiveQI fiveQi) const;
+
+    /**
+     * Returns the WCTT of the given amount of data on the given connection and carrier,
+     * SIMTIME_MAX if the UE cannot be served (CQI equal to zero)
+     */
+    simtime_t estimate(MacCid cid, FiveQI fiveQi, unsigned int bytes, double carrierFrequency) const;
+};
+
+} //namespace
+
+#endif // _LTE_WCTTESTIMATOR_H_
@@ -168,7 +168,7 @@ void LteAllocatorBestFit::prepareSchedule()
             continue;
         }
         // No more free cw
-        if (eNbScheduler_->allocatedCws(nodeId) == codeword) {
+        if (eNbScheduler_->allocatedCws(nodeId, carrierFrequency_) == codeword) {
             EV << NOW << "Allocated codeword, direction: " << dirToA(dir) << endl;
             continue;
         }
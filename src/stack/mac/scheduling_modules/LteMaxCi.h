@@ -12,24 +12,18 @@
 #ifndef _LTE_LTEMAXCI_H_
 #define _LTE_LTEMAXCI_H_
 
-#include "stack/mac/scheduler/LteScheduler.h"
+#include "stack/mac/scheduling_modules/SchedulingMetrics.h"
 
 namespace simu5g {
 
-class LteMaxCi : public virtual LteScheduler
+/**
+ * Max C/I scheduler: connections and backlogged background UEs are served in decreasing order of
+ * bytes per block, see MaxCiMetric.
+ */
+class LteMaxCi : public MetricScheduler<MaxCiMetric>
 {
-  protected:
-
-    typedef SortedDesc<MacCid, unsigned int> ScoreDesc;
-    typedef std::priority_queue<ScoreDesc> ScoreList;
-
   public:
-    LteMaxCi(Binder *binder) : LteScheduler(binder) {}
-
-    void prepareSchedule() override;
-
-    void commitSchedule() override;
-
+    LteMaxCi(Binder *binder) : MetricScheduler<MaxCiMetric>(binder) {}
 };
 
 } //namespace
@@ -9,13 +9,12 @@
 // and cannot be removed from it.
 //
 
-#include <sstream>
-#include <fstream>
-#include <cstdio>
 #include <vector>
 #include <map>
 #include "stack/mac/scheduler/LteSchedulerEnb.h"
 #include "stack/mac/scheduling_modules/LteMaxCiOptMB.h"
+#include "stack/mac/scheduling_modules/solver/GreedySchedulerSolver.h"
+#include "stack/mac/scheduling_modules/solver/GlpkSchedulerSolver.h"
 #include "stack/mac/buffer/LteMacBuffer.h"
 
 namespace simu5g {
@@ -23,331 +22,81 @@ namespace simu5g {
 using namespace std;
 using namespace omnetpp;
 
-LteMaxCiOptMB::LteMaxCiOptMB(Binder *binder) : LteScheduler(binder), problemFile_("./optFile.lp"), solutionFile_("./solution.sol")
+LteMaxCiOptMB::LteMaxCiOptMB(Binder *binder) : LteScheduler(binder)
 {
 }
 
+LteMaxCiOptMB::~LteMaxCiOptMB()
+{
+    delete solver_;
+}
+
+void LteMaxCiOptMB::setEnbScheduler(LteSchedulerEnb *eNbScheduler)
+{
+    LteScheduler::setEnbScheduler(eNbScheduler);
+
+    std::string solver = mac_->par("optMbSolver").stdstringValue();
+    if (solver == "greedy")
+        solver_ = new GreedySchedulerSolver();
+    else if (solver == "glpk") {
+#ifdef WITH_GLPK
+        solver_ = new GlpkSchedulerSolver(mac_->par("optMbSolverTimeLimit").intValue());
+#else
+        throw cRuntimeError("LteMaxCiOptMB::setEnbScheduler - the \"glpk\" solver requires the Simu5G_GLPK feature");
+#endif
+    }
+    else
+        throw cRuntimeError("LteMaxCiOptMB::setEnbScheduler - unknown solver \"%s\"", solver.c_str());
+}
+
 /*
- * Given N bands, 2^N possible band configurations are obtained, each one describing a
- * possible combination of active bands.
- *
- * example of band configuration for three bands
- *
- *  2   1   0    id
- *  =========
- *  0 | 0 | 1    1
- *  0 | 1 | 0    2
- *  0 | 1 | 1    3
- *  1 | 0 | 0    4
- *  1 | 0 | 1    5
- *  1 | 1 | 0    6
- *  1 | 1 | 1    7
- *
- *  If a user is scheduled for band configuration 3, it will use band 1 and 0 to communicate.
+ * Given N bands, each UE can be assigned any subset of them (a band configuration). A UE transmits on
+ * all the bands of its configuration with the rate of its worst band, up to its queue occupancy, and
+ * each band can be assigned to one UE at most. See MultiBandProblem.
  *
- *  The following function performs the following steps
- *  - reads the per band CQI for each UE and stores them in the "cqiPerBandMatrix" structure ( < ueID , CQIs > )
- *  - for each band configuration, computes the minimum CQI between the bands active within it, and stores
- *    the band id into the "cqiPerConfigMatrix" structure ( < ueID , minBandId >
- *  - generate the optimization problem storing it into the file specified by "problemFile_"
+ * The following function reads, for each UE, the bytes it could send on each band and its queue
+ * occupancy, and stores them in "problem_".
  *
- *  NOTE: bands ID starts from 0, while Band Configuration starts from 1 ( power of two stuff, easy to handle. You are an adult anyway )
+ * NOTE: bands ID starts from 0
  */
 void LteMaxCiOptMB::generateProblem()
 {
+    problem_.clear();
+
     int totUes = carrierActiveConnectionSet_.size();
     // skip problem generation if no User is active
     if (totUes == 0) {
         return;
     }
 
-    // stores per-band CQI for each UE
-    std::map<MacNodeId, std::vector<Cqi>> cqiPerBandMatrix;
-
-    // for each UE, stores the id of the band that contains the minimum CQI for the given band configuration
-    // e.g. vector[3] contains the id of the band with the minimum CQI among the bands active in configuration 4 ( not 3! )
-    std::map<MacNodeId, std::vector<int>> cqiPerConfigMatrix;
-
-    bool first = true;
-    int iUe = 0;
-    int iBandConf = 0;
-    int iBand = 0;
-    int minCqi;
-    int bandPattern;
-
     // amount of available blocks. In this scenario each band has 1 block
     int numBands = eNbScheduler_->readTotalAvailableRbs();
     if (numBands == 0) {
         EV << NOW << " LteMaxCiOptMB::generateProblem - No Available RBs" << endl;
         return;
     }
-    // number of possible combinations of bands
-    int totBandConfig = pow(2, numBands) - 1;
-
-    double MAX_RATE = 100 * numBands;
-
-    //======= init string and files =======
-    stringstream appStream;
-    ofstream appFileStream;
-    remove(problemFile_.c_str());
-    remove(solutionFile_.c_str());
-    // open delta file
-    appFileStream.clear();
-    appFileStream.open(problemFile_.c_str(), (std::ios::app) | (std::ios::out));
-    //=====================================
-
-    // config UE ids
-    // for each band configuration
-    vector<int> cqiPerConfig;
-    vector<Cqi> cqiPerBand;
-    for (unsigned int it : carrierActiveConnectionSet_) {
-        cqiPerConfig.clear();
-        MacNodeId ueId = MacCidToNodeId(it);
-        ueList_.push_back(ueId);
-        cidList_.push_back(it);
-        cqiPerBandMatrix.insert(pair<MacNodeId, std::vector<Cqi>>(ueId, eNbScheduler_->mac_->getAmc()->readMultiBandCqi(ueId, direction_, carrierFrequency_)));
-        // ******* DEBUG *******
-        appFileStream << ueId << ") CQI[ ";
-        first = true;
-        for ( iBand = 0; iBand < numBands; ++iBand ) {
-            if (first)
-                first = false;
-            else
-                appFileStream << " \t, ";
-            unsigned int availableBlocks = eNbScheduler_->readAvailableRbs(ueId, MACRO, iBand);
-            unsigned int availableBytes_MB = eNbScheduler_->mac_->getAmc()->computeBytesOnNRbs_MB(ueId, iBand, availableBlocks, direction_, carrierFrequency_);
-
-            appFileStream << cqiPerBandMatrix[ueId][iBand] << "/";
-            cqiPerBandMatrix[ueId][iBand] = availableBytes_MB;
-
-            appFileStream << cqiPerBandMatrix[ueId][iBand];
-        }
-        appFileStream << " ]" << endl;
-        // ***** END debug *****
-
-        /*
-         *  TODO this function can be implemented more efficiently by:
-         *  - sorting the bands by CQI value
-         *  - for each bandConfig, browse the sorted list and select the first CQI whose band belongs to the bandConfig
-         */
-        // for each band configuration, select the minimum CQI
-        for (iBandConf = 1; iBandConf <= totBandConfig; ++iBandConf) {
-            minCqi = 0;
-            for ( iBand = 0; iBand < numBands; ++iBand ) {
-                bandPattern = 1 << iBand;
-                if ((iBandConf & bandPattern) && (cqiPerBandMatrix[ueId][iBand] < cqiPerBandMatrix[ueId][minCqi]))
-                    minCqi = iBand;
-            }
-            cqiPerConfig.push_back(minCqi);
-        }
-        cqiPerConfigMatrix.insert(pair<MacNodeId, std::vector<int>>(ueId, cqiPerConfig));
-    }
-    // ==========================================================================
-    // ====================== BUILDING OPTIMIZATION PROBLEM =====================
-    // ==========================================================================
-
-    appFileStream << "\\ ================ Objective Function ================" << NOW << endl;
-    appFileStream << "Maximize " << endl;
-
-    first = true;
-    appFileStream << "\\ Ue= " << totUes << endl;
-    for ( iUe = 0; iUe < totUes; ++iUe) {
-        if (first)
-            first = false;
-        else
-            appFileStream << " + ";
-
-        appFileStream << "v" << ueList_[iUe] << " - p" << ueList_[iUe];
-    }
-    appFileStream << endl;
-
-    appFileStream << "subject to" << endl;
-    appFileStream << "\\ ================ Constraint 1 ================" << endl;
-    appFileStream << "\\ Ue= " << totUes << " - totBands= " << totBandConfig << endl;
-
-    for ( iUe = 0; iUe < totUes; ++iUe) {
-        first = true;
-        for ( iBandConf = 1; iBandConf <= totBandConfig; ++iBandConf ) {
-            if (first)
-                first = false;
-            else
-                appFileStream << " + ";
-            appFileStream << "b" << ueList_[iUe] << "_" << iBandConf;
-        }
-        appFileStream << " <= 1" << endl;
-    }
-
-    appFileStream << "\\ ================ Constraint 2 ================" << endl;
-    for ( iBandConf = 1; iBandConf <= totBandConfig; ++iBandConf ) {
-        first = true;
-        for ( iUe = 0; iUe < totUes; ++iUe) {
-            if (first)
-                first = false;
-            else
-                appFileStream << " + ";
-            appFileStream << "b" << ueList_[iUe] << "_" << iBandConf;
-        }
-        appFileStream << " <= 1" << endl;
-    }
-    appFileStream << "\\ ================ Constraint 3 ================" << endl;
-    for ( iUe = 0; iUe < totUes; ++iUe) {
-        for ( iBandConf = 1; iBandConf <= totBandConfig; ++iBandConf ) {
-            appFileStream << "v" << ueList_[iUe] << "_" << iBandConf << " - "
-                          << MAX_RATE << " b" << ueList_[iUe] << "_" << iBandConf << " <= 0" << endl;
-        }
-    }
-
-    appFileStream << "\\ ================ Constraint 4 ================" << endl;
-    for ( iUe = 0; iUe < totUes; ++iUe) {
-        MacNodeId ueId = ueList_[iUe];
-        cqiPerConfig.clear();
-        cqiPerConfig = cqiPerConfigMatrix[ueId];
-
-        cqiPerBand.clear();
-        cqiPerBand = cqiPerBandMatrix[ueId];
-
-        for ( iBandConf = 1; iBandConf <= totBandConfig; ++iBandConf ) {
-            appFileStream << "v" << ueId << "_" << iBandConf << " - ";
-            first = true;
-            for ( iBand = 0; iBand < numBands; ++iBand ) {
-                bandPattern = 1 << iBand;
-                if (iBandConf & bandPattern) {
-                    if (first)
-                        first = false;
-                    else
-                        appFileStream << " - ";
-                    appFileStream << cqiPerBand[cqiPerConfig[iBandConf - 1]] << " s" << ueId << "_" << iBand;
-                }
-            }
-            appFileStream << " <= 0 " << endl;
-        }
-    }
-
-    appFileStream << "\\ ================ Constraint 5 ================" << endl;
-    for ( iUe = 0; iUe < totUes; ++iUe) {
-        MacNodeId ueId = ueList_[iUe];
-        appFileStream << "v" << ueId;
-        for ( iBandConf = 1; iBandConf <= totBandConfig; ++iBandConf ) {
-            appFileStream << " - v" << ueId << "_" << iBandConf;
-        }
-        appFileStream << " = 0" << endl;
-    }
-
-    appFileStream << "\\ ================ Constraint 6 ================" << endl;
-    for ( iUe = 0; iUe < totUes; ++iUe) {
-        LteMacBufferMap *buf = mac_->getMacBuffers();
-        LteMacBufferMap::iterator it = buf->find(cidList_[iUe]);
-        int queue = 0;
-        if (it == mac_->getMacBuffers()->end()) {
-            cRuntimeError("LteMaxCiOptMB::generateProblem Cannot find CID[%u]. Aborting... ", cidList_[iUe]);
-        }
-        queue = it->second->getQueueOccupancy();
-        MacNodeId ueId = ueList_[iUe];
-        appFileStream << "v" << ueId << " - p" << ueId << " <= " << queue << endl;
-    }
-
-    appFileStream << "\\ ================ Constraint 7 ================" << endl;
-    for ( iUe = 0; iUe < totUes; ++iUe) {
-        MacNodeId ueId = ueList_[iUe];
-        cqiPerConfig.clear();
-        cqiPerConfig = cqiPerConfigMatrix[ueId];
+    problem_.numBands = numBands;
 
-        cqiPerBand.clear();
-        cqiPerBand = cqiPerBandMatrix[ueId];
+    LteMacBufferMap *buf = mac_->getMacBuffers();
+    for (MacCid cid : carrierActiveConnectionSet_) {
+        MacNodeId ueId = MacCidToNodeId(cid);
+        ueList_.push_back(ueId);
+        cidList_.push_back(cid);
 
-        for ( iBandConf = 1; iBandConf <= totBandConfig; ++iBandConf ) {
-            appFileStream << "p" << ueId << " + " << MAX_RATE << " b" << ueId << "_" << iBandConf
-                          << " <= " << (cqiPerBand[cqiPerConfig[iBandConf - 1]] + MAX_RATE - 1) << endl;
-        }
-    }
+        LteMacBufferMap::iterator it = buf->find(cid);
+        if (it == buf->end())
+            throw cRuntimeError("LteMaxCiOptMB::generateProblem Cannot find CID[%u]. Aborting... ", cid);
 
-    appFileStream << "\\ ================ Constraint 8a ================" << endl;
-    for ( iUe = 0; iUe < totUes; ++iUe) {
-        MacNodeId ueId = ueList_[iUe];
-        for ( iBand = 0; iBand < numBands; ++iBand ) {
-            bandPattern = 1 << iBand;
-
-            first = true;
-            for ( iBandConf = 1; iBandConf <= totBandConfig; ++iBandConf ) {
-                if (iBandConf & bandPattern) {
-                    if (first)
-                        first = false;
-                    else
-                        appFileStream << " + ";
-
-                    appFileStream << " b" << ueId << "_" << iBandConf;
-                }
-            }
-            appFileStream << " - s" << ueId << "_" << iBand << " <= 0" << endl;
-        }
-    }
+        problem_.ues.push_back(ueId);
+        problem_.queue.push_back(it->second->getQueueOccupancy());
+        problem_.rate.emplace_back(numBands);
 
-    appFileStream << "\\ ================ Constraint 8b ================" << endl;
-    for ( iUe = 0; iUe < totUes; ++iUe) {
-        MacNodeId ueId = ueList_[iUe];
-        for ( iBand = 0; iBand < numBands; ++iBand ) {
-            appFileStream << "s" << ueId << "_" << iBand << " - ";
-            bandPattern = 1 << iBand;
-
-            first = true;
-            for ( iBandConf = 1; iBandConf <= totBandConfig; ++iBandConf ) {
-                if (iBandConf & bandPattern) {
-                    if (first)
-                        first = false;
-                    else
-                        appFileStream << " - ";
-
-                    appFileStream << " b" << ueId << "_" << iBandConf;
-                }
-            }
-            appFileStream << " <= 0" << endl;
-        }
-    }
-    appFileStream << "\\ ================ Constraint 9 ================" << endl;
-
-    for ( iBand = 0; iBand < numBands; ++iBand ) {
-        first = true;
-        for ( iUe = 0; iUe < totUes; ++iUe) {
-            MacNodeId ueId = ueList_[iUe];
-            if (first)
-                first = false;
-            else
-                appFileStream << " + ";
-            appFileStream << " s" << ueId << "_" << iBand;
+        std::vector<unsigned int>& rate = problem_.rate.back();
+        for (int iBand = 0; iBand < numBands; ++iBand) {
+            unsigned int availableBlocks = eNbScheduler_->readAvailableRbs(ueId, MACRO, iBand);
+            rate[iBand] = eNbScheduler_->mac_->getAmc()->computeBytesOnNRbs_MB(ueId, iBand, availableBlocks, direction_, carrierFrequency_);
         }
-        appFileStream << "<= 1" << endl;
     }
-
-    appFileStream << "\\================= variables definition =================" << endl;
-    appFileStream << "\\================= Integer variables =====================" << endl;
-    appFileStream << "GENERAL" << endl;
-
-    for ( iUe = 0; iUe < totUes; ++iUe) {
-        MacNodeId ueId = ueList_[iUe];
-
-        for ( iBand = 0; iBand < numBands; ++iBand )
-            appFileStream << "s" << ueId << "_" << iBand << endl;
-
-        appFileStream << "v" << ueId << endl;
-        for ( iBandConf = 1; iBandConf <= totBandConfig; ++iBandConf )
-            appFileStream << "v" << ueId << "_" << iBandConf << endl;
-
-        appFileStream << "p" << ueId << endl;
-    }
-
-    appFileStream << "\\================= binary variables =====================" << endl;
-    appFileStream << "Binary" << endl;
-    for ( iUe = 0; iUe < totUes; ++iUe) {
-        MacNodeId ueId = ueList_[iUe];
-        for ( iBandConf = 1; iBandConf <= totBandConfig; ++iBandConf )
-            appFileStream << "b" << ueId << "_" << iBandConf << endl;
-    }
-    // ==========================================================================
-    // ==========================================================================
-    // ==========================================================================
-
-    appFileStream << "end" << endl;
-    appFileStream.close();
 }
 
 void LteMaxCiOptMB::prepareSchedule()
@@ -368,86 +117,41 @@ void LteMaxCiOptMB::prepareSchedule()
     if (cidList_.size() == 0)
         EV << NOW << " LteMaxCiOptMB::prepareSchedule  no active connections" << endl;
     else {
-        EV << NOW << " LteMaxCiOptMB::prepareSchedule - Launching problem..." << endl;
-        launchProblem();
+        EV << NOW << " LteMaxCiOptMB::prepareSchedule - Solving problem..." << endl;
+        solveProblem();
         EV << NOW << " LteMaxCiOptMB::prepareSchedule - Problem Solved" << endl;
         readSolution();
     }
     applyScheduling();
 }
 
-// TODO use the XML built-in functions
+void LteMaxCiOptMB::solveProblem()
+{
+    solver_->solve(problem_, prevBandOwner_, bandOwner_);
+    prevBandOwner_ = bandOwner_;
+}
+
 void LteMaxCiOptMB::readSolution()
 {
-    std::ifstream file;
-    std::string line;
-    size_t pos;
-
-    std::string nameString;
-    std::string ue, band, value;
-    BandLimit bandLimit;
-
-    // open the solution file
-    file.clear();
-    file.open(solutionFile_.c_str());
-
-    UsableBands usableBands;
-
-    // read from file
-    while (true) {
-        if ((file.rdstate() & std::istream::eofbit) != 0)
-            break;
-        getline(file, line);
-
-        // find the next line containing one x variable
-        pos = line.find("me=\"s");
-        if (pos == std::string::npos)
-            continue;
-
-        // read UE id and Band ID
-        ue = line.substr(pos + 5, 4);
-        MacNodeId ueId = MacNodeId(atoi(ue.c_str()));
-        band = line.substr(pos + 10, 1);
-        int bandId = atoi(band.c_str());
-
-        // read the value
-        pos = line.find("value=");
-        value = line.substr(pos + 7, 1);
-
-        int limit;
-
-        // fill the bandLimit and usableBand structures
-        limit = (value.find('1') != std::string::npos) ? -1 : -2;
-        bandLimit.limit_.push_back(limit);
-        bandLimit.band_ = bandId;
-        schedulingDecision_[ueId].push_back(bandLimit);
-
-        if (limit == -1) {
-            usableBands_[ueId].push_back(bandLimit.band_);
-            EV << " LteMaxCiOptMB::readSolution - Adding usable band[" << bandLimit.band_ << "] for UE[" << ueId << "]" << std::endl;
+    for (MacNodeId ueId : ueList_) {
+        std::vector<BandLimit>& decision = schedulingDecision_[ueId];
+        decision.clear();
+        for (Band b = 0; b < problem_.numBands; b++) {
+            // the band is usable if it has been assigned to the UE, excluded otherwise
+            BandLimit bandLimit(b);
+            int limit = (bandOwner_[b] == ueId) ? -1 : -2;
+            bandLimit.limit_.assign(MAX_CODEWORDS, limit);
+            decision.push_back(bandLimit);
+
+            if (limit == -1) {
+                usableBands_[ueId].push_back(b);
+                EV << " LteMaxCiOptMB::readSolution - Adding usable band[" << b << "] for UE[" << ueId << "]" << std::endl;
+            }
         }
     }
 
-    MacNodeId ueId;
-
-    for (const auto& [id, bands] : usableBands_) {
-        ueId = id;
+    for (const auto& [ueId, bands] : usableBands_)
         eNbScheduler_->mac_->getAmc()->setPilotUsableBands(ueId, bands);
-    }
-}
-
-void LteMaxCiOptMB::launchProblem()
-{
-    std::stringstream cmd;
-    FILE *fp = popen("cplex -c", "w");
-    if (fp != nullptr) {
-        cmd << "\"set logfile *\" \"read " << problemFile_ << " lp\" \"optimize\" ";
-        cmd << "\"write " << solutionFile_ << "\" \"y\" ";
-        cmd << " > /dev/null" << std::endl;
-        fprintf(fp, "%s", cmd.str().c_str());
-
-        fclose(fp);
-    }
 }
 
 void LteMaxCiOptMB::applyScheduling()
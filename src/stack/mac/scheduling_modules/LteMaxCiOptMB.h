@@ -13,19 +13,25 @@
 #define LTEMAXCIOPTMB_H_
 
 #include "stack/mac/scheduler/LteScheduler.h"
-#include <string>
 #include "stack/mac/amc/AmcPilot.h"
+#include "stack/mac/scheduling_modules/solver/ISchedulerSolver.h"
 
 namespace simu5g {
 
 typedef std::map<MacNodeId, std::vector<BandLimit>> SchedulingDecision;
 typedef std::map<MacNodeId, UsableBands> UsableBandList;
 
+/**
+ * Multi-band MaxC/I scheduler assigning the bands to the UEs by solving an optimization problem
+ * (see MultiBandProblem) at each scheduling period.
+ *
+ * The problem is built in memory and solved in-process by the solver selected by the "optMbSolver"
+ * parameter of the MAC, starting from the solution of the previous period.
+ */
 class LteMaxCiOptMB : public virtual LteScheduler
 {
 
-    std::string problemFile_;
-    std::string solutionFile_;
+    ISchedulerSolver *solver_ = nullptr;
 
     std::vector<MacNodeId> ueList_;
     std::vector<MacCid> cidList_;
@@ -33,13 +39,19 @@ class LteMaxCiOptMB : public virtual LteScheduler
 
     UsableBandList usableBands_;
 
+    MultiBandProblem problem_;
+
+    // owner of each band, in the current and in the previous period
+    std::vector<MacNodeId> bandOwner_;
+    std::vector<MacNodeId> prevBandOwner_;
+
     // read the CQIs and queue information for each user and build an optimization problem
     void generateProblem();
 
-    // call the interactive solver
-    void launchProblem();
+    // run the solver, warm-started from the previous solution
+    void solveProblem();
 
-    // parse the solution
+    // translate the band assignment into scheduling decisions and usable bands
     void readSolution();
 
     // apply the scheduling decision in the allocator (occupies the Resource blocks)
@@ -48,6 +60,10 @@ class LteMaxCiOptMB : public virtual LteScheduler
   public:
     LteMaxCiOptMB(Binder *binder);
 
+    ~LteMaxCiOptMB() override;
+
+    void setEnbScheduler(LteSchedulerEnb *eNbScheduler) override;
+
     void prepareSchedule() override;
 
     void commitSchedule() override;
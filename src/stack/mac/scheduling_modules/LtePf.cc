@@ -9,6 +9,8 @@
 // and cannot be removed from it.
 //
 
+#include <algorithm>
+
 #include "stack/mac/scheduling_modules/LtePf.h"
 #include "stack/mac/scheduler/LteSchedulerEnb.h"
 
@@ -16,24 +18,39 @@ namespace simu5g {
 
 using namespace omnetpp;
 
-void LtePf::prepareSchedule()
+void LtePf::setEnbScheduler(LteSchedulerEnb *eNbScheduler)
 {
-    EV << NOW << "LtePf::execSchedule ############### eNodeB " << eNbScheduler_->mac_->getMacNodeId() << " ###############" << endl;
-    EV << NOW << "LtePf::execSchedule Direction: " << ((direction_ == DL) ? " DL " : " UL ") << endl;
-
-    // Clear structures
-    grantedBytes_.clear();
+    MetricScheduler<PfMetric>::setEnbScheduler(eNbScheduler);
+    batched_ = mac_->par("pfBatched").boolValue();
+    perBand_ = mac_->par("pfPerBand").boolValue();
+    if (perBand_ && !batched_)
+        throw cRuntimeError("LtePf::setEnbScheduler - pfPerBand requires pfBatched");
+}
 
-    // Create a working copy of the active set
-    activeConnectionTempSet_ = *activeConnectionSet_;
+void LtePf::prepareSchedule()
+{
+    // the long-term rate of every connection of the carrier decays, including the ones that cannot be served
+    for (MacCid cid : carrierActiveConnectionSet_)
+        metric_.granted(cid, 0);
+
+    if (batched_)
+        prepareBatchedSchedule();
+    else
+        MetricScheduler<PfMetric>::prepareSchedule();
+}
 
-    // Build the score list by cycling through the active connections.
-    ScoreList score;
+void LtePf::gatherRates()
+{
+    numBands_ = bandLimit_->size();
+    cids_.clear();
+    weight_.clear();
+    tieBreak_.clear();
+    bytes_.clear();
+    blocks_.clear();
 
     for (const auto& cid : carrierActiveConnectionSet_) {
         MacNodeId nodeId = MacCidToNodeId(cid);
         OmnetId id = binder_->getOmnetId(nodeId);
-        grantedBytes_[cid] = 0;
 
         if (nodeId == NODEID_NONE || id == 0) {
             // node has left the simulation - erase corresponding CIDs
@@ -50,21 +67,10 @@ void LtePf::prepareSchedule()
         else
             dir = DL;
 
-        // check if node is still a valid node in the simulation - might have been dynamically removed
-        if (binder_->getOmnetId(nodeId) == 0) {
-            activeConnectionTempSet_.erase(cid);
-            carrierActiveConnectionSet_.erase(cid);
-            EV << "CID " << cid << " of node " << nodeId << " removed from active connection set - no OmnetId in Binder known.";
-            continue;
-        }
-
-        // compute available blocks for the current user
-        const UserTxParams& info = eNbScheduler_->mac_->getAmc()->computeTxParams(nodeId, dir, carrierFrequency_);
-        const std::set<Band>& bands = info.readBands();
+        const UserTxParams& info = mac_->getAmc()->computeTxParams(nodeId, dir, carrierFrequency_);
         unsigned int codeword = info.getLayers().size();
-        if (eNbScheduler_->allocatedCws(nodeId) == codeword)
+        if (eNbScheduler_->allocatedCws(nodeId, carrierFrequency_) == codeword)
             continue;
-        auto it = bands.begin(), et = bands.end();
 
         bool cqiNull = false;
         for (unsigned int i = 0; i < codeword; i++) {
@@ -74,105 +80,162 @@ void LtePf::prepareSchedule()
         if (cqiNull)
             continue;
 
-        // compute score based on total available bytes
-        unsigned int availableBlocks = 0;
-        unsigned int availableBytes = 0;
-        // for each antenna
+        // one row per connection, bands the UE cannot use stay at zero
+        size_t row = bytes_.size();
+        bytes_.resize(row + numBands_, 0);
+        blocks_.resize(row + numBands_, 0);
         for (auto antenna : info.readAntennaSet()) {
-            // for each logical band
-            //FIXME missing reset `it`??? it = bands.begin();
-            for ( ; it != et; ++it) {
-                unsigned int blocks = eNbScheduler_->readAvailableRbs(nodeId, antenna, *it);
-                availableBlocks += blocks;
-                availableBytes += eNbScheduler_->mac_->getAmc()->computeBytesOnNRbs(nodeId, *it, blocks, dir, carrierFrequency_);
+            for (Band band : info.readBands()) {
+                unsigned int blocks = eNbScheduler_->readAvailableRbs(nodeId, antenna, band);
+                blocks_[row + band] += blocks;
+                bytes_[row + band] += mac_->getAmc()->computeBytesOnNRbs(nodeId, band, blocks, dir, carrierFrequency_);
             }
         }
 
-        double s = .0;
-
-        if (pfRate_.find(cid) == pfRate_.end()) pfRate_[cid] = 0;
-        if (pfRate_[cid] < scoreEpsilon_) s = 1.0 / scoreEpsilon_;
-        else if (availableBlocks > 0) s = ((availableBytes / availableBlocks) / pfRate_[cid]) + uniform(getEnvir()->getRNG(0), -scoreEpsilon_ / 2.0, scoreEpsilon_ / 2.0);
-        else s = 0.0;
+        double rate = metric_.rate(cid);
+        cids_.push_back(cid);
+        weight_.push_back(rate < PfMetric::scoreEpsilon_ ? -1.0 : 1.0 / rate);
+        tieBreak_.push_back(CellSchedulingPool::uniform(0, 1));
+    }
+}
 
-        // Create a new score descriptor for the connection, where the score is equal to the ratio between bytes per slot and long term rate
-        ScoreDesc desc(cid, s);
-        score.push(desc);
+void LtePf::sortRows(unsigned int first, unsigned int last)
+{
+    auto better = [this](unsigned int a, unsigned int b) {
+        return rowScores_[a] > rowScores_[b] || (rowScores_[a] == rowScores_[b] && tieBreak_[a] > tieBreak_[b]);
+    };
+    std::partial_sort(order_.begin() + first, order_.begin() + last, order_.end(), better);
+}
 
-        EV << NOW << "LtePf::execSchedule CID " << cid << "- Score = " << s << endl;
+void LtePf::assignBands()
+{
+    const unsigned int rows = cids_.size();
+    bandOwner_.assign(numBands_, -1);
+    bandMetric_.assign(numBands_, 0.0);
+
+    // the PF metric of a band is the rate on the band weighted by the inverse of the long-term rate
+    for (unsigned int r = 0; r < rows; r++) {
+        const unsigned int *bytes = &bytes_[r * numBands_];
+        const double weight = (weight_[r] < 0) ? 1.0 / PfMetric::scoreEpsilon_ : weight_[r];
+        for (unsigned int b = 0; b < numBands_; b++) {
+            double metric = bytes[b] * weight;
+            if (metric > bandMetric_[b]) {
+                bandMetric_[b] = metric;
+                bandOwner_[b] = r;
+            }
+        }
     }
+}
 
-    // Schedule the connections in score order.
-    while (!score.empty()) {
-        // Pop the top connection from the list.
-        ScoreDesc current = score.top();
-        MacCid cid = current.x_; // The CID
+void LtePf::prepareBatchedSchedule()
+{
+    // Create a working copy of the active set
+    activeConnectionTempSet_ = *activeConnectionSet_;
 
-        EV << NOW << "LtePf::execSchedule @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@" << endl;
-        EV << NOW << "LtePf::execSchedule CID: " << cid;
-        EV << NOW << "LtePf::execSchedule Score: " << current.score_ << endl;
+    gatherRates();
 
-        // Grant data to that connection.
-        bool terminate = false;
-        bool active = true;
-        bool eligible = true;
+    // scores: bytes per block over the long-term rate
+    const unsigned int rows = cids_.size();
+    rowScores_.resize(rows);
+    for (unsigned int r = 0; r < rows; r++) {
+        const unsigned int *bytes = &bytes_[r * numBands_];
+        const unsigned int *blocks = &blocks_[r * numBands_];
+        unsigned int availableBytes = 0;
+        unsigned int availableBlocks = 0;
+        for (unsigned int b = 0; b < numBands_; b++) {
+            availableBytes += bytes[b];
+            availableBlocks += blocks[b];
+        }
+        if (weight_[r] < 0)
+            rowScores_[r] = 1.0 / PfMetric::scoreEpsilon_;
+        else if (availableBlocks > 0)
+            rowScores_[r] = (availableBytes / availableBlocks) * weight_[r];
+        else
+            rowScores_[r] = 0.0;
+    }
 
-        unsigned int granted = requestGrant(cid, 4294967295U, terminate, active, eligible);
+    // each served connection takes at least one block, so only the best ones need to be sorted at first
+    order_.resize(rows);
+    for (unsigned int r = 0; r < rows; r++)
+        order_[r] = r;
+    unsigned int sorted = std::min(rows, std::max(1u, eNbScheduler_->getResourceBlocks()));
+    sortRows(0, sorted);
+
+    bool terminate = false;
+
+    if (perBand_) {
+        // frequency-selective pass: each connection gets a single grant, on the bands it won first, then on the
+        // bands left by the connections already served. The bands won by the next connections are kept for them
+        assignBands();
+        served_.assign(rows, false);
+        for (unsigned int i = 0; i < rows && !terminate; i++) {
+            if (i == sorted) {
+                sortRows(sorted, rows);
+                sorted = rows;
+            }
 
-        grantedBytes_[cid] += granted;
+            unsigned int r = order_[i];
+            MacCid cid = cids_[r];
+            served_[r] = true;
 
-        EV << NOW << "LtePf::execSchedule Granted: " << granted << " bytes" << endl;
+            // another connection of the same UE already holds its codeword
+            if (eNbScheduler_->allocatedCws(MacCidToNodeId(cid), carrierFrequency_) > 0)
+                continue;
 
-        // Exit immediately if the terminate flag is set.
-        if (terminate) {
-            EV << NOW << "LtePf::execSchedule TERMINATE " << endl;
-            break;
-        }
+            rowBandLimit_.clear();
+            for (unsigned int b = 0; b < numBands_; b++) {
+                if (bandOwner_[b] == (int)r)
+                    rowBandLimit_.push_back(bandLimit_->at(b));
+            }
+            for (unsigned int b = 0; b < numBands_; b++) {
+                if (bandOwner_[b] == (int)r)
+                    continue;
+                rowBandLimit_.push_back(bandLimit_->at(b));
+                if (bandOwner_[b] >= 0 && !served_[bandOwner_[b]])
+                    rowBandLimit_.back().limit_.assign(MAX_CODEWORDS, -2);
+            }
 
-        // Pop the descriptor from the score list if the active or eligible flag are clear.
-        if (!active || !eligible) {
-            score.pop();
+            bool active = true;
+            bool eligible = true;
+            unsigned int granted = requestGrant(cid, 4294967295U, terminate, active, eligible, &rowBandLimit_);
+            metric_.granted(cid, granted);
 
-            if (!eligible)
-                EV << NOW << "LtePf::execSchedule NOT ELIGIBLE " << endl;
-        }
+            EV << NOW << "LtePf::execSchedule CID: " << cid << " Score: " << rowScores_[r] << " Granted: " << granted << " bytes" << endl;
 
-        // Set the connection as inactive if indicated by the grant ().
-        if (!active) {
-            EV << NOW << "LtePf::execSchedule NOT ACTIVE" << endl;
-            activeConnectionTempSet_.erase(current.x_);
-            carrierActiveConnectionSet_.erase(current.x_);
+            if (!active) {
+                activeConnectionTempSet_.erase(cid);
+                carrierActiveConnectionSet_.erase(cid);
+            }
         }
+        return;
     }
-}
-
-void LtePf::commitSchedule()
-{
-    unsigned int total = eNbScheduler_->resourceBlocks_;
 
-    for (const auto& [cid, granted] : grantedBytes_) {
-        EV << NOW << " LtePf::storeSchedule @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@" << endl;
-        EV << NOW << " LtePf::storeSchedule CID: " << cid << endl;
-        EV << NOW << " LtePf::storeSchedule Direction: " << ((direction_ == DL) ? "DL" : "UL") << endl;
+    // Schedule the connections in score order, on any band with blocks left.
+    for (unsigned int i = 0; i < rows && !terminate; ) {
+        if (i == sorted) {
+            sortRows(sorted, rows);
+            sorted = rows;
+        }
 
-        // Computing the short term rate
-        double shortTermRate;
+        unsigned int r = order_[i];
+        MacCid cid = cids_[r];
 
-        if (total > 0)
-            shortTermRate = double(granted) / double(total);
-        else
-            shortTermRate = 0.0;
+        bool active = true;
+        bool eligible = true;
+        unsigned int granted = requestGrant(cid, 4294967295U, terminate, active, eligible);
+        metric_.granted(cid, granted);
 
-        EV << NOW << " LtePf::storeSchedule Short Term Rate " << shortTermRate << endl;
+        EV << NOW << "LtePf::execSchedule CID: " << cid << " Score: " << rowScores_[r] << " Granted: " << granted << " bytes" << endl;
 
-        // Updating the long term rate
-        double& longTermRate = pfRate_[cid];
-        longTermRate = (1.0 - pfAlpha_) * longTermRate + pfAlpha_ * shortTermRate;
+        // Move to the next connection if the active or eligible flag are clear.
+        if (!active || !eligible)
+            i++;
 
-        EV << NOW << "LtePf::storeSchedule Long Term Rate = " << longTermRate;
+        if (!active) {
+            activeConnectionTempSet_.erase(cid);
+            carrierActiveConnectionSet_.erase(cid);
+        }
     }
-
-    *activeConnectionSet_ = activeConnectionTempSet_;
 }
 
 } //namespace
@@ -12,52 +12,67 @@
 #ifndef _LTE_LTEPF_H_
 #define _LTE_LTEPF_H_
 
-#include "stack/mac/scheduler/LteScheduler.h"
+#include "stack/mac/scheduling_modules/SchedulingMetrics.h"
 
 namespace simu5g {
 
-class LtePf : public LteScheduler
+/**
+ * Proportional fair scheduler, see PfMetric. In batched mode ("pfBatched"), the scores are computed
+ * from a UE x band rate matrix, optionally with a per-band assignment of the blocks ("pfPerBand").
+ */
+class LtePf : public MetricScheduler<PfMetric>
 {
   protected:
 
-    typedef std::map<MacCid, double> PfRate;
-    typedef SortedDesc<MacCid, double> ScoreDesc;
-    typedef std::priority_queue<ScoreDesc> ScoreList;
-
-    //! Long-term rates, used by PF scheduling.
-    PfRate pfRate_;
-
-    //! Granted bytes
-    std::map<MacCid, unsigned int> grantedBytes_;
-
-    //! Smoothing factor for proportional fair scheduler.
-    double pfAlpha_;
-
-    //! Small number to slightly blur scores.
-    const double scoreEpsilon_ = 0.000001;
+    //! If true, the scores are computed in batch from a UE x band rate matrix.
+    bool batched_ = false;
+
+    //! If true (batched mode only), each band is first assigned to the UE with the best PF metric on it.
+    bool perBand_ = false;
+
+    // Batched mode state, reused across slots. Matrices are row-major, one row per scored connection.
+    unsigned int numBands_ = 0;
+    std::vector<MacCid> cids_;
+    //! bytes and blocks available to each connection on each band
+    std::vector<unsigned int> bytes_;
+    std::vector<unsigned int> blocks_;
+    //! PF weight of each connection, i.e. the inverse of its long-term rate
+    std::vector<double> weight_;
+    std::vector<double> rowScores_;
+    //! random key breaking the ties between equal scores
+    std::vector<double> tieBreak_;
+    //! rows in decreasing score order
+    std::vector<unsigned int> order_;
+    //! row owning each band in per-band mode, -1 if none
+    std::vector<int> bandOwner_;
+    std::vector<double> bandMetric_;
+    //! rows already visited by the per-band pass
+    std::vector<bool> served_;
+    BandLimitVector rowBandLimit_;
+
+    //! Batched version of prepareSchedule().
+    void prepareBatchedSchedule();
+
+    //! Fills the rate matrices and the weights, one row per schedulable connection.
+    void gatherRates();
+
+    //! Sorts rows [first, end) of order_ so that rows [first, last) hold the best scores.
+    void sortRows(unsigned int first, unsigned int last);
+
+    //! Assigns each band to the row with the best per-band PF metric.
+    void assignBands();
 
   public:
 
-    double& pfAlpha()
-    {
-        return pfAlpha_;
-    }
-
     // Scheduling functions ********************************************************************
 
-    //virtual void schedule ();
+    void setEnbScheduler(LteSchedulerEnb *eNbScheduler) override;
 
     void prepareSchedule() override;
 
-    void commitSchedule() override;
-
     // *****************************************************************************************
 
-    LtePf(Binder *binder, double pfAlpha) :
-        LteScheduler(binder),
-        pfAlpha_(pfAlpha)
-    {
-    }
+    LtePf(Binder *binder) : MetricScheduler<PfMetric>(binder) {}
 
 };
 
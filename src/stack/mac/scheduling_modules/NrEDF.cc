@@ -6,80 +6,80 @@
 #include "stack/mac/LteMacBase.h"
 #include "stack/mac/scheduling_modules/NrEDF.h"
 #include "stack/mac/scheduler/LteSchedulerEnb.h"
+#include "stack/mac/buffer/LteMacBuffer.h"
+#include "stack/mac/allocator/LteAllocationModule.h"
+#include "stack/mac/amc/LteAmc.h"
+#include <algorithm>
 
 namespace simu5g
 {
 
     using namespace omnetpp;
 
-    static inline int toResourceType(const std::string &s)
+    void NrEDF::setEnbScheduler(LteSchedulerEnb *eNbScheduler)
     {
-        if (s == "DCGBR")
-            return 0;
-        if (s == "GBR")
-            return 1;
-        if (s == "NGBR")
-            return 2;
-        return -1;
+        LteScheduler::setEnbScheduler(eNbScheduler);
+        wcttEstimator_.initialize(direction_, mac_, binder_);
+        admissionControl_ = mac_->par("edfAdmissionControl").boolValue();
+        // the heap walk ranks DC-GBR flows by deadline only and does not go through admission control
+        if (admissionControl_ && incremental_)
+            throw cRuntimeError("NrEDF::setEnbScheduler - edfAdmissionControl is not supported with edfIncremental");
     }
 
     // Function to compute priority
-    double NrEDF::compute_tb_priority(const transport_block &tb)
+    double NrEDF::compute_tb_priority(const transport_block &tb, qos_data::ResourceType type)
     {
-        auto params = get_qos_parameters(tb.mcp.qos_id);
+        const auto &params = get_qos_parameters(tb.mcp.qos_id);
 
         if (params.fiveQI == 0)
         {
             return -1; // Invalid QoS ID
         }
 
-        double absolute_deadline = params.packet_delay_budget + tb.mcp.arrival_time;
-
         // Compute the priority based on the resource type and the 5QI parameters
-        switch (toResourceType(params.resource_type))
+        switch (type)
         {
-        case 0:
+        case qos_data::DCGBR:
             return COMPUTE_PRIORITY_DCGBR(params, NOW.dbl(), tb);
-        case 1:
+        case qos_data::GBR:
             return COMPUTE_PRIORITY_GBR(params);
-        case 2:
+        case qos_data::NGBR:
             return COMPUTE_PRIORITY_NGBR(params);
         default:
             return -1; // Invalid Resource Type
         }
     }
 
-    double NrEDF::map_to_range(double min_value, double max_value, double value)
+    qos_data::ResourceType NrEDF::resource_type_of(MacCid cid, const MacPduMetaDataStore::Entry *head)
     {
-        return min_value + (max_value - min_value) * value;
+        const auto &params = get_qos_parameters(head->meta.fiveQi);
+        qos_data::ResourceType type = params.resource_type;
+        if (admissionControl_ && type == qos_data::DCGBR)
+            type = admit(cid, params);
+        return type;
     }
 
-    void NrEDF::queueing_by_resource_type(NrEDFScoreList &nrEdfQueue, double priority, MacCid cid, const transport_block &tb)
+    NrEDF::transport_block NrEDF::head_transport_block(MacCid cid, const MacPduMetaDataStore::Entry *head, qos_data::ResourceType type)
     {
-        auto params = get_qos_parameters(tb.mcp.qos_id);
-
-        // 3 bands: NGBR(0-32) < GBR(33-66) < DCGBR(+67)
-        double mappedPriority = 0, max_value = 0, min_value = 0;
-        switch (toResourceType(params.resource_type))
+        // the laxity of a DC-GBR PDU accounts for the time needed to deliver it
+        double wctt = 0;
+        LteMacBufferMap *buffers = (direction_ == DL) ? eNbScheduler_->vbuf_ : eNbScheduler_->bsrbuf_;
+        auto vit = buffers->find(cid);
+        if (type == qos_data::DCGBR && vit != buffers->end() && !vit->second->isEmpty())
         {
-        case 0: // DCGBR
-            max_value = 100.0;
-            min_value = 67.0;
-            break;
-        case 1: // GBR
-            max_value = 66.0;
-            min_value = 33.0;
-            break;
-        case 2: // NGBR
-            max_value = 32.0;
-            min_value = 0.0;
-            break;
-        default:
-            break;
+            simtime_t estimate = wcttEstimator_.estimate(cid, head->meta.fiveQi, vit->second->front().first, carrierFrequency_);
+            if (estimate != SIMTIME_MAX) // otherwise the UE is out of range, rank it by deadline only
+                wctt = estimate.dbl();
         }
 
-        mappedPriority = map_to_range(min_value, max_value, priority);
-        // std::cout << simTime() << " -> " << tb.mcp.qos_id << " | priority: " << priority << " (" << params.resource_type << ") mapped priority: " << mappedPriority << std::endl;
+        rlc_pdu rlcPDU = {head->meta.fiveQi, head->meta.arrivalTime.dbl()}; // RLC PDU metadata
+        return {rlcPDU, simTime().dbl(), wctt};                               // transport block with the head-of-line RLC PDU metadata
+    }
+
+    void NrEDF::queueing_by_resource_type(NrEDFScoreList &nrEdfQueue, double priority, MacCid cid, const transport_block &tb, qos_data::ResourceType type)
+    {
+        double mappedPriority = nr_edf_map_to_band(type, priority);
+        // std::cout << simTime() << " -> " << tb.mcp.qos_id << " | priority: " << priority << " (" << resourceTypeToA(type) << ") mapped priority: " << mappedPriority << std::endl;
         nrEdfQueue.push(NrEdfScoreDesc(cid, mappedPriority, tb.mcp.qos_id));
     }
 
@@ -89,22 +89,17 @@ namespace simu5g
         {
             NrEdfScoreDesc current = packets_queue.top();
 
-            // std::cout << simTime() << " | 5QI : " << current.qos_id << " Priority: " << current.priority << std::endl;
-            // static double last_time = simTime().dbl();
-            // if(last_time != simTime().dbl()){
-            //     last_time = simTime().dbl();
-            //     std::cout << "--------------------------------\n";
-            // }
-
-            // do not consider background traffic
+            // do not consider background traffic. The descriptor must be popped, or the loop keeps finding it on top
             if (MacCidToNodeId(current.cid) >= BGUE_MIN_ID)
+            {
+                packets_queue.pop();
                 continue;
+            }
 
             bool terminate = false, active = true, eligible = true;
             unsigned int granted = requestGrant(current.cid, std::numeric_limits<unsigned>::max(), terminate, active, eligible); // the scheduler computes how many bytes (or RBs) it can assign and extracts data accordingly —> this data forms the TB
 
             EV << "Granted " << granted << " bytes to cid " << current.cid << endl;
-            // std::cout << NOW << " | Granted " << granted << " bytes to cid " << current.cid << std::endl;
 
             if (terminate)
             {
@@ -122,25 +117,143 @@ namespace simu5g
                     EV << NOW << "NrEDF::execSchedule NOT ACTIVE" << endl;
                     carrierActiveConnectionSet_.erase(current.cid);
                     activeConnectionTempSet_.erase(current.cid);
-
-                    for (auto it = macPduMetaDataTempSet_.begin(); it != macPduMetaDataTempSet_.end();)
-                    {
-                        if (it->cid == current.cid)
-                        {
-                            it = macPduMetaDataTempSet_.erase(it);
-                        }
-                        else
-                        {
-
-                            ++it;
-                        }
-                    }
+                    macPduMetaDataTempErase_.push_back(current.cid);
                 }
             }
         }
         return 0;
     }
 
+    bool NrEDF::purge_if_node_left(MacCid cid)
+    {
+        MacNodeId nodeId = MacCidToNodeId(cid);
+        OmnetId id = binder_->getOmnetId(nodeId);
+        if (nodeId != NODEID_NONE && id != 0)
+            return false;
+
+        // node has left the simulation - erase corresponding CIDs
+        auto ait = admittedFlows_.find(cid);
+        if (ait != admittedFlows_.end())
+        {
+            admittedLoad_ -= ait->second.density;
+            admittedFlows_.erase(ait);
+        }
+        rejectedFlows_.erase(cid);
+        activeConnectionSet_->erase(cid);
+        activeConnectionTempSet_.erase(cid);
+        carrierActiveConnectionSet_.erase(cid);
+        macPduMetaDataTempErase_.push_back(cid);
+        return true;
+    }
+
+    void NrEDF::allocate_radio_resources_incremental()
+    {
+        // The metadata heap is already sorted by NR-EDF urgency and is kept up to date by
+        // LteMacEnb::macPduMake on arrival and by the grant, which pops the SDUs it serves
+        // entirely. Only the connections that are visited here are touched
+        for (const MacPduMetaDataStore::Entry *head = macPduMetaDataStore_->top(); head != nullptr; head = macPduMetaDataStore_->top())
+        {
+            MacCid cid = head->meta.cid;
+            macPduMetaDataStore_->skipTop();
+
+            // not active, or not allowed on this carrier
+            if (carrierActiveConnectionSet_.find(cid) == carrierActiveConnectionSet_.end())
+                continue;
+
+            // do not consider background traffic
+            if (MacCidToNodeId(cid) >= BGUE_MIN_ID || purge_if_node_left(cid))
+                continue;
+
+            bool terminate = false, active = true, eligible = true;
+            unsigned int granted = requestGrant(cid, std::numeric_limits<unsigned>::max(), terminate, active, eligible);
+
+            EV << "Granted " << granted << " bytes to cid " << cid << endl;
+
+            if (terminate)
+            {
+                EV << NOW << "NrEDF::execSchedule TERMINATE " << endl;
+                break;
+            }
+            // a connection still active and eligible after the grant could not be served completely,
+            // e.g. its UE has no codeword or allowed band left: the other connections may still fit
+            if (active && eligible)
+                continue;
+            if (!eligible)
+            {
+                // served SDUs bring the next head of the connection back into the heap
+                EV << NOW << "NrEDF::execSchedule NOT ELIGIBLE " << endl;
+                carrierActiveConnectionSet_.erase(cid);
+            }
+            else
+            {
+                EV << NOW << "NrEDF::execSchedule NOT ACTIVE" << endl;
+                carrierActiveConnectionSet_.erase(cid);
+                activeConnectionTempSet_.erase(cid);
+                macPduMetaDataTempErase_.push_back(cid);
+            }
+        }
+        macPduMetaDataStore_->restoreSkipped();
+    }
+
+    qos_data::ResourceType NrEDF::admit(MacCid cid, const qos_data::QoS5G &params)
+    {
+        if (admittedFlows_.find(cid) != admittedFlows_.end())
+            return qos_data::DCGBR;
+        if (rejectedFlows_.find(cid) != rejectedFlows_.end())
+            return qos_data::NGBR;
+
+        // the share of a flow is kept across the gaps between its bursts, up to its averaging window
+        simtime_t idleTimeout = std::max(params.packet_delay_budget, params.default_averaging_window) / 1000.0;
+
+        // a new DC-GBR flow: the set stays schedulable by EDF as long as the total
+        // density of its maximum data bursts does not exceed the carrier capacity
+        simtime_t wctt = wcttEstimator_.estimate(cid, params.fiveQI, params.default_max_data_burst_volume, carrierFrequency_);
+        double density = (wctt == SIMTIME_MAX) ? 1.0 : wctt.dbl() / (params.packet_delay_budget / 1000.0);
+        if (admittedLoad_ + density > 1.0)
+        {
+            EV_WARN << NOW << " NrEDF::admit - cid " << cid << " rejected, density " << density << " admitted load " << admittedLoad_ << endl;
+            // the load and the channel may have changed after the same timeout
+            rejectedFlows_[cid] = NOW + idleTimeout;
+            return qos_data::NGBR;
+        }
+
+        EV << NOW << " NrEDF::admit - cid " << cid << " admitted, density " << density << " admitted load " << admittedLoad_ << endl;
+        admittedFlows_[cid] = {density, NOW, idleTimeout};
+        admittedLoad_ += density;
+        return qos_data::DCGBR;
+    }
+
+    void NrEDF::release_idle_flows()
+    {
+        for (auto ait = admittedFlows_.begin(); ait != admittedFlows_.end();)
+        {
+            MacCid cid = ait->first;
+            admitted_flow &flow = ait->second;
+            if (macPduMetaDataStore_->front(cid) != nullptr)
+                flow.lastActive = NOW;
+            if (NOW - flow.lastActive <= flow.idleTimeout)
+            {
+                ++ait;
+                continue;
+            }
+
+            EV << NOW << " NrEDF::release_idle_flows - cid " << cid << " idle, density " << flow.density << " released" << endl;
+            admittedLoad_ -= flow.density;
+            ait = admittedFlows_.erase(ait);
+        }
+
+        for (auto rit = rejectedFlows_.begin(); rit != rejectedFlows_.end();)
+        {
+            if (rit->second > NOW)
+            {
+                ++rit;
+                continue;
+            }
+            EV << NOW << " NrEDF::release_idle_flows - cid " << rit->first << " rejected flow evaluated again" << endl;
+            rit = rejectedFlows_.erase(rit);
+        }
+    }
+
     void NrEDF::prepareSchedule()
     {
         EV << NOW << "NrEDF::execSchedule ############### gNodeB " << eNbScheduler_->mac_->getMacNodeId() << " ###############" << endl;
@@ -148,65 +261,212 @@ namespace simu5g
         // Create a working copy of the active set
         activeConnectionTempSet_ = *activeConnectionSet_;
 
-        macPduMetaDataTempSet_ = *macPduMetaDataSet_;
+        // metadata are dropped on commit only
+        macPduMetaDataTempErase_.clear();
+
+        if (incremental_)
+        {
+            allocate_radio_resources_incremental();
+            return;
+        }
 
-        // for(auto it : *macPduMetaDataSet_){
-        //     std::cout << it.arrivalTime << " | " << it.cid << " | " << it.fiveQi << std::endl;
-        // }
+        if (admissionControl_)
+            release_idle_flows();
 
         // Build the score list by cycling through the active connections.
         NrEDFScoreList nrEdfQueue;
 
-        FiveQI fiveQi = 0;
-        simtime_t Ai = 0;
-        for (MacCid cid : carrierActiveConnectionSet_) // iterating over active connections, not over individual packets or transport blocks
+        for (auto cit = carrierActiveConnectionSet_.begin(); cit != carrierActiveConnectionSet_.end();) // iterating over active connections, not over individual packets or transport blocks
+        {
+            MacCid cid = *cit++;
+            if (purge_if_node_left(cid))
+                continue;
+
+            // the oldest PDU of the connection is the one with the earliest deadline
+            const MacPduMetaDataStore::Entry *head = macPduMetaDataStore_->front(cid);
+            if (head == nullptr)
+                continue;
+
+            qos_data::ResourceType type = resource_type_of(cid, head);
+            transport_block tb = head_transport_block(cid, head, type);
+            double priority = compute_tb_priority(tb, type);
+            queueing_by_resource_type(nrEdfQueue, priority, cid, tb, type);
+        }
+
+        allocate_radio_resources(nrEdfQueue);
+    }
+
+    void NrEDF::commitSchedule()
+    {
+        *activeConnectionSet_ = activeConnectionTempSet_;
+        for (MacCid cid : macPduMetaDataTempErase_)
+            macPduMetaDataStore_->erase(cid);
+    }
+
+    unsigned int NrEDF::free_blocks(MacNodeId nodeId)
+    {
+        unsigned int freeBlocks = 0;
+        for (const auto &elem : *bandLimit_)
+        {
+            // bands of the other carriers are marked as unusable
+            if (elem.limit_.at(0) != -2)
+                freeBlocks += eNbScheduler_->allocator_->availableBlocks(nodeId, MACRO, elem.band_);
+        }
+        return freeBlocks;
+    }
+
+    void NrEDF::carrier_fit(MacNodeId nodeId, unsigned int bytes, unsigned int &freeBlocks, unsigned int &neededBlocks)
+    {
+        freeBlocks = 0;
+        neededBlocks = std::numeric_limits<unsigned>::max();
+
+        unsigned int bytesPerBlock = 0;
+        for (const auto &elem : *bandLimit_)
         {
-            MacNodeId nodeId = MacCidToNodeId(cid);
-            LogicalCid lcid = MacCidToLcid(cid);
-            OmnetId id = binder_->getOmnetId(nodeId);
+            // bands of the other carriers are marked as unusable
+            if (elem.limit_.at(0) == -2 || eNbScheduler_->allocator_->availableBlocks(nodeId, MACRO, elem.band_) == 0)
+                continue;
+
+            freeBlocks++;
+            if (bytesPerBlock == 0)
+                bytesPerBlock = mac_->getAmc()->computeBytesOnNRbs(nodeId, elem.band_, 0, 1, direction_, carrierFrequency_);
+        }
 
-            if (nodeId == NODEID_NONE || id == 0)
+        if (bytesPerBlock > 0)
+            neededBlocks = (bytes + bytesPerBlock - 1) / bytesPerBlock;
+    }
+
+    NrEDF *NrEDF::select_carrier(const std::vector<NrEDF *> &candidates, MacCid cid, unsigned int bytes, simtime_t deadline)
+    {
+        MacNodeId nodeId = MacCidToNodeId(cid);
+
+        NrEDF *best = nullptr;
+        bool bestInTime = false, bestFits = false;
+        unsigned int bestFree = 0;
+        for (NrEDF *carrier : candidates)
+        {
+            unsigned int freeBlocks, neededBlocks;
+            carrier->carrier_fit(nodeId, bytes, freeBlocks, neededBlocks);
+            if (freeBlocks == 0 || neededBlocks == std::numeric_limits<unsigned>::max())
+                continue;
+
+            // a TB is delivered at the end of the slot, whose duration depends on the numerology
+            simtime_t slotEnd = NOW + carrier->binder_->getSlotDurationFromNumerologyIndex(carrier->numerologyIndex_);
+            bool inTime = slotEnd <= deadline;
+            bool fits = freeBlocks >= neededBlocks;
+
+            // best fit: the tightest carrier that holds the whole SDU, otherwise the emptiest one
+            bool better = (best == nullptr);
+            if (!better && inTime != bestInTime)
+                better = inTime;
+            else if (!better && fits != bestFits)
+                better = fits;
+            else if (!better)
+                better = fits ? freeBlocks < bestFree : freeBlocks > bestFree;
+
+            if (better)
             {
-                // node has left the simulation - erase corresponding CIDs
-                activeConnectionSet_->erase(cid);
-                activeConnectionTempSet_.erase(cid);
-                carrierActiveConnectionSet_.erase(cid);
+                best = carrier;
+                bestInTime = inTime;
+                bestFits = fits;
+                bestFree = freeBlocks;
+            }
+        }
+        return best;
+    }
 
-                for (auto it = macPduMetaDataTempSet_.begin(); it != macPduMetaDataTempSet_.end();)
-                {
-                    if (it->cid == cid)
-                        it = macPduMetaDataTempSet_.erase(it);
+    void NrEDF::scheduleCrossCarrier(const std::vector<NrEDF *> &carriers)
+    {
+        if (carriers.empty())
+            return;
 
-                    else
-                        ++it;
-                }
+        // all the carriers share the active set and the metadata store of the cell
+        NrEDF *first = carriers.front();
+        LteSchedulerEnb *eNbScheduler = first->eNbScheduler_;
+        for (NrEDF *carrier : carriers)
+        {
+            carrier->activeConnectionSet_ = eNbScheduler->readActiveConnections();
+            carrier->macPduMetaDataStore_ = eNbScheduler->readMacPduMetaDataStore();
+            carrier->buildCarrierActiveConnectionSet();
+            carrier->activeConnectionTempSet_ = *carrier->activeConnectionSet_;
+            carrier->macPduMetaDataTempErase_.clear();
+        }
+
+        MacPduMetaDataStore *store = first->macPduMetaDataStore_;
+        std::vector<NrEDF *> open = carriers; // carriers with space left in this slot
+        std::vector<NrEDF *> candidates;
+        for (const MacPduMetaDataStore::Entry *head = store->top(); head != nullptr && !open.empty(); head = store->top())
+        {
+            MacCid cid = head->meta.cid;
+            simtime_t deadline = head->deadline;
+            store->skipTop();
+
+            // do not consider background traffic
+            if (MacCidToNodeId(cid) >= BGUE_MIN_ID)
                 continue;
+
+            bool left = false;
+            for (NrEDF *carrier : carriers)
+                left = carrier->purge_if_node_left(cid) || left;
+            if (left)
+                continue;
+
+            // carriers with space left on which the connection is active
+            candidates.clear();
+            for (NrEDF *carrier : open)
+            {
+                if (carrier->carrierActiveConnectionSet_.find(cid) != carrier->carrierActiveConnectionSet_.end())
+                    candidates.push_back(carrier);
             }
 
-            for (auto it = macPduMetaDataTempSet_.rbegin(); it != macPduMetaDataTempSet_.rend(); ++it)
+            auto vit = eNbScheduler->vbuf_->find(cid);
+            unsigned int bytes = MAC_HEADER + RLC_HEADER_UM;
+            if (vit != eNbScheduler->vbuf_->end() && !vit->second->isEmpty())
+                bytes += vit->second->front().first;
+
+            // a connection that does not fit in its chosen carrier spills over the others
+            while (!candidates.empty())
             {
-                if (it->cid == cid)
+                NrEDF *carrier = select_carrier(candidates, cid, bytes, deadline);
+                if (carrier == nullptr)
+                    break;
+
+                bool terminate = false, active = true, eligible = true;
+                unsigned int granted = carrier->requestGrant(cid, std::numeric_limits<unsigned>::max(), terminate, active, eligible);
+
+                EV << "Granted " << granted << " bytes to cid " << cid << " on carrier " << carrier->carrierFrequency_ << endl;
+
+                candidates.erase(std::find(candidates.begin(), candidates.end(), carrier));
+                if (!active)
+                {
+                    EV << NOW << "NrEDF::scheduleCrossCarrier NOT ACTIVE" << endl;
+                    for (NrEDF *c : carriers)
+                        c->carrierActiveConnectionSet_.erase(cid);
+                    first->activeConnectionTempSet_.erase(cid);
+                    first->macPduMetaDataTempErase_.push_back(cid);
+                    break;
+                }
+                if (!eligible)
+                {
+                    EV << NOW << "NrEDF::scheduleCrossCarrier NOT ELIGIBLE on carrier " << carrier->carrierFrequency_ << endl;
+                    carrier->carrierActiveConnectionSet_.erase(cid);
+                }
+
+                // still active: the rest of the connection spills over the other carriers, and this
+                // carrier is kept for the next connections until its blocks are used up
+                if (carrier->free_blocks(MacCidToNodeId(cid)) == 0)
                 {
-                    // std::cout << simTime().dbl() << " | " << cid << " UE | 5QI : " << it->fiveQi << std::endl;
-                    fiveQi = it->fiveQi;
-                    Ai = it->arrivalTime;
-                    // break; // we wanted the last one
-                    rlc_pdu rlcPDU = {fiveQi, Ai.dbl()};                  // RLC PDU metadata
-                    double wctt = 0;                                      // TODO
-                    transport_block tb = {rlcPDU, simTime().dbl(), wctt}; // Initialize transport block with the last RLC PDU metadata
-                    double priority = compute_tb_priority(tb);
-                    queueing_by_resource_type(nrEdfQueue, priority, cid, tb);
+                    EV << NOW << "NrEDF::scheduleCrossCarrier carrier " << carrier->carrierFrequency_ << " is full" << endl;
+                    open.erase(std::find(open.begin(), open.end(), carrier));
                 }
             }
         }
+        store->restoreSkipped();
 
-        allocate_radio_resources(nrEdfQueue);
-    }
-
-    void NrEDF::commitSchedule()
-    {
-        *activeConnectionSet_ = activeConnectionTempSet_;
-        *macPduMetaDataSet_ = macPduMetaDataTempSet_;
+        // commit once for all the carriers
+        *first->activeConnectionSet_ = first->activeConnectionTempSet_;
+        for (MacCid cid : first->macPduMetaDataTempErase_)
+            store->erase(cid);
     }
 
 } // namespace
@@ -9,25 +9,15 @@
 #define _NR_EDF_SCHEDULER_GNB_H_
 
 #include "stack/mac/scheduler/LteScheduler.h"
+#include "stack/mac/scheduler/WcttEstimator.h"
+#include "stack/mac/scheduling_modules/NrEdfPriority.h"
 #include "common/qos_data.h"
 #include <queue>
+#include <map>
+#include <set>
+#include <vector>
 #include <iostream>
 
-#define NORMALIZE(max, min, x) \
-  ((x - min) / (max - min))
-
-#define REV_NORMALIZE(max, min, x) \
-  ((max - x) / (max - min))
-
-#define COMPUTE_PRIORITY_DCGBR(params, t, tb) \
-  (t/(tb.mcp.arrival_time + params.packet_delay_budget)); // Di = Ai+PDF, P = t/Di, packet drop when P = 1
-
-#define COMPUTE_PRIORITY_GBR(params) \
-  (REV_NORMALIZE(MAX_GBR_LOG_PER, MIN_GBR_LOG_PER, params.packet_error_rate_exp));
-
-#define COMPUTE_PRIORITY_NGBR(params) \
-  (REV_NORMALIZE(MAX_NGBR_DLP, MIN_NGBR_DLP, params.default_priority_level));
-
 namespace simu5g
 {
 
@@ -65,18 +55,68 @@ namespace simu5g
 
     typedef std::priority_queue<NrEdfScoreDesc> NrEDFScoreList;
 
+    // If true, connections are served by walking the persistent metadata heap
+    // instead of rebuilding a score list every slot
+    bool incremental_;
+
+    // Worst-case transmission time of the head-of-line PDUs
+    WcttEstimator wcttEstimator_;
+
+    // If true, DC-GBR flows are admitted only while the DC-GBR set stays schedulable
+    bool admissionControl_ = false;
+
+    // Admitted DC-GBR flow
+    struct admitted_flow
+    {
+      double density;        // WCTT of a maximum data burst / PDB
+      simtime_t lastActive;  // last time the flow had a pending PDU
+      simtime_t idleTimeout; // idle time after which its density is released
+    };
+    std::map<MacCid, admitted_flow> admittedFlows_;
+
+    // Sum of the densities of the admitted DC-GBR flows
+    double admittedLoad_ = 0;
+
+    // Rejected DC-GBR flows, served as non-GBR traffic until the given time, when they are evaluated again
+    std::map<MacCid, simtime_t> rejectedFlows_;
+
     // Resource Type Based Priority
-    double compute_tb_priority(const transport_block &tb);
-    void queueing_by_resource_type(NrEDFScoreList &nrEdfQueue, double priority, MacCid cid, const transport_block &tb);
+    double compute_tb_priority(const transport_block &tb, qos_data::ResourceType type);
+    void queueing_by_resource_type(NrEDFScoreList &nrEdfQueue, double priority, MacCid cid, const transport_block &tb, qos_data::ResourceType type);
+    qos_data::ResourceType admit(MacCid cid, const qos_data::QoS5G &params);
+    // Releases the density of the admitted flows that have been idle for longer than their timeout,
+    // and lets the rejected flows whose timeout has expired go through admission control again
+    void release_idle_flows();
+    // Resource type of the connection, given its head-of-line PDU (DC-GBR flows go through admission control)
+    qos_data::ResourceType resource_type_of(MacCid cid, const MacPduMetaDataStore::Entry *head);
+    // Transport block carrying the head-of-line PDU, with its WCTT for DC-GBR
+    transport_block head_transport_block(MacCid cid, const MacPduMetaDataStore::Entry *head, qos_data::ResourceType type);
     int allocate_radio_resources(NrEDFScoreList &packets_queue);
-    double map_to_range(double min_value, double max_value, double value);
+    void allocate_radio_resources_incremental();
+    bool purge_if_node_left(MacCid cid);
+
+    // Free blocks of this carrier for the given UE in the current slot
+    unsigned int free_blocks(MacNodeId nodeId);
+    // Free blocks of this carrier in the current slot, and blocks needed on it to carry
+    // the given bytes to the given UE (UINT_MAX if the UE cannot be served on this carrier)
+    void carrier_fit(MacNodeId nodeId, unsigned int bytes, unsigned int &freeBlocks, unsigned int &neededBlocks);
+    static NrEDF *select_carrier(const std::vector<NrEDF *> &candidates, MacCid cid, unsigned int bytes, simtime_t deadline);
 
   public:
-    NrEDF(Binder *binder) : LteScheduler(binder)
+    NrEDF(Binder *binder, bool incremental = false) : LteScheduler(binder), incremental_(incremental)
     {
     }
+    void setEnbScheduler(LteSchedulerEnb *eNbScheduler) override;
     void prepareSchedule() override;
     void commitSchedule() override;
+
+    /**
+     * Cross-carrier NR-EDF: serves all the given carriers, i.e. those due in the current slot,
+     * with a single walk of the shared metadata heap. Each connection is assigned to the
+     * carrier whose free blocks best fit its head-of-line SDU, preferring carriers whose slot
+     * ends before the SDU deadline
+     */
+    static void scheduleCrossCarrier(const std::vector<NrEDF *> &carriers);
   };
 
 } // namespace
@@ -0,0 +1,61 @@
+// Authors: Alaf Nascimento, Philippe Martins, Samuel Tardieu, and Laurent Pautet
+// Contact: {firstname.lastname}@telecom-paris.fr
+// Description: NR-EDF priority model, shared by the scheduler and the offline schedulability analysis
+//
+
+#ifndef _NR_EDF_PRIORITY_H_
+#define _NR_EDF_PRIORITY_H_
+
+#include "common/qos_data.h"
+
+#define NORMALIZE(max, min, x) \
+  ((x - min) / (max - min))
+
+#define REV_NORMALIZE(max, min, x) \
+  ((max - x) / (max - min))
+
+#define COMPUTE_PRIORITY_DCGBR(params, t, tb) \
+  ((t + tb.wctt - tb.mcp.arrival_time) / (params.packet_delay_budget / 1000.0)) // Li = Ai+PDB-t-WCTTi, P = 1-Li/PDB, no slack left when P = 1
+
+#define COMPUTE_PRIORITY_GBR(params) \
+  (REV_NORMALIZE(MAX_GBR_LOG_PER, MIN_GBR_LOG_PER, params.packet_error_rate_exp))
+
+#define COMPUTE_PRIORITY_NGBR(params) \
+  (REV_NORMALIZE(MAX_NGBR_DLP, MIN_NGBR_DLP, params.default_priority_level))
+
+namespace simu5g
+{
+
+  inline double nr_edf_map_to_range(double min_value, double max_value, double value)
+  {
+    return min_value + (max_value - min_value) * value;
+  }
+
+  // Maps a priority computed within a resource type to the global NR-EDF scale
+  // 3 bands: NGBR(0-32) < GBR(33-66) < DCGBR(+67)
+  inline double nr_edf_map_to_band(qos_data::ResourceType type, double priority)
+  {
+    double max_value = 0, min_value = 0;
+    switch (type)
+    {
+    case qos_data::DCGBR:
+      max_value = 100.0;
+      min_value = 67.0;
+      break;
+    case qos_data::GBR:
+      max_value = 66.0;
+      min_value = 33.0;
+      break;
+    case qos_data::NGBR:
+      max_value = 32.0;
+      min_value = 0.0;
+      break;
+    default:
+      break;
+    }
+    return nr_edf_map_to_range(min_value, max_value, priority);
+  }
+
+} // namespace
+
+#endif // _NR_EDF_PRIORITY_H_
@@ -0,0 +1,301 @@
+//
+//                  Simu5G-NR-EDF (Extension of Simu5G)
+//
+// Original Authors: Giovanni Nardini, Giovanni Stea, Antonio Virdis (University of Pisa)
+// Extension Authors: Alaf Nascimento, Philippe Martins, Samuel Tardieu, Laurent Pautet (Institut Polytechnique de Paris)
+//
+// This file is part of a software released under the license included in file
+// "license.pdf". Please read LICENSE and README files before using it.
+// The above files and the present reference are part of the software itself,
+// and cannot be removed from it.
+//
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#include "stack/mac/scheduling_modules/NrHierarchical.h"
+#include "stack/mac/scheduler/LteSchedulerEnb.h"
+
+namespace simu5g
+{
+
+    using namespace omnetpp;
+
+    Register_LteScheduler("HIERARCHICAL", NrHierarchical);
+
+    simsignal_t NrHierarchical::blocksSignal_[NUM_LEVELS][2] = {
+        {cComponent::registerSignal("hierDcGbrBlocksDl"), cComponent::registerSignal("hierDcGbrBlocksUl")},
+        {cComponent::registerSignal("hierGbrBlocksDl"), cComponent::registerSignal("hierGbrBlocksUl")},
+        {cComponent::registerSignal("hierNgbrBlocksDl"), cComponent::registerSignal("hierNgbrBlocksUl")}};
+    simsignal_t NrHierarchical::bytesSignal_[NUM_LEVELS][2] = {
+        {cComponent::registerSignal("hierDcGbrBytesDl"), cComponent::registerSignal("hierDcGbrBytesUl")},
+        {cComponent::registerSignal("hierGbrBytesDl"), cComponent::registerSignal("hierGbrBytesUl")},
+        {cComponent::registerSignal("hierNgbrBytesDl"), cComponent::registerSignal("hierNgbrBytesUl")}};
+
+    void NrHierarchical::setEnbScheduler(LteSchedulerEnb *eNbScheduler)
+    {
+        NrEDF::setEnbScheduler(eNbScheduler);
+
+        dcGbrBlockShare_ = mac_->par("hierDcGbrBlockShare").doubleValue();
+        if (dcGbrBlockShare_ < 0 || dcGbrBlockShare_ > 1)
+            throw cRuntimeError("NrHierarchical::setEnbScheduler - hierDcGbrBlockShare must be in [0,1], %f given", dcGbrBlockShare_);
+        gbrTargetRate_ = mac_->par("hierGbrRate").doubleValue();
+        drr_ = strcmp(mac_->par("hierBestEffortPolicy").stringValue(), "DRR") == 0;
+        drrQuantum_ = mac_->par("hierDrrQuantum").intValue();
+        pf_.initialize(mac_.get());
+    }
+
+    double NrHierarchical::average_rate(MacCid cid)
+    {
+        auto it = gbrRate_.find(cid);
+        if (it == gbrRate_.end() || it->second.window <= 0)
+            return 0;
+        const GbrRate &r = it->second;
+        return r.rate * std::exp(-(NOW - r.lastUpdate).dbl() / r.window);
+    }
+
+    void NrHierarchical::classify_connections()
+    {
+        dcGbr_.clear();
+        gbr_.clear();
+        ngbr_.clear();
+
+        for (auto cit = carrierActiveConnectionSet_.begin(); cit != carrierActiveConnectionSet_.end();)
+        {
+            MacCid cid = *cit++;
+
+            // do not consider background traffic
+            if (MacCidToNodeId(cid) >= BGUE_MIN_ID)
+                continue;
+            if (purge_if_node_left(cid))
+            {
+                gbrRate_.erase(cid);
+                drrDeficit_.erase(cid);
+                continue;
+            }
+
+            // connections without metadata (e.g. in the uplink) are best-effort
+            const MacPduMetaDataStore::Entry *head = macPduMetaDataStore_->front(cid);
+            qos_data::ResourceType type = (head == nullptr) ? qos_data::NGBR : resource_type_of(cid, head);
+            if (type == qos_data::DCGBR)
+            {
+                transport_block tb = head_transport_block(cid, head, type);
+                dcGbr_.emplace_back(cid, compute_tb_priority(tb, type), tb.mcp.qos_id);
+            }
+            else if (type == qos_data::GBR)
+            {
+                GbrRate &r = gbrRate_[cid];
+                if (r.window <= 0)
+                {
+                    r.window = get_qos_parameters(head->meta.fiveQi).default_averaging_window / 1000.0;
+                    r.lastUpdate = NOW;
+                }
+
+                // GBR flows above their target compete with the best-effort ones
+                double rate = average_rate(cid);
+                if (rate < gbrTargetRate_)
+                    gbr_.emplace_back(rate / gbrTargetRate_, cid);
+                else
+                    ngbr_.push_back(cid);
+            }
+            else
+                ngbr_.push_back(cid);
+        }
+    }
+
+    unsigned int NrHierarchical::grant(MacCid cid, unsigned int bytes, Level level, bool &terminate)
+    {
+        unsigned int freeBlocks = eNbScheduler_->readTotalAvailableRbs();
+        bool active = true, eligible = true;
+        terminate = false;
+        unsigned int granted = requestGrant(cid, bytes, terminate, active, eligible);
+
+        EV << NOW << " NrHierarchical::grant - level " << level << " granted " << granted << " bytes to cid " << cid << endl;
+
+        levelBlocks_[level] += freeBlocks - eNbScheduler_->readTotalAvailableRbs();
+        levelBytes_[level] += granted;
+        if (gbrRate_.find(cid) != gbrRate_.end())
+            gbrGranted_[cid] += granted;
+
+        if (!active)
+        {
+            carrierActiveConnectionSet_.erase(cid);
+            activeConnectionTempSet_.erase(cid);
+            macPduMetaDataTempErase_.push_back(cid);
+        }
+        else if (!eligible)
+            carrierActiveConnectionSet_.erase(cid);
+
+        return granted;
+    }
+
+    bool NrHierarchical::schedule_dc_gbr()
+    {
+        if (dcGbr_.empty())
+            return true;
+
+        // highest NR-EDF priority first
+        std::stable_sort(dcGbr_.begin(), dcGbr_.end(), [](const NrEdfScoreDesc &a, const NrEdfScoreDesc &b) {
+            return a.priority > b.priority;
+        });
+
+        // bands of the other carriers are marked as unusable
+        unsigned int carrierBlocks = 0;
+        for (const auto &elem : *bandLimit_)
+        {
+            if (elem.limit_.at(0) != -2)
+                carrierBlocks++;
+        }
+        unsigned int cap = std::floor(dcGbrBlockShare_ * carrierBlocks);
+
+        ConnectionView view;
+        for (const NrEdfScoreDesc &current : dcGbr_)
+        {
+            if (levelBlocks_[DCGBR_LEVEL] >= cap)
+                break;
+
+            // below the whole carrier, the grant is limited to the bytes the UE gets on the blocks left under the cap
+            unsigned int bytes = std::numeric_limits<unsigned>::max();
+            if (cap < carrierBlocks)
+            {
+                if (!readConnectionView(current.cid, view) || view.availableBlocks == 0)
+                    continue;
+                bytes = view.availableBytes / view.availableBlocks * (cap - levelBlocks_[DCGBR_LEVEL]);
+                if (bytes == 0)
+                    continue;
+            }
+
+            bool terminate;
+            grant(current.cid, bytes, DCGBR_LEVEL, terminate);
+            if (terminate)
+                return false;
+        }
+        return true;
+    }
+
+    bool NrHierarchical::schedule_gbr()
+    {
+        // most starved flow first
+        std::sort(gbr_.begin(), gbr_.end());
+
+        for (const auto &[ratio, cid] : gbr_)
+        {
+            // bytes that bring the average rate of the flow back to the target
+            double deficit = std::ceil((gbrTargetRate_ - average_rate(cid)) * gbrRate_[cid].window / 8);
+            unsigned int bytes = std::min(deficit, double(std::numeric_limits<unsigned>::max()));
+
+            bool terminate;
+            grant(cid, bytes, GBR_LEVEL, terminate);
+            if (terminate)
+                return false;
+
+            // still backlogged: the flow competes with the best-effort ones for the rest of the slot
+            if (carrierActiveConnectionSet_.find(cid) != carrierActiveConnectionSet_.end())
+                ngbr_.push_back(cid);
+        }
+        return true;
+    }
+
+    bool NrHierarchical::schedule_best_effort_pf()
+    {
+        pfScores_.clear();
+        ConnectionView view;
+        for (MacCid cid : ngbr_)
+        {
+            if (carrierActiveConnectionSet_.find(cid) != carrierActiveConnectionSet_.end() && readConnectionView(cid, view))
+                pfScores_.emplace_back(pf_.score(view), cid);
+        }
+        std::stable_sort(pfScores_.begin(), pfScores_.end(), [](const auto &a, const auto &b) {
+            return a.first > b.first;
+        });
+
+        for (const auto &[score, cid] : pfScores_)
+        {
+            bool terminate;
+            pf_.granted(cid, grant(cid, std::numeric_limits<unsigned>::max(), NGBR_LEVEL, terminate));
+            if (terminate)
+                return false;
+        }
+        return true;
+    }
+
+    bool NrHierarchical::schedule_best_effort_drr()
+    {
+        if (ngbr_.empty())
+            return true;
+
+        // round-robin order, starting from where the previous slot stopped
+        std::sort(ngbr_.begin(), ngbr_.end());
+        size_t first = std::lower_bound(ngbr_.begin(), ngbr_.end(), drrNext_) - ngbr_.begin();
+        size_t n = ngbr_.size();
+        drrNext_ = ngbr_[(first + 1) % n];
+
+        for (size_t k = 0; k < n; k++)
+        {
+            MacCid cid = ngbr_[(first + k) % n];
+            if (carrierActiveConnectionSet_.find(cid) == carrierActiveConnectionSet_.end())
+                continue;
+
+            unsigned int &deficit = drrDeficit_[cid];
+            deficit += drrQuantum_;
+
+            bool terminate;
+            unsigned int granted = grant(cid, deficit, NGBR_LEVEL, terminate);
+            deficit -= std::min(granted, deficit);
+
+            // an idle connection does not keep its deficit
+            if (activeConnectionTempSet_.find(cid) == activeConnectionTempSet_.end())
+                drrDeficit_.erase(cid);
+
+            if (terminate)
+            {
+                drrNext_ = cid;
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void NrHierarchical::prepareSchedule()
+    {
+        EV << NOW << " NrHierarchical::prepareSchedule ############### gNodeB " << mac_->getMacNodeId() << " ###############" << endl;
+
+        activeConnectionTempSet_ = *activeConnectionSet_;
+        macPduMetaDataTempErase_.clear();
+        gbrGranted_.clear();
+        std::fill(levelBlocks_, levelBlocks_ + NUM_LEVELS, 0);
+        std::fill(levelBytes_, levelBytes_ + NUM_LEVELS, 0);
+
+        if (admissionControl_)
+            release_idle_flows();
+
+        classify_connections();
+        if (schedule_dc_gbr() && schedule_gbr())
+            drr_ ? schedule_best_effort_drr() : schedule_best_effort_pf();
+
+        int dir = (direction_ == DL) ? 0 : 1;
+        for (int level = 0; level < NUM_LEVELS; level++)
+        {
+            emitStatistic(blocksSignal_[level][dir], levelBlocks_[level]);
+            emitStatistic(bytesSignal_[level][dir], levelBytes_[level]);
+        }
+    }
+
+    void NrHierarchical::commitSchedule()
+    {
+        for (const auto &[cid, granted] : gbrGranted_)
+        {
+            GbrRate &r = gbrRate_[cid];
+            if (r.window <= 0)
+                continue;
+            r.rate = average_rate(cid) + granted * 8 / r.window;
+            r.lastUpdate = NOW;
+        }
+        pf_.commit(eNbScheduler_->getResourceBlocks());
+
+        NrEDF::commitSchedule();
+    }
+
+} // namespace
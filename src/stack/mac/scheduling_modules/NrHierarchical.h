@@ -0,0 +1,114 @@
+//
+//                  Simu5G-NR-EDF (Extension of Simu5G)
+//
+// Original Authors: Giovanni Nardini, Giovanni Stea, Antonio Virdis (University of Pisa)
+// Extension Authors: Alaf Nascimento, Philippe Martins, Samuel Tardieu, Laurent Pautet (Institut Polytechnique de Paris)
+//
+// This file is part of a software released under the license included in file
+// "license.pdf". Please read LICENSE and README files before using it.
+// The above files and the present reference are part of the software itself,
+// and cannot be removed from it.
+//
+
+#ifndef _LTE_NRHIERARCHICAL_H_
+#define _LTE_NRHIERARCHICAL_H_
+
+#include "common/FlatSet.h"
+#include "stack/mac/scheduling_modules/NrEDF.h"
+#include "stack/mac/scheduling_modules/SchedulingMetrics.h"
+
+namespace simu5g
+{
+
+  /**
+   * Hierarchical scheduler, registered as "HIERARCHICAL". Each slot is shared by three levels, each one
+   * working on the blocks left by the previous ones:
+   *
+   *  1. DC-GBR flows, in NR-EDF order, on at most hierDcGbrBlockShare of the blocks of the carrier;
+   *  2. GBR flows whose average rate over the averaging window of their 5QI is below hierGbrRate,
+   *     most starved first, each one granted the bytes that bring its average back to the target;
+   *  3. all the other flows (non-GBR, and GBR above target), by proportional fair or deficit round robin.
+   *
+   * The blocks and bytes served by each level are recorded as separate statistics.
+   */
+  class NrHierarchical : public NrEDF
+  {
+  protected:
+    enum Level
+    {
+      DCGBR_LEVEL,
+      GBR_LEVEL,
+      NGBR_LEVEL,
+      NUM_LEVELS
+    };
+
+    // Average rate of a GBR flow: exponential average over the averaging window of its 5QI
+    struct GbrRate
+    {
+      double rate = 0;   // bps
+      double window = 0; // s
+      simtime_t lastUpdate;
+    };
+
+    // Per-level statistics, indexed by level and direction (0 for DL, 1 for UL)
+    static simsignal_t blocksSignal_[NUM_LEVELS][2];
+    static simsignal_t bytesSignal_[NUM_LEVELS][2];
+
+    // Share of the blocks of the carrier that DC-GBR flows can take in a slot
+    double dcGbrBlockShare_ = 1.0;
+    // Target rate of the GBR flows
+    double gbrTargetRate_ = 0;
+    // If true, the best-effort level is served by DRR, otherwise by PF
+    bool drr_ = false;
+    // Bytes added to the deficit of a connection at each DRR round
+    unsigned int drrQuantum_ = 0;
+
+    // Connections of the current slot, by level
+    std::vector<NrEdfScoreDesc> dcGbr_;
+    std::vector<std::pair<double, MacCid>> gbr_;
+    std::vector<MacCid> ngbr_;
+
+    FlatMap<MacCid, GbrRate> gbrRate_;
+    // Bytes granted in the current slot to the GBR flows
+    FlatMap<MacCid, unsigned int> gbrGranted_;
+
+    // PF state of the best-effort level
+    PfMetric pf_;
+    std::vector<std::pair<double, MacCid>> pfScores_;
+
+    // DRR state of the best-effort level: deficit of each connection, and the connection the next round starts from
+    FlatMap<MacCid, unsigned int> drrDeficit_;
+    MacCid drrNext_ = 0;
+
+    // Blocks and bytes served by each level in the current slot
+    unsigned int levelBlocks_[NUM_LEVELS];
+    unsigned int levelBytes_[NUM_LEVELS];
+
+    // Splits the active connections of the carrier among the levels
+    void classify_connections();
+    // Average rate of the GBR flow at the current time
+    double average_rate(MacCid cid);
+
+    /*
+     * Grants the connection at most the given bytes, accounts the served blocks and bytes to the level
+     * and updates the active sets. terminate is set if no space is left in the slot
+     */
+    unsigned int grant(MacCid cid, unsigned int bytes, Level level, bool &terminate);
+
+    // Each level returns false if no space is left for the next ones
+    bool schedule_dc_gbr();
+    bool schedule_gbr();
+    bool schedule_best_effort_pf();
+    bool schedule_best_effort_drr();
+
+  public:
+    NrHierarchical(Binder *binder) : NrEDF(binder) {}
+
+    void setEnbScheduler(LteSchedulerEnb *eNbScheduler) override;
+    void prepareSchedule() override;
+    void commitSchedule() override;
+  };
+
+} // namespace
+
+#endif
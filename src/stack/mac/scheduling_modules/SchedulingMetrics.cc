@@ -0,0 +1,33 @@
+//
+//                  Simu5G-NR-EDF (Extension of Simu5G)
+//
+// Original Authors: Giovanni Nardini, Giovanni Stea, Antonio Virdis (University of Pisa)
+// Extension Authors: Alaf Nascimento, Philippe Martins, Samuel Tardieu, Laurent Pautet (Institut Polytechnique de Paris)
+//
+// This file is part of a software released under the license included in file
+// "license.pdf". Please read LICENSE and README files before using it.
+// The above files and the present reference are part of the software itself,
+// and cannot be removed from it.
+//
+
+#include "stack/mac/scheduling_modules/SchedulingMetrics.h"
+
+namespace simu5g {
+
+void PfMetric::initialize(LteMacEnb *mac)
+{
+    initialize(mac->par("pfAlpha").doubleValue());
+    blur_ = true;
+}
+
+void PfMetric::commit(unsigned int totalBlocks)
+{
+    for (const auto& [cid, granted] : grantedBytes_) {
+        double shortTermRate = (totalBlocks > 0) ? double(granted) / double(totalBlocks) : 0.0;
+        double& longTermRate = pfRate_[cid];
+        longTermRate = (1.0 - pfAlpha_) * longTermRate + pfAlpha_ * shortTermRate;
+    }
+    grantedBytes_.clear();
+}
+
+} //namespace
@@ -0,0 +1,93 @@
+//
+//                  Simu5G-NR-EDF (Extension of Simu5G)
+//
+// Original Authors: Giovanni Nardini, Giovanni Stea, Antonio Virdis (University of Pisa)
+// Extension Authors: Alaf Nascimento, Philippe Martins, Samuel Tardieu, Laurent Pautet (Institut Polytechnique de Paris)
+//
+// This file is part of a software released under the license included in file
+// "license.pdf". Please read LICENSE and README files before using it.
+// The above files and the present reference are part of the software itself,
+// and cannot be removed from it.
+//
+
+#ifndef _LTE_SCHEDULINGMETRICS_H_
+#define _LTE_SCHEDULINGMETRICS_H_
+
+#include "common/FlatSet.h"
+#include "stack/mac/scheduler/MetricScheduler.h"
+
+namespace simu5g {
+
+/**
+ * Max C/I: connections are served in decreasing order of bytes per block. Policy of LteMaxCi.
+ */
+struct MaxCiMetric
+{
+    static constexpr bool servesBackground = true;
+
+    void initialize(LteMacEnb *mac) {}
+
+    double score(const ConnectionView& connection) const
+    {
+        return (connection.availableBlocks > 0) ? connection.availableBytes / connection.availableBlocks : 0;
+    }
+
+    double backgroundScore(int bytesPerBlock) const { return bytesPerBlock; }
+
+    void granted(MacCid cid, unsigned int bytes) {}
+    void commit(unsigned int totalBlocks) {}
+};
+
+/**
+ * Proportional fair: bytes per block over the long-term rate of the connection. Policy of LtePf,
+ * the smoothing factor is the "pfAlpha" parameter.
+ */
+class PfMetric
+{
+  protected:
+    /// long-term rate of each connection
+    FlatMap<MacCid, double> pfRate_;
+    /// bytes granted in the current period to each scored connection
+    FlatMap<MacCid, unsigned int> grantedBytes_;
+    double pfAlpha_ = 0.95;
+    /// whether the scores are blurred by a random offset, as in the original LtePf
+    bool blur_ = false;
+
+  public:
+    /// small number to prefer the connections that were never served
+    static constexpr double scoreEpsilon_ = 0.000001;
+
+    static constexpr bool servesBackground = false;
+
+    void initialize(LteMacEnb *mac);
+    /// Outside the simulation (e.g. tools/replay), the smoothing factor is given directly and the
+    /// scores are not blurred
+    void initialize(double pfAlpha) { pfAlpha_ = pfAlpha; }
+
+    double score(const ConnectionView& connection)
+    {
+        grantedBytes_[connection.cid] = 0;
+        double rate = pfRate_[connection.cid];
+        if (rate < scoreEpsilon_)
+            return 1.0 / scoreEpsilon_;
+        if (connection.availableBlocks == 0)
+            return 0.0;
+        double score = (connection.availableBytes / connection.availableBlocks) / rate;
+        if (blur_)
+            score += CellSchedulingPool::uniform(-scoreEpsilon_ / 2.0, scoreEpsilon_ / 2.0);
+        return score;
+    }
+
+    double backgroundScore(int bytesPerBlock) const { return 0.0; }
+
+    /// Long-term rate of a connection, zero if it was never scored
+    double rate(MacCid cid) { return pfRate_[cid]; }
+
+    void granted(MacCid cid, unsigned int bytes) { grantedBytes_[cid] += bytes; }
+
+    void commit(unsigned int totalBlocks);
+};
+
+} //namespace
+
+#endif
@@ -0,0 +1,169 @@
+//
+//                  Simu5G-NR-EDF (Extension of Simu5G)
+//
+// Original Authors: Giovanni Nardini, Giovanni Stea, Antonio Virdis (University of Pisa)
+// Extension Authors: Alaf Nascimento, Philippe Martins, Samuel Tardieu, Laurent Pautet (Institut Polytechnique de Paris)
+//
+// This file is part of a software released under the license included in file
+// "license.pdf". Please read LICENSE and README files before using it.
+// The above files and the present reference are part of the software itself,
+// and cannot be removed from it.
+//
+
+#include "stack/mac/scheduling_modules/solver/GlpkSchedulerSolver.h"
+
+#ifdef WITH_GLPK
+
+#include <climits>
+
+#include <glpk.h>
+#include <omnetpp.h>
+
+namespace simu5g {
+
+using namespace omnetpp;
+
+void GlpkSchedulerSolver::callback(glp_tree *tree, void *info)
+{
+    GlpkSchedulerSolver *solver = static_cast<GlpkSchedulerSolver *>(info);
+    if (glp_ios_reason(tree) == GLP_IHEUR && !solver->incumbentSent_) {
+        glp_ios_heur_sol(tree, solver->incumbentColumns_.data());
+        solver->incumbentSent_ = true;
+    }
+}
+
+void GlpkSchedulerSolver::solve(const MultiBandProblem& problem, const std::vector<MacNodeId>& warmStart,
+        std::vector<MacNodeId>& bandOwner)
+{
+    const unsigned int numBands = problem.numBands;
+    const unsigned int numUes = problem.ues.size();
+    if (numBands > MAX_BANDS)
+        throw cRuntimeError("GlpkSchedulerSolver::solve - %u bands, at most %u are supported. Use the greedy solver",
+                numBands, MAX_BANDS);
+
+    // the heuristic solution is the initial incumbent, and the result if the MILP fails
+    heuristic_.solve(problem, warmStart, incumbent_);
+    bandOwner = incumbent_;
+    if (numUes == 0 || numBands == 0)
+        return;
+
+    // band configurations 1 .. numConfigs, bit b set if band b is used
+    const unsigned int numConfigs = (1u << numBands) - 1;
+
+    // columns: for each UE, the bytes served then one binary per configuration
+    auto servedColumn = [&](unsigned int u) { return u * (numConfigs + 1) + 1; };
+    auto configColumn = [&](unsigned int u, unsigned int c) { return u * (numConfigs + 1) + 1 + c; };
+    const int numColumns = numUes * (numConfigs + 1);
+
+    glp_prob *lp = glp_create_prob();
+    glp_set_obj_dir(lp, GLP_MAX);
+    glp_add_cols(lp, numColumns);
+
+    // rows: one configuration per UE, served bytes of each UE, one UE per band
+    glp_add_rows(lp, 2 * numUes + numBands);
+    std::vector<int> ia(1), ja(1);
+    std::vector<double> ar(1);
+    auto addEntry = [&](int row, int column, double value) {
+        ia.push_back(row);
+        ja.push_back(column);
+        ar.push_back(value);
+    };
+
+    for (unsigned int u = 0; u < numUes; u++) {
+        int oneConfigRow = 2 * u + 1;
+        int servedRow = 2 * u + 2;
+        glp_set_row_bnds(lp, oneConfigRow, GLP_UP, 0.0, 1.0);
+        glp_set_row_bnds(lp, servedRow, GLP_UP, 0.0, 0.0);
+
+        int y = servedColumn(u);
+        if (problem.queue[u] == 0)
+            glp_set_col_bnds(lp, y, GLP_FX, 0.0, 0.0);
+        else
+            glp_set_col_bnds(lp, y, GLP_DB, 0.0, problem.queue[u]);
+        glp_set_obj_coef(lp, y, 1.0);
+        addEntry(servedRow, y, 1.0);
+
+        for (unsigned int c = 1; c <= numConfigs; c++) {
+            unsigned int count = 0;
+            unsigned int minRate = UINT_MAX;
+            for (unsigned int b = 0; b < numBands; b++) {
+                if (c & (1u << b)) {
+                    count++;
+                    minRate = std::min(minRate, problem.rate[u][b]);
+                }
+            }
+            int column = configColumn(u, c);
+            glp_set_col_kind(lp, column, GLP_BV);
+            addEntry(oneConfigRow, column, 1.0);
+            addEntry(servedRow, column, -(double)count * minRate);
+            for (unsigned int b = 0; b < numBands; b++) {
+                if (c & (1u << b))
+                    addEntry(2 * numUes + b + 1, column, 1.0);
+            }
+        }
+    }
+    for (unsigned int b = 0; b < numBands; b++)
+        glp_set_row_bnds(lp, 2 * numUes + b + 1, GLP_UP, 0.0, 1.0);
+    glp_load_matrix(lp, ia.size() - 1, ia.data(), ja.data(), ar.data());
+
+    // incumbent as column values
+    incumbentColumns_.assign(numColumns + 1, 0.0);
+    std::vector<unsigned int> mask(numUes, 0);
+    for (unsigned int b = 0; b < numBands; b++) {
+        if (incumbent_[b] == NODEID_NONE)
+            continue;
+        unsigned int u = std::find(problem.ues.begin(), problem.ues.end(), incumbent_[b]) - problem.ues.begin();
+        mask[u] |= 1u << b;
+    }
+    for (unsigned int u = 0; u < numUes; u++) {
+        if (mask[u] == 0)
+            continue;
+        unsigned int count = 0;
+        unsigned int minRate = UINT_MAX;
+        for (unsigned int b = 0; b < numBands; b++) {
+            if (mask[u] & (1u << b)) {
+                count++;
+                minRate = std::min(minRate, problem.rate[u][b]);
+            }
+        }
+        incumbentColumns_[configColumn(u, mask[u])] = 1.0;
+        incumbentColumns_[servedColumn(u)] = problem.served(u, count, minRate);
+    }
+    incumbentSent_ = false;
+
+    // LP relaxation, then branch-and-bound (without presolver, so that the incumbent refers to our columns)
+    glp_smcp simplexParams;
+    glp_init_smcp(&simplexParams);
+    simplexParams.msg_lev = GLP_MSG_OFF;
+    glp_iocp mipParams;
+    glp_init_iocp(&mipParams);
+    mipParams.msg_lev = GLP_MSG_OFF;
+    mipParams.presolve = GLP_OFF;
+    mipParams.cb_func = &GlpkSchedulerSolver::callback;
+    mipParams.cb_info = this;
+    if (timeLimit_ > 0)
+        mipParams.tm_lim = timeLimit_;
+
+    if (glp_simplex(lp, &simplexParams) == 0 && glp_get_status(lp) == GLP_OPT) {
+        glp_intopt(lp, &mipParams);
+        int status = glp_mip_status(lp);
+        if (status == GLP_OPT || status == GLP_FEAS) {
+            std::fill(bandOwner.begin(), bandOwner.end(), NODEID_NONE);
+            for (unsigned int u = 0; u < numUes; u++) {
+                for (unsigned int c = 1; c <= numConfigs; c++) {
+                    if (glp_mip_col_val(lp, configColumn(u, c)) < 0.5)
+                        continue;
+                    for (unsigned int b = 0; b < numBands; b++) {
+                        if (c & (1u << b))
+                            bandOwner[b] = problem.ues[u];
+                    }
+                }
+            }
+        }
+    }
+    glp_delete_prob(lp);
+}
+
+} //namespace
+
+#endif // WITH_GLPK
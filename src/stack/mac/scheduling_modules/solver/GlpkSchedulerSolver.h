@@ -0,0 +1,61 @@
+//
+//                  Simu5G-NR-EDF (Extension of Simu5G)
+//
+// Original Authors: Giovanni Nardini, Giovanni Stea, Antonio Virdis (University of Pisa)
+// Extension Authors: Alaf Nascimento, Philippe Martins, Samuel Tardieu, Laurent Pautet (Institut Polytechnique de Paris)
+//
+// This file is part of a software released under the license included in file
+// "license.pdf". Please read LICENSE and README files before using it.
+// The above files and the present reference are part of the software itself,
+// and cannot be removed from it.
+//
+
+#ifndef _LTE_GLPKSCHEDULERSOLVER_H_
+#define _LTE_GLPKSCHEDULERSOLVER_H_
+
+#include "stack/mac/scheduling_modules/solver/GreedySchedulerSolver.h"
+
+#ifdef WITH_GLPK
+
+struct glp_tree;
+
+namespace simu5g {
+
+/**
+ * Exact solver of the MultiBandProblem, based on the GLPK MILP solver (feature "Simu5G_GLPK").
+ *
+ * The problem is modeled as in the original cplex formulation of LteMaxCiOptMB: one binary variable per
+ * UE and band configuration (non-empty subset of the bands), hence the number of bands is bounded.
+ * The heuristic solution of GreedySchedulerSolver, started from the warm start, is given to the
+ * branch-and-bound as the initial incumbent.
+ */
+class GlpkSchedulerSolver : public ISchedulerSolver
+{
+  protected:
+    /// maximum number of bands, the model has 2^bands - 1 configurations per UE
+    static constexpr unsigned int MAX_BANDS = 12;
+
+    /// time limit of the branch-and-bound, in ms (0 for none)
+    int timeLimit_;
+
+    GreedySchedulerSolver heuristic_;
+    std::vector<MacNodeId> incumbent_;
+
+    /// incumbent as column values, 1-based as GLPK arrays
+    std::vector<double> incumbentColumns_;
+    bool incumbentSent_ = false;
+
+    static void callback(glp_tree *tree, void *info);
+
+  public:
+    GlpkSchedulerSolver(int timeLimit = 0) : timeLimit_(timeLimit) {}
+
+    void solve(const MultiBandProblem& problem, const std::vector<MacNodeId>& warmStart,
+            std::vector<MacNodeId>& bandOwner) override;
+};
+
+} //namespace
+
+#endif // WITH_GLPK
+
+#endif
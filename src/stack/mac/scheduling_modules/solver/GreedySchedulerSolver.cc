@@ -0,0 +1,160 @@
+//
+//                  Simu5G-NR-EDF (Extension of Simu5G)
+//
+// Original Authors: Giovanni Nardini, Giovanni Stea, Antonio Virdis (University of Pisa)
+// Extension Authors: Alaf Nascimento, Philippe Martins, Samuel Tardieu, Laurent Pautet (Institut Polytechnique de Paris)
+//
+// This file is part of a software released under the license included in file
+// "license.pdf". Please read LICENSE and README files before using it.
+// The above files and the present reference are part of the software itself,
+// and cannot be removed from it.
+//
+
+#include <climits>
+
+#include "stack/mac/scheduling_modules/solver/GreedySchedulerSolver.h"
+
+namespace simu5g {
+
+unsigned int GreedySchedulerSolver::value(const MultiBandProblem& problem, int u) const
+{
+    return problem.served(u, count_[u], minRate_[u]);
+}
+
+unsigned int GreedySchedulerSolver::valueWith(const MultiBandProblem& problem, int u, unsigned int b) const
+{
+    unsigned int rate = problem.rate[u][b];
+    return problem.served(u, count_[u] + 1, count_[u] == 0 ? rate : std::min(minRate_[u], rate));
+}
+
+unsigned int GreedySchedulerSolver::valueWithout(const MultiBandProblem& problem, int u, unsigned int b) const
+{
+    if (count_[u] == 1)
+        return 0;
+
+    // the worst rate only changes if b was the worst band
+    unsigned int minRate = minRate_[u];
+    if (problem.rate[u][b] == minRate) {
+        minRate = UINT_MAX;
+        for (unsigned int i = 0; i < problem.numBands; i++) {
+            if (i != b && owner_[i] == u)
+                minRate = std::min(minRate, problem.rate[u][i]);
+        }
+    }
+    return problem.served(u, count_[u] - 1, minRate);
+}
+
+void GreedySchedulerSolver::assign(const MultiBandProblem& problem, unsigned int b, int u)
+{
+    unsigned int rate = problem.rate[u][b];
+    minRate_[u] = (count_[u] == 0) ? rate : std::min(minRate_[u], rate);
+    count_[u]++;
+    owner_[b] = u;
+}
+
+void GreedySchedulerSolver::release(const MultiBandProblem& problem, unsigned int b)
+{
+    int u = owner_[b];
+    owner_[b] = -1;
+    if (--count_[u] == 0) {
+        minRate_[u] = 0;
+        return;
+    }
+    if (problem.rate[u][b] == minRate_[u]) {
+        minRate_[u] = UINT_MAX;
+        for (unsigned int i = 0; i < problem.numBands; i++) {
+            if (owner_[i] == u)
+                minRate_[u] = std::min(minRate_[u], problem.rate[u][i]);
+        }
+    }
+}
+
+void GreedySchedulerSolver::solve(const MultiBandProblem& problem, const std::vector<MacNodeId>& warmStart,
+        std::vector<MacNodeId>& bandOwner)
+{
+    const unsigned int numBands = problem.numBands;
+    const int numUes = problem.ues.size();
+
+    owner_.assign(numBands, -1);
+    count_.assign(numUes, 0);
+    minRate_.assign(numUes, 0);
+
+    // start from the previous solution, for the UEs still in the problem
+    if (warmStart.size() == numBands) {
+        for (unsigned int b = 0; b < numBands; b++) {
+            if (warmStart[b] == NODEID_NONE)
+                continue;
+            auto it = std::find(problem.ues.begin(), problem.ues.end(), warmStart[b]);
+            if (it != problem.ues.end() && problem.rate[it - problem.ues.begin()][b] > 0)
+                assign(problem, b, it - problem.ues.begin());
+        }
+    }
+
+    // greedy assignment of the free bands
+    while (true) {
+        unsigned int bestGain = 0;
+        unsigned int bestBand = 0;
+        int bestUe = -1;
+        for (unsigned int b = 0; b < numBands; b++) {
+            if (owner_[b] != -1)
+                continue;
+            for (int u = 0; u < numUes; u++) {
+                unsigned int current = value(problem, u);
+                unsigned int with = valueWith(problem, u, b);
+                if (with > current && with - current > bestGain) {
+                    bestGain = with - current;
+                    bestBand = b;
+                    bestUe = u;
+                }
+            }
+        }
+        if (bestUe == -1)
+            break;
+        assign(problem, bestBand, bestUe);
+    }
+
+    // local search: move single bands while the objective increases
+    for (unsigned int pass = 0; pass < maxPasses_; pass++) {
+        bool improved = false;
+        for (unsigned int b = 0; b < numBands; b++) {
+            int from = owner_[b];
+            // change of the objective of the current owner when losing the band
+            long loss = (from == -1) ? 0 : (long)value(problem, from) - valueWithout(problem, from, b);
+
+            long bestDelta = (from == -1) ? 0 : -loss;   // freeing the band
+            int bestUe = -1;
+            for (int u = 0; u < numUes; u++) {
+                if (u == from)
+                    continue;
+                long delta = (long)valueWith(problem, u, b) - value(problem, u) - loss;
+                if (delta > bestDelta) {
+                    bestDelta = delta;
+                    bestUe = u;
+                }
+            }
+            if (bestDelta <= 0)
+                continue;
+
+            if (from != -1)
+                release(problem, b);
+            if (bestUe != -1)
+                assign(problem, b, bestUe);
+            improved = true;
+        }
+        if (!improved)
+            break;
+    }
+
+    // free the bands that do not contribute, e.g. those of UEs whose queue is already drained
+    for (unsigned int b = 0; b < numBands; b++) {
+        int u = owner_[b];
+        if (u != -1 && valueWithout(problem, u, b) >= value(problem, u))
+            release(problem, b);
+    }
+
+    bandOwner.resize(numBands);
+    for (unsigned int b = 0; b < numBands; b++)
+        bandOwner[b] = (owner_[b] == -1) ? NODEID_NONE : problem.ues[owner_[b]];
+}
+
+} //namespace
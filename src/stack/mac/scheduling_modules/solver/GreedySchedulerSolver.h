@@ -0,0 +1,64 @@
+//
+//                  Simu5G-NR-EDF (Extension of Simu5G)
+//
+// Original Authors: Giovanni Nardini, Giovanni Stea, Antonio Virdis (University of Pisa)
+// Extension Authors: Alaf Nascimento, Philippe Martins, Samuel Tardieu, Laurent Pautet (Institut Polytechnique de Paris)
+//
+// This file is part of a software released under the license included in file
+// "license.pdf". Please read LICENSE and README files before using it.
+// The above files and the present reference are part of the software itself,
+// and cannot be removed from it.
+//
+
+#ifndef _LTE_GREEDYSCHEDULERSOLVER_H_
+#define _LTE_GREEDYSCHEDULERSOLVER_H_
+
+#include "stack/mac/scheduling_modules/solver/ISchedulerSolver.h"
+
+namespace simu5g {
+
+/**
+ * Heuristic solver of the MultiBandProblem.
+ *
+ * Starting from the warm start, the free bands are assigned greedily, each time to the (band, UE) pair
+ * increasing the objective the most. Then, local search moves single bands to another UE, or frees them,
+ * as long as the objective increases. Last, bands that do not contribute to the objective are freed.
+ *
+ * Each step costs O(bands * UEs), there is no exponential enumeration of the band configurations.
+ */
+class GreedySchedulerSolver : public ISchedulerSolver
+{
+  protected:
+    /// maximum number of local search passes over the bands
+    unsigned int maxPasses_;
+
+    // working state, kept to avoid reallocations
+    /// owner (index in the problem) of each band, -1 if free
+    std::vector<int> owner_;
+    /// number of bands of each UE
+    std::vector<unsigned int> count_;
+    /// worst rate over the bands of each UE
+    std::vector<unsigned int> minRate_;
+
+    /// Objective of UE u, given its bands
+    unsigned int value(const MultiBandProblem& problem, int u) const;
+
+    /// Objective of UE u if band b is added to its bands
+    unsigned int valueWith(const MultiBandProblem& problem, int u, unsigned int b) const;
+
+    /// Objective of UE u if band b is removed from its bands
+    unsigned int valueWithout(const MultiBandProblem& problem, int u, unsigned int b) const;
+
+    void assign(const MultiBandProblem& problem, unsigned int b, int u);
+    void release(const MultiBandProblem& problem, unsigned int b);
+
+  public:
+    GreedySchedulerSolver(unsigned int maxPasses = 10) : maxPasses_(maxPasses) {}
+
+    void solve(const MultiBandProblem& problem, const std::vector<MacNodeId>& warmStart,
+            std::vector<MacNodeId>& bandOwner) override;
+};
+
+} //namespace
+
+#endif
@@ -0,0 +1,81 @@
+//
+//                  Simu5G-NR-EDF (Extension of Simu5G)
+//
+// Original Authors: Giovanni Nardini, Giovanni Stea, Antonio Virdis (University of Pisa)
+// Extension Authors: Alaf Nascimento, Philippe Martins, Samuel Tardieu, Laurent Pautet (Institut Polytechnique de Paris)
+//
+// This file is part of a software released under the license included in file
+// "license.pdf". Please read LICENSE and README files before using it.
+// The above files and the present reference are part of the software itself,
+// and cannot be removed from it.
+//
+
+#ifndef _LTE_ISCHEDULERSOLVER_H_
+#define _LTE_ISCHEDULERSOLVER_H_
+
+#include <algorithm>
+#include <vector>
+
+#include "common/LteCommon.h"
+
+namespace simu5g {
+
+/**
+ * Multi-band assignment problem solved by LteMaxCiOptMB at each scheduling period.
+ *
+ * Each band can be assigned to at most one UE. A UE assigned a set of bands transmits on all of them
+ * with the modulation of its worst band, hence it sends |bands| * min(rate on the bands) bytes, up to
+ * its queue. The objective is to maximize the total number of bytes sent.
+ */
+struct MultiBandProblem
+{
+    /// UEs competing for the bands
+    std::vector<MacNodeId> ues;
+    /// bytes queued by each UE
+    std::vector<unsigned int> queue;
+    /// rate[u][b]: bytes UE u can send on band b
+    std::vector<std::vector<unsigned int>> rate;
+    unsigned int numBands = 0;
+
+    void clear()
+    {
+        ues.clear();
+        queue.clear();
+        rate.clear();
+        numBands = 0;
+    }
+
+    /// Bytes sent by UE u on "count" bands whose worst rate is "minRate"
+    unsigned int served(unsigned int u, unsigned int count, unsigned int minRate) const
+    {
+        return std::min<unsigned long>(queue[u], (unsigned long)count * minRate);
+    }
+};
+
+/**
+ * Interface of the solvers of the MultiBandProblem.
+ *
+ * The problem is built in memory by the scheduler and the solver runs in-process, so that it can be
+ * invoked at each scheduling period.
+ */
+class ISchedulerSolver
+{
+  public:
+    virtual ~ISchedulerSolver() {}
+
+    /**
+     * Solves the problem.
+     *
+     * @param problem problem to solve
+     * @param warmStart owner of each band in a previous solution (typically the one of the previous
+     *        period), used as the starting point. Owners that are no longer in the problem are ignored,
+     *        and an empty vector means a cold start
+     * @param bandOwner set to the UE assigned to each band, NODEID_NONE if the band is left free
+     */
+    virtual void solve(const MultiBandProblem& problem, const std::vector<MacNodeId>& warmStart,
+            std::vector<MacNodeId>& bandOwner) = 0;
+};
+
+} //namespace
+
+#endif
@@ -155,6 +155,14 @@ class PacketFlowManagerBase : public cSimpleModule
      */
     virtual void discardRlcPdu(LogicalCid lcid, unsigned int rlcSno, bool fromMac = false) = 0;
 
+    /*
+     * This method is used to keep track of RLC SDUs discarded before being segmented
+     * into RLC PDUs (e.g. because their delay budget expired)
+     * @param lcid
+     * @param pdcpSno sequence number of the PDCP PDU carried by the RLC SDU
+     */
+    virtual void discardRlcSdu(LogicalCid lcid, unsigned int pdcpSno) {}
+
     virtual void insertHarqProcess(LogicalCid lcid, unsigned int harqProcId, unsigned int macPduId) = 0;
 
     virtual void grantSent(MacNodeId nodeId, unsigned int grantId) {}
@@ -387,6 +387,33 @@ void PacketFlowManagerEnb::discardRlcPdu(LogicalCid lcid, unsigned int rlcSno, b
     desc->rlcSdusPerPdu_.erase(rlcSno);
 }
 
+void PacketFlowManagerEnb::discardRlcSdu(LogicalCid lcid, unsigned int pdcpSno)
+{
+    auto cit = connectionMap_.find(lcid);
+    if (cit == connectionMap_.end()) {
+        // this may occur after a handover, when data structures are cleared
+        EV << pfmType << "::discardRlcSdu - Logical CID " << lcid << " not present." << endl;
+        return;
+    }
+
+    // get the descriptor for this connection
+    StatusDescriptor *desc = &cit->second;
+    auto pit = desc->pdcpStatus_.find(pdcpSno);
+    if (pit == desc->pdcpStatus_.end()) {
+        // the status of the SDU may already have been cleared, e.g. after a handover
+        EV << pfmType << "::discardRlcSdu - PdcpStatus for PDCP sno [" << pdcpSno << "] with lcid [" << lcid << "] not present." << endl;
+        return;
+    }
+
+    // no fragment of this PDCP SDU has been sent: it is discarded before starting its transmission
+    EV_FATAL << NOW << " node id " << desc->nodeId_ << " " << pfmType << "::discardRlcSdu - lcid[" << lcid << "], discarded PDCP PDU " << pdcpSno << endl;
+    pktDiscardCounterPerUe_[desc->nodeId_].discarded += 1;
+    pktDiscardCounterTotal_.discarded += 1;
+
+    desc->rlcPdusPerSdu_.erase(pdcpSno);
+    desc->pdcpStatus_.erase(pit);
+}
+
 void PacketFlowManagerEnb::insertMacPdu(inet::Ptr<const LteMacPdu> macPdu)
 {
     EV << pfmType << "::insertMacPdu" << endl;
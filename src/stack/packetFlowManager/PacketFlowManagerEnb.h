@@ -184,6 +184,14 @@ class PacketFlowManagerEnb : public PacketFlowManagerBase
      */
     void discardRlcPdu(LogicalCid lcid, unsigned int rlcSno, bool fromMac = false) override;
 
+    /*
+     * This method is used to keep track of RLC SDUs discarded before any of their
+     * fragments has been sent. The PDCP SDU is counted as discarded
+     * @param lcid
+     * @param pdcpSno sequence number of the PDCP PDU
+     */
+    void discardRlcSdu(LogicalCid lcid, unsigned int pdcpSno) override;
+
     void insertHarqProcess(LogicalCid lcid, unsigned int harqProcId, unsigned int macPduId) override;
 
     void grantSent(MacNodeId nodeId, unsigned int grantId) override;
@@ -15,6 +15,7 @@
 #include <inet/networklayer/ipv4/Ipv4Header_m.h>
 #include <inet/transportlayer/tcp_common/TcpHeader.h>
 #include <inet/transportlayer/udp/UdpHeader_m.h>
+#include "apps/cbr/CbrPacket_m.h"
 
 #include "stack/packetFlowManager/PacketFlowManagerBase.h"
 #include "stack/pdcp_rrc/packet/LteRohcPdu_m.h"
@@ -154,6 +155,27 @@ namespace simu5g
         lteInfo->setDirection(getDirection());
     }
 
+    // alaf
+    int LtePdcpRrcBase::search5QI(inet::Packet *pkt)
+    {
+        // the headers are peeked in place: the packet is neither copied nor modified
+        auto ipHeader = pkt->peekAtFront<Ipv4Header>();
+        b offset = ipHeader->getChunkLength();
+        int transportProtocol = ipHeader->getProtocolId();
+
+        if (IP_PROT_TCP == transportProtocol)
+            offset += pkt->peekAt<tcp::TcpHeader>(offset)->getChunkLength();
+        else if (IP_PROT_UDP == transportProtocol)
+            offset += pkt->peekAt<UdpHeader>(offset)->getChunkLength();
+
+        // e.g. pure TCP acknowledgements carry no payload
+        if (pkt->getDataLength() <= offset)
+            return -1;
+
+        auto cbrPacket = pkt->peekAt<CbrPacket>(offset, b(-1), Chunk::PF_ALLOW_NULLPTR);
+        return (cbrPacket != nullptr) ? cbrPacket->getFiveQI() : -1;
+    }
+
     /*
      * Upper Layer handlers
      */
@@ -163,6 +163,14 @@ namespace simu5g
     virtual Direction getDirection() = 0;
     void setTrafficInformation(cPacket *pkt, inet::Ptr<FlowControlInfo> lteInfo);
 
+    /** FiveQI search function
+     * Searches for the FiveQI in the packet, if it exists.
+     * If it does not exist, it returns -1.
+     * @param pkt Packet to search
+     * @return FiveQI value or -1 if not found
+     */
+    int search5QI(inet::Packet *pkt);
+
     bool isCompressionEnabled();
 
     /*
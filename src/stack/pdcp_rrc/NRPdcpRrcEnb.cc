@@ -12,11 +12,6 @@
 
 #include <inet/networklayer/common/NetworkInterface.h>
 
-#include <inet/networklayer/ipv4/Ipv4Header_m.h>
-#include <inet/transportlayer/tcp_common/TcpHeader.h>
-#include <inet/transportlayer/udp/UdpHeader_m.h>
-#include "apps/cbr/CbrPacket_m.h"
-
 #include "stack/pdcp_rrc/NRPdcpRrcEnb.h"
 #include "stack/packetFlowManager/PacketFlowManagerBase.h"
 
@@ -37,30 +32,6 @@ namespace simu5g
         LtePdcpRrcEnbD2D::initialize(stage);
     }
 
-    // alaf
-    int NRPdcpRrcEnb::search5QI(inet::Packet *pktAux)
-    {
-        int fiveQi = -1;                   // Default value if not found
-        inet::Packet *pkt = pktAux->dup(); // duplicate the packet to avoid modifying the original one
-
-        auto ipHeader = pkt->removeAtFront<Ipv4Header>();
-        int transportProtocol = ipHeader->getProtocolId();
-
-        if (IP_PROT_TCP == transportProtocol)
-            pkt->removeAtFront<tcp::TcpHeader>();
-        else if (IP_PROT_UDP == transportProtocol)
-            pkt->removeAtFront<UdpHeader>();
-
-        auto cbrPacket = pkt->peekAtFront<CbrPacket>();
-        if (cbrPacket != nullptr)
-        {
-            fiveQi = cbrPacket->getFiveQI();
-        }
-
-        delete pkt; // clean up the duplicated packet
-        return fiveQi;
-    }
-
     /*
      * Upper Layer handlers
      */
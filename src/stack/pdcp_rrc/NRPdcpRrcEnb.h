@@ -35,14 +35,6 @@ namespace simu5g
   {
 
   protected:
-    /** FiveQI search function
-     * Searches for the FiveQI in the packet, if it exists.
-     * If it does not exist, it returns -1.
-     * @param pkt Packet to search
-     * @return FiveQI value or -1 if not found
-     */
-    int search5QI(inet::Packet *pktAux);
-
     // Flag for enabling Dual Connectivity
     bool dualConnectivityEnabled_;
 
@@ -25,6 +25,7 @@ void NRPdcpRrcUe::initialize(int stage)
     if (stage == inet::INITSTAGE_LOCAL) {
         inet::NetworkInterface *nic = inet::getContainingNicModule(this);
         dualConnectivityEnabled_ = nic->par("dualConnectivityEnabled").boolValue();
+        uplinkFiveQI_ = par("uplinkFiveQI").boolValue();
 
         // initialize gates
         // nrTmSapInGate_ = gate("TM_Sap$i", 1);
@@ -68,6 +69,12 @@ void NRPdcpRrcUe::fromDataPort(cPacket *pktAux)
     // Control Information
     auto pkt = check_and_cast<Packet *>(pktAux);
     auto lteInfo = pkt->getTagForUpdate<FlowControlInfo>();
+
+    // the 5QI lets the gNB derive the deadlines of the uplink data, only needed with the EDF uplink discipline
+    if (uplinkFiveQI_) {
+        int fqi = search5QI(pkt);
+        lteInfo->setFiveQI(fqi > 0 ? fqi : 0);
+    }
     setTrafficInformation(pkt, lteInfo);
 
     // select the correct nodeId for the source
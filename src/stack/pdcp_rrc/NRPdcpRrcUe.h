@@ -37,6 +37,9 @@ class NRPdcpRrcUe : public LtePdcpRrcUeD2D
     // flag for enabling Dual Connectivity
     bool dualConnectivityEnabled_;
 
+    // if true, the 5QI of the uplink packets is filled for the NR-EDF uplink scheduler
+    bool uplinkFiveQI_ = false;
+
   protected:
 
     void initialize(int stage) override;
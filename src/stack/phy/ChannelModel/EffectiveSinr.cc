@@ -0,0 +1,115 @@
+//
+//                  Simu5G-NR-EDF (Extension of Simu5G)
+//
+// Original Authors: Giovanni Nardini, Giovanni Stea, Antonio Virdis (University of Pisa)
+// Extension Authors: Alaf Nascimento, Philippe Martins, Samuel Tardieu, Laurent Pautet (Institut Polytechnique de Paris)
+//
+// This file is part of a software released under the license included in file
+// "license.pdf". Please read LICENSE and README files before using it.
+// The above files and the present reference are part of the software itself,
+// and cannot be removed from it.
+//
+
+#include <algorithm>
+#include <cmath>
+
+#include "stack/phy/ChannelModel/EffectiveSinr.h"
+#include "stack/mac/amc/LteMcs.h"
+
+namespace simu5g {
+
+using namespace omnetpp;
+
+EffectiveSinr::EffectiveSinr(Mapping mapping, const std::vector<double>& beta) : mapping_(mapping)
+{
+    if (mapping_ == EESM) {
+        if (beta.size() != MAXCQI)
+            throw cRuntimeError("EffectiveSinr - %d EESM factors expected (one per CQI), %d given", MAXCQI, (int)beta.size());
+        for (double b : beta) {
+            if (b <= 0)
+                throw cRuntimeError("EffectiveSinr - EESM factors must be positive, %f given", b);
+        }
+        beta_.push_back(1);
+        beta_.insert(beta_.end(), beta.begin(), beta.end());
+        return;
+    }
+
+    const LteMod mods[] = { _QPSK, _16QAM, _64QAM };
+    unsigned int points = std::lround((miMaxSinr - miMinSinr) / miStep) + 1;
+    for (unsigned int m = 0; m < 3; m++) {
+        mi_[m].resize(points);
+        for (unsigned int i = 0; i < points; i++)
+            mi_[m][i] = mutualInformation(mods[m], miMinSinr + i * miStep);
+    }
+}
+
+double EffectiveSinr::jFunction(double sigma)
+{
+    // approximation of the mutual information of a BPSK symbol with LLR standard deviation sigma
+    const double H1 = 0.3073, H2 = 0.8935, H3 = 1.1064;
+    return std::pow(1 - std::pow(2.0, -H1 * std::pow(sigma, 2 * H2)), H3);
+}
+
+double EffectiveSinr::mutualInformation(LteMod mod, double sinr)
+{
+    double s = std::sqrt(std::pow(10.0, sinr / 10));
+    switch (mod) {
+        case _QPSK:
+            return jFunction(2 * s);
+        case _16QAM:
+            return jFunction(0.8818 * s) / 2 + jFunction(1.6764 * s) / 4 + jFunction(0.9316 * s) / 4;
+        default:
+            return (jFunction(1.1233 * s) + jFunction(0.4381 * s) + jFunction(0.4765 * s)) / 3;
+    }
+}
+
+unsigned int EffectiveSinr::modulationIndex(Cqi cqi)
+{
+    switch (cqiTable[std::min(cqi, MAXCQI)].mod_) {
+        case _QPSK:
+            return 0;
+        case _16QAM:
+            return 1;
+        default:
+            return 2;
+    }
+}
+
+double EffectiveSinr::compress(Cqi cqi, double sinr) const
+{
+    if (mapping_ == EESM)
+        return std::exp(-std::pow(10.0, sinr / 10) / beta_[cqi]);
+
+    const std::vector<double>& mi = mi_[modulationIndex(cqi)];
+    if (sinr <= miMinSinr)
+        return mi.front();
+    if (sinr >= miMaxSinr)
+        return mi.back();
+    double pos = (sinr - miMinSinr) / miStep;
+    unsigned int k = pos;
+    return mi[k] + (pos - k) * (mi[k + 1] - mi[k]);
+}
+
+double EffectiveSinr::expand(Cqi cqi, double average) const
+{
+    if (mapping_ == EESM) {
+        // all the terms underflow on very good channels
+        if (average <= 0)
+            return 100;
+        double sinr = 10 * std::log10(-beta_[cqi] * std::log(average));
+        return std::max(-100.0, std::min(100.0, sinr));
+    }
+
+    // the mutual information grows with the SINR: invert it by binary search in the samples, taking
+    // the lowest SINR once it saturates
+    const std::vector<double>& mi = mi_[modulationIndex(cqi)];
+    unsigned int k = std::lower_bound(mi.begin(), mi.end(), average) - mi.begin();
+    if (k == 0)
+        return miMinSinr;
+    if (k == mi.size())
+        return miMaxSinr;
+    double fraction = (average - mi[k - 1]) / (mi[k] - mi[k - 1]);
+    return miMinSinr + (k - 1 + fraction) * miStep;
+}
+
+} //namespace
@@ -0,0 +1,82 @@
+//
+//                  Simu5G-NR-EDF (Extension of Simu5G)
+//
+// Original Authors: Giovanni Nardini, Giovanni Stea, Antonio Virdis (University of Pisa)
+// Extension Authors: Alaf Nascimento, Philippe Martins, Samuel Tardieu, Laurent Pautet (Institut Polytechnique de Paris)
+//
+// This file is part of a software released under the license included in file
+// "license.pdf". Please read LICENSE and README files before using it.
+// The above files and the present reference are part of the software itself,
+// and cannot be removed from it.
+//
+
+#ifndef _LTE_EFFECTIVESINR_H_
+#define _LTE_EFFECTIVESINR_H_
+
+#include <vector>
+
+#include "common/LteCommon.h"
+
+namespace simu5g {
+
+/**
+ * Effective SINR mapping: compresses the SINRs of the blocks of a transport block into the SINR of an
+ * equivalent flat channel, so that the transport block needs a single BLER lookup.
+ *
+ *  - EESM: SINReff = -beta * ln(mean(exp(-SINR / beta))), with a calibration factor beta per CQI;
+ *  - MIESM: SINReff = I^-1(mean(I(SINR))), with I the mutual information per bit of the modulation
+ *    of the CQI, approximated by the J function (Brueninghaus et al., PIMRC 2005).
+ *
+ * A transport block is evaluated by averaging compress() over its blocks, then calling expand():
+ *
+ *   double sum = 0;
+ *   for each block: sum += compress(cqi, sinr);
+ *   double sinrEff = expand(cqi, sum / blocks);
+ */
+class EffectiveSinr
+{
+  public:
+    enum Mapping
+    {
+        EESM,
+        MIESM
+    };
+
+  protected:
+    Mapping mapping_;
+    // EESM factor of each CQI (index 0 unused)
+    std::vector<double> beta_;
+
+    // mutual information per bit of QPSK, 16QAM and 64QAM, sampled every miStep dB from miMinSinr
+    static constexpr double miMinSinr = -20;
+    static constexpr double miMaxSinr = 40;
+    static constexpr double miStep = 0.1;
+    std::vector<double> mi_[3];
+
+    static double jFunction(double sigma);
+    static double mutualInformation(LteMod mod, double sinr);
+
+    // index in mi_ of the modulation of the CQI
+    static unsigned int modulationIndex(Cqi cqi);
+
+  public:
+    /*
+     * @param beta EESM factor of CQI 1..15, unused by MIESM
+     */
+    EffectiveSinr(Mapping mapping, const std::vector<double>& beta);
+
+    /*
+     * Per-block term of the mapping for a block with the given SINR (dB), to be averaged over the blocks
+     */
+    double compress(Cqi cqi, double sinr) const;
+
+    /*
+     * Effective SINR (dB) of the blocks whose terms average to the given value.
+     * It is bounded to the [miMinSinr, miMaxSinr] range for MIESM, and to +/-100 dB for EESM
+     */
+    double expand(Cqi cqi, double average) const;
+};
+
+} //namespace
+
+#endif
@@ -58,6 +58,12 @@ void LteRealisticChannelModel::initialize(int stage)
         correlationDistance_ = par("correlation_distance");
         harqReduction_ = par("harqReduction");
 
+        std::string errorModel = par("errorModel").stdstringValue();
+        if (errorModel == "EESM" || errorModel == "MIESM") {
+            std::vector<double> beta = check_and_cast<cValueArray *>(par("eesmBeta").objectValue())->asDoubleVector();
+            effectiveSinr_.reset(new EffectiveSinr(errorModel == "EESM" ? EffectiveSinr::EESM : EffectiveSinr::MIESM, beta));
+        }
+
         lambdaMinTh_ = par("lambdaMinTh");
         lambdaMaxTh_ = par("lambdaMaxTh");
         lambdaRatioTh_ = par("lambdaRatioTh");
@@ -1817,6 +1823,10 @@ bool LteRealisticChannelModel::isError(LteAirFrame *frame, UserControlInfo *lteI
     double sumSnr = 0.0;
     int usedRBs = 0;
 
+    // effective SINR: sum of the terms of the blocks, and number of blocks
+    double effectiveSum = 0;
+    unsigned int effectiveBlocks = 0;
+
     // for each Remote unit used to transmit the packet
     for (const auto &[remoteUnit, rbList] : rbmap) {
         // for each logical band used to transmit the packet
@@ -1841,6 +1851,12 @@ bool LteRealisticChannelModel::isError(LteAirFrame *frame, UserControlInfo *lteI
             sumSnr += snrV[band];
             usedRBs++;
 
+            if (effectiveSinr_) {
+                effectiveSum += allocation * effectiveSinr_->compress(cqi, snrV[band]);
+                effectiveBlocks += allocation;
+                continue;
+            }
+
             int snr = snrV[band];// XXX because band is a Band (=unsigned short)
             if (snr < binder_->phyPisaData.minSnr())
                 return false;
@@ -1865,6 +1881,23 @@ bool LteRealisticChannelModel::isError(LteAirFrame *frame, UserControlInfo *lteI
                << " total success probability " << finalSuccess << endl;
         }
     }
+
+    // the codeword is a single block at the effective SINR
+    if (effectiveBlocks > 0) {
+        int snr = effectiveSinr_->expand(cqi, effectiveSum / effectiveBlocks);
+        if (snr < binder_->phyPisaData.minSnr())
+            return false;
+        else if (snr > binder_->phyPisaData.maxSnr())
+            bler = 0;
+        else
+            bler = binder_->phyPisaData.getBler(itxmode, cqi - 1, snr);
+        finalSuccess = 1 - bler;
+
+        EV << " LteRealisticChannelModel::error direction " << dirToA(dir)
+           << " node " << id << " effective SNR " << snr << " over " << effectiveBlocks << " blocks CQI " << cqi
+           << " BLER " << bler << endl;
+    }
+
     // Compute total error probability
     double per = 1 - finalSuccess;
     // Harq Reduction
@@ -1982,6 +2015,10 @@ bool LteRealisticChannelModel::isError_D2D(LteAirFrame *frame, UserControlInfo *
     double sumSnr = 0.0;
     int usedRBs = 0;
 
+    // effective SINR: sum of the terms of the blocks, and number of blocks
+    double effectiveSum = 0;
+    unsigned int effectiveBlocks = 0;
+
     // for each Remote unit used to transmit the packet
     for (const auto& [remoteUnitId, resourceBlocks] : rbmap) {
         // for each logical band used to transmit the packet
@@ -2004,6 +2041,12 @@ bool LteRealisticChannelModel::isError_D2D(LteAirFrame *frame, UserControlInfo *
             sumSnr += snrV[band];
             usedRBs++;
 
+            if (effectiveSinr_) {
+                effectiveSum += allocation * effectiveSinr_->compress(cqi, snrV[band]);
+                effectiveBlocks += allocation;
+                continue;
+            }
+
             int snr = snrV[band];// XXX because band is a Band (=unsigned short)
             if (snr < 1)                           // XXX it was < 0
                 return false;
@@ -2029,6 +2072,23 @@ bool LteRealisticChannelModel::isError_D2D(LteAirFrame *frame, UserControlInfo *
                << " total success probability " << finalSuccess << endl;
         }
     }
+
+    // the codeword is a single block at the effective SINR
+    if (effectiveBlocks > 0) {
+        int snr = effectiveSinr_->expand(cqi, effectiveSum / effectiveBlocks);
+        if (snr < 1)
+            return false;
+        else if (snr > binder_->phyPisaData.maxSnr())
+            bler = 0;
+        else
+            bler = binder_->phyPisaData.getBler(itxmode, cqi - 1, snr);
+        finalSuccess = 1 - bler;
+
+        EV << " LteRealisticChannelModel::error direction " << dirToA(dir)
+           << " node " << id << " effective SNR " << snr << " over " << effectiveBlocks << " blocks CQI " << cqi
+           << " BLER " << bler << endl;
+    }
+
     // Compute total error probability
     double per = 1 - finalSuccess;
     // Harq Reduction
@@ -12,8 +12,11 @@
 #ifndef STACK_PHY_CHANNELMODEL_LTEREALISTICCHANNELMODEL_H_
 #define STACK_PHY_CHANNELMODEL_LTEREALISTICCHANNELMODEL_H_
 
+#include <memory>
+
 #include <omnetpp.h>
 #include "stack/phy/ChannelModel/LteChannelModel.h"
+#include "stack/phy/ChannelModel/EffectiveSinr.h"
 
 namespace simu5g {
 
@@ -87,6 +90,9 @@ class LteRealisticChannelModel : public LteChannelModel
     // Percentage of error probability reduction for each h-arq retransmission
     double harqReduction_;
 
+    // If set, the error of a codeword is decided on the effective SINR of its blocks, otherwise each band is an independent block
+    std::unique_ptr<EffectiveSinr> effectiveSinr_;
+
     // Eigen values of channel matrix, used to compute the rank
     double lambdaMinTh_;
     double lambdaMaxTh_;
@@ -135,7 +135,7 @@ class LteFeedback
     }
 
     //! Get the wide-band CQI. Does not check if valid.
-    CqiVector getWbCqi() const
+    const CqiVector& getWbCqi() const
     {
         return wideBandCqi_;
     }
@@ -153,7 +153,7 @@ class LteFeedback
     }
 
     //! Get the per-band CQI. Does not check if valid.
-    std::vector<CqiVector> getBandCqi() const
+    const std::vector<CqiVector>& getBandCqi() const
     {
         return perBandCqi_;
     }
@@ -165,13 +165,13 @@ class LteFeedback
     }
 
     //! Get the per-band PMI. Does not check if valid.
-    PmiVector getBandPmi() const
+    const PmiVector& getBandPmi() const
     {
         return perBandPmi_;
     }
 
     //! Get the per preferred band CQI. Does not check if valid.
-    CqiVector getPreferredCqi() const
+    const CqiVector& getPreferredCqi() const
     {
         return preferredCqi_;
     }
@@ -189,7 +189,7 @@ class LteFeedback
     }
 
     //! Get the set of preferred bands. Does not check if valid.
-    BandSet getPreferredBands() const
+    const BandSet& getPreferredBands() const
     {
         return preferredBands_;
     }
@@ -217,7 +217,7 @@ class LteFeedback
     }
 
     //! Set the wide-band CQI.
-    void setWideBandCqi(const CqiVector wbCqi)
+    void setWideBandCqi(const CqiVector& wbCqi)
     {
         wideBandCqi_ = wbCqi;
         status_ |= WB_CQI;
@@ -249,7 +249,7 @@ class LteFeedback
     }
 
     //! Set the per-band CQI for one codeword. Does not check if valid.
-    void setPerBandCqi(const CqiVector bandCqi, const Codeword cw)
+    void setPerBandCqi(const CqiVector& bandCqi, const Codeword cw)
     {
         if (perBandCqi_.size() == cw)
             perBandCqi_.push_back(bandCqi);
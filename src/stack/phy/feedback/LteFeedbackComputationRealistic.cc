@@ -10,6 +10,7 @@
 //
 
 //#include <math.h>
+#include <algorithm>
 #include <cmath>
 #include "stack/phy/feedback/LteFeedbackComputationRealistic.h"
 #include "common/blerCurves/PhyPisaData.h"
@@ -22,16 +23,13 @@ using namespace omnetpp;
 LteFeedbackComputationRealistic::LteFeedbackComputationRealistic(Binder *binder, double targetBler, std::map<MacNodeId, Lambda> *lambda,
         double lambdaMinTh, double lambdaMaxTh, double lambdaRatioTh, unsigned int numBands) : lambda_(lambda), targetBler_(targetBler), numBands_(numBands), lambdaMinTh_(lambdaMinTh), lambdaMaxTh_(lambdaMaxTh), lambdaRatioTh_(lambdaRatioTh), phyPisaData_(&(binder->phyPisaData))
 {
-    baseMin_.resize(phyPisaData_->nMcs(), 2);
 }
 
 
 void LteFeedbackComputationRealistic::generateBaseFeedback(int numBands, int numPreferredBands, LteFeedback& fb,
-        FeedbackType fbType, int cw, RbAllocationType rbAllocationType, TxMode txmode, std::vector<double> snr)
+        FeedbackType fbType, int cw, RbAllocationType rbAllocationType, TxMode txmode, const std::vector<double>& snr)
 {
     int layer = 1;
-    std::vector<CqiVector> cqiTmp2;
-    CqiVector cqiTmp;
     if (txmode == OL_SPATIAL_MULTIPLEXING) {
         // If rank is 1, SMUX is not a valid choice as Tx Mode
         if (fb.getRankIndicator() < 2)
@@ -40,40 +38,23 @@ void LteFeedbackComputationRealistic::generateBaseFeedback(int numBands, int num
     }
     layer = cw < layer ? cw : layer;
 
-    Cqi cqi;
     double mean = 0;
     if (fbType == WIDEBAND || rbAllocationType == TYPE2_DISTRIBUTED)
         mean = meanSnr(snr);
     if (fbType == WIDEBAND) {
-        cqiTmp.resize(layer, 0);
-        cqi = getCqi(txmode, mean);
-        for (unsigned short & i : cqiTmp)
-            i = cqi;
-        fb.setWideBandCqi(cqiTmp);
+        fb.setWideBandCqi(CqiVector(layer, getCqi(txmode, mean)));
     }
     else if (fbType == ALLBANDS) {
-        if (rbAllocationType == TYPE2_LOCALIZED) {
-            cqiTmp2.resize(layer);
-            for (unsigned int i = 0; i < cqiTmp2.size(); i++) {
-                cqiTmp2[i].resize(numBands, 0);
-                for (int j = 0; j < numBands; j++) {
-                    cqi = getCqi(txmode, snr[j]);
-                    cqiTmp2[i][j] = cqi;
-                }
-                fb.setPerBandCqi(cqiTmp2[i], i);
-            }
-        }
-        else if (rbAllocationType == TYPE2_DISTRIBUTED) {
-            cqi = getCqi(txmode, mean);
-            cqiTmp2.resize(layer);
-            for (unsigned int i = 0; i < cqiTmp2.size(); i++) {
-                cqiTmp2[i].resize(numBands, 0);
-                for (int j = 0; j < numBands; j++) {
-                    cqiTmp2[i][j] = cqi;
-                }
-                fb.setPerBandCqi(cqiTmp2[i], i);
-            }
-        }
+        // all the layers report the same CQI on a band
+        bandCqi_.resize(numBands);
+        if (rbAllocationType == TYPE2_LOCALIZED)
+            getCqi(txmode, snr.data(), numBands, bandCqi_.data());
+        else if (rbAllocationType == TYPE2_DISTRIBUTED)
+            std::fill(bandCqi_.begin(), bandCqi_.end(), getCqi(txmode, mean));
+        else
+            return;
+        for (int i = 0; i < layer; i++)
+            fb.setPerBandCqi(bandCqi_, i);
     }
     else if (fbType == PREFERRED) {
         //TODO
@@ -88,29 +69,47 @@ unsigned int LteFeedbackComputationRealistic::computeRank(MacNodeId id)
         return 2;
 }
 
-Cqi LteFeedbackComputationRealistic::getCqi(TxMode txmode, double snr)
+void LteFeedbackComputationRealistic::buildCqiTable()
 {
-    int newsnr = floor(snr + 0.5);
-    if (newsnr < phyPisaData_->minSnr())
-        return 0;
-    if (newsnr > phyPisaData_->maxSnr())
-        return 15;
-    unsigned int txm = txModeToIndex[txmode];
-    std::vector<double> min;
-    int found = 0;
-    double low = 2;
-
-    min = baseMin_;
-    for (int i = 0; i < phyPisaData_->nMcs(); i++) {
-        double tmp = phyPisaData_->getBler(txm, i, newsnr);
-        double diff = targetBler_ - tmp;
-        min[i] = (diff > 0) ? diff : (diff * -1);
-        if (low >= min[i]) {
-            found = i;
-            low = min[i];
+    cqiTableMinSnr_ = phyPisaData_->minSnr();
+    cqiTable_.resize(phyPisaData_->nTxMode());
+    for (int txm = 0; txm < phyPisaData_->nTxMode(); txm++) {
+        cqiTable_[txm].resize(phyPisaData_->maxSnr() - cqiTableMinSnr_ + 1);
+        for (unsigned int s = 0; s < cqiTable_[txm].size(); s++) {
+            // CQI whose BLER is the closest to the target, the highest one on ties
+            int found = 0;
+            double low = 2;
+            for (int i = 0; i < phyPisaData_->nMcs(); i++) {
+                double diff = std::fabs(targetBler_ - phyPisaData_->getBler(txm, i, cqiTableMinSnr_ + (int)s));
+                if (low >= diff) {
+                    found = i;
+                    low = diff;
+                }
+            }
+            cqiTable_[txm][s] = found + 1;
         }
     }
-    return found + 1;
+}
+
+Cqi LteFeedbackComputationRealistic::getCqi(TxMode txmode, double snr)
+{
+    Cqi cqi;
+    getCqi(txmode, &snr, 1, &cqi);
+    return cqi;
+}
+
+void LteFeedbackComputationRealistic::getCqi(TxMode txmode, const double *snr, unsigned int numBands, Cqi *cqi)
+{
+    // built on first use, as the BLER shift of the curves is set by the binder during initialization
+    if (cqiTable_.empty())
+        buildCqiTable();
+
+    const std::vector<Cqi>& table = cqiTable_[txModeToIndex[txmode]];
+    const int size = table.size();
+    for (unsigned int b = 0; b < numBands; b++) {
+        int index = (int)floor(snr[b] + 0.5) - cqiTableMinSnr_;
+        cqi[b] = index < 0 ? 0 : (index >= size ? MAXCQI : table[index]);
+    }
 }
 
 LteFeedbackDoubleVector LteFeedbackComputationRealistic::computeFeedback(FeedbackType fbType,
@@ -230,7 +229,7 @@ LteFeedback LteFeedbackComputationRealistic::computeFeedback(const Remote remote
     return fb;
 }
 
-double LteFeedbackComputationRealistic::meanSnr(std::vector<double> snr)
+double LteFeedbackComputationRealistic::meanSnr(const std::vector<double>& snr)
 {
     double mean = 0;
     for (const auto& value : snr)
@@ -32,17 +32,30 @@ class LteFeedbackComputationRealistic : public LteFeedbackComputation
     // Pointer to Pisa data
     PhyPisaData *phyPisaData_ = nullptr;
 
-    std::vector<double> baseMin_;
+    /*
+     * CQI reported at each integer SNR from phyPisaData_->minSnr() to phyPisaData_->maxSnr(), one table
+     * per tx mode index. The SNR is rounded to the dB before choosing the CQI, so the table gives the same
+     * CQI as searching the BLER curves for the one closest to the target BLER
+     */
+    std::vector<std::vector<Cqi>> cqiTable_;
+    int cqiTableMinSnr_ = 0;
+
+    // per-band CQI of the feedback being generated, reused across calls
+    CqiVector bandCqi_;
 
   protected:
     // Rank computation
     unsigned int computeRank(MacNodeId id);
     // Generate base feedback for all types of feedback (all bands, preferred, wideband)
     void generateBaseFeedback(int numBands, int numPreferredBands, LteFeedback& fb, FeedbackType fbType, int cw,
-            RbAllocationType rbAllocationType, TxMode txmode, std::vector<double> snr);
+            RbAllocationType rbAllocationType, TxMode txmode, const std::vector<double>& snr);
+    // Build the CQI tables from the BLER curves
+    void buildCqiTable();
     // Get CQI from BLER Curves
     Cqi getCqi(TxMode txmode, double snr);
-    double meanSnr(std::vector<double> snr);
+    // Get the CQI of the first numBands SNRs, written to cqi
+    void getCqi(TxMode txmode, const double *snr, unsigned int numBands, Cqi *cqi);
+    double meanSnr(const std::vector<double>& snr);
 
   public:
     LteFeedbackComputationRealistic(Binder *binder, double targetBler, std::map<MacNodeId, Lambda> *lambda, double lambdaMinTh,
@@ -9,13 +9,70 @@
 // and cannot be removed from it.
 //
 
+#include <cmath>
+
 #include "stack/phy/feedback/LteSummaryBuffer.h"
 
 namespace simu5g {
 
 using namespace omnetpp;
 
-void LteSummaryBuffer::createSummary(LteFeedback fb) {
+FeedbackSummaryMode getFeedbackSummaryMode(const std::string& s)
+{
+    if (s == "LAST")
+        return SUMMARY_LAST;
+    if (s == "MEAN")
+        return SUMMARY_MEAN;
+    if (s == "EWMA")
+        return SUMMARY_EWMA;
+    throw cRuntimeError("Unknown feedback summary mode \"%s\"", s.c_str());
+}
+
+LteSummaryBuffer::LteSummaryBuffer(unsigned char dim, unsigned char cw, unsigned int b, simtime_t lb, simtime_t ub,
+        FeedbackSummaryMode mode, double ewmaWeight) :
+    bufferSize_(dim), mode_(mode), ewmaWeight_(ewmaWeight), totCodewords_(cw), totBands_(b), cumulativeSummary_(cw, b, lb, ub)
+{
+    // the mean over an empty buffer is the last report
+    if (mode_ == SUMMARY_MEAN && bufferSize_ == 0)
+        mode_ = SUMMARY_LAST;
+
+    if (mode_ == SUMMARY_MEAN) {
+        samples_.resize(cw * b * bufferSize_);
+        numSamples_.resize(cw * b, 0);
+        nextSample_.resize(cw * b, 0);
+        sampleSum_.resize(cw * b, 0);
+    }
+    else if (mode_ == SUMMARY_EWMA)
+        ewma_.resize(cw * b, -1);
+}
+
+void LteSummaryBuffer::putCqi(Cqi cqi, Codeword cw, Band band)
+{
+    unsigned int i = cw * (unsigned int)totBands_ + band;
+    switch (mode_) {
+        case SUMMARY_MEAN: {
+            Cqi& slot = samples_[i * bufferSize_ + nextSample_[i]];
+            if (numSamples_[i] == bufferSize_)
+                sampleSum_[i] -= slot;
+            else
+                numSamples_[i]++;
+            slot = cqi;
+            sampleSum_[i] += cqi;
+            nextSample_[i] = (nextSample_[i] + 1) % bufferSize_;
+            cqi = Cqi(std::lround(double(sampleSum_[i]) / numSamples_[i]));
+            break;
+        }
+        case SUMMARY_EWMA:
+            ewma_[i] = (ewma_[i] < 0) ? cqi : ewmaWeight_ * cqi + (1 - ewmaWeight_) * ewma_[i];
+            cqi = Cqi(std::lround(ewma_[i]));
+            break;
+        default:
+            break;
+    }
+    cumulativeSummary_.setCqi(cqi, cw, band);
+}
+
+void LteSummaryBuffer::createSummary(const LteFeedback& fb) {
     try {
         // RI
         if (fb.hasRankIndicator()) {
@@ -27,24 +84,24 @@ void LteSummaryBuffer::createSummary(LteFeedback fb) {
 
         // CQI
         if (fb.hasBandCqi()) { // Per-band
-            std::vector<CqiVector> cqi = fb.getBandCqi();
+            const std::vector<CqiVector>& cqi = fb.getBandCqi();
             for (Codeword cw = 0; cw < cqi.size(); ++cw)
                 for (Band i = 0; i < totBands_; ++i)
-                    cumulativeSummary_.setCqi(cqi.at(cw).at(i), cw, i);
+                    putCqi(cqi.at(cw).at(i), cw, i);
         }
         else {
             if (fb.hasWbCqi()) { // Wide-band
-                CqiVector cqi(fb.getWbCqi());
+                const CqiVector& cqi = fb.getWbCqi();
                 for (Codeword cw = 0; cw < cqi.size(); ++cw)
                     for (Band i = 0; i < totBands_; ++i)
-                        cumulativeSummary_.setCqi(cqi.at(cw), cw, i); // repeats the same wb cqi on each band of the same cw
+                        putCqi(cqi.at(cw), cw, i); // repeats the same wb cqi on each band of the same cw
             }
             if (fb.hasPreferredCqi()) { // Preferred-band
-                CqiVector cqi(fb.getPreferredCqi());
-                BandSet bands(fb.getPreferredBands());
+                const CqiVector& cqi = fb.getPreferredCqi();
+                const BandSet& bands = fb.getPreferredBands();
                 for (Codeword cw = 0; cw < cqi.size(); ++cw)
                     for (const auto& band : bands)
-                        cumulativeSummary_.setCqi(cqi.at(cw), cw, band); // puts the same cqi only on the preferred bands of the same cw
+                        putCqi(cqi.at(cw), cw, band); // puts the same cqi only on the preferred bands of the same cw
             }
         }
 
@@ -52,7 +109,7 @@ void LteSummaryBuffer::createSummary(LteFeedback fb) {
 
         // PMI
         if (fb.hasBandPmi()) { // Per-band
-            PmiVector pmi(fb.getBandPmi());
+            const PmiVector& pmi = fb.getBandPmi();
             for (Band i = 0; i < totBands_; ++i)
                 cumulativeSummary_.setPmi(pmi.at(i), i);
         }
@@ -66,7 +123,7 @@ void LteSummaryBuffer::createSummary(LteFeedback fb) {
             if (fb.hasPreferredPmi()) {
                 // Preferred-band
                 Pmi pmi(fb.getPreferredPmi());
-                BandSet bands(fb.getPreferredBands());
+                const BandSet& bands = fb.getPreferredBands();
                 for (const auto& band : bands)
                     cumulativeSummary_.setPmi(pmi, band);
             }
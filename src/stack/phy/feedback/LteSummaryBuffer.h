@@ -12,44 +12,61 @@
 #ifndef STACK_PHY_FEEDBACK_LTESUMMARYBUFFER_H_
 #define STACK_PHY_FEEDBACK_LTESUMMARYBUFFER_H_
 
-#include <list>
-#include "stack/phy/feedback/LteSummaryBuffer.h"
+#include <vector>
 #include "stack/phy/feedback/LteFeedback.h"
 
 namespace simu5g {
 
 using namespace omnetpp;
 
+//! How the CQI reported for a codeword and band is summarized
+enum FeedbackSummaryMode
+{
+    SUMMARY_LAST,   //!< the last report
+    SUMMARY_MEAN,   //!< the mean of the last reports held by the buffer
+    SUMMARY_EWMA    //!< exponentially weighted moving average of all the reports
+};
+
+FeedbackSummaryMode getFeedbackSummaryMode(const std::string& s);
+
 class LteSummaryBuffer
 {
   protected:
     //! Buffer size
     unsigned char bufferSize_;
-    //! The buffer
-    std::list<LteFeedback> buffer_;
+    //! Summary of the CQI.
+    FeedbackSummaryMode mode_;
+    //! Weight of the last report in the EWMA.
+    double ewmaWeight_;
     //! Number of codewords.
     double totCodewords_;
     //! Number of bands.
     double totBands_;
+
+    /*
+     * CQI of each codeword and band, updated on each report. In SUMMARY_MEAN mode the last bufferSize_
+     * reports are kept in a ring at samples_[(cw * totBands_ + band) * bufferSize_], with their sum
+     */
+    std::vector<Cqi> samples_;
+    std::vector<unsigned char> numSamples_;
+    std::vector<unsigned char> nextSample_;
+    std::vector<unsigned int> sampleSum_;
+    std::vector<double> ewma_;
+
     //! Cumulative summary feedback.
     LteSummaryFeedback cumulativeSummary_;
-    void createSummary(LteFeedback fb);
+
+    void putCqi(Cqi cqi, Codeword cw, Band band);
+    void createSummary(const LteFeedback& fb);
 
   public:
 
-    LteSummaryBuffer(unsigned char dim, unsigned char cw, unsigned int b, simtime_t lb, simtime_t ub) :
-        bufferSize_(dim), totCodewords_(cw), totBands_(b), cumulativeSummary_(cw, b, lb, ub)
-    {}
+    LteSummaryBuffer(unsigned char dim, unsigned char cw, unsigned int b, simtime_t lb, simtime_t ub,
+            FeedbackSummaryMode mode = SUMMARY_LAST, double ewmaWeight = 0.5);
 
     //! Put a feedback into the buffer and update current summary feedback
-    void put(LteFeedback fb)
+    void put(const LteFeedback& fb)
     {
-        if (bufferSize_ > 0) {
-            buffer_.push_back(fb);
-        }
-        if (buffer_.size() > bufferSize_) {
-            buffer_.pop_front();
-        }
         createSummary(fb);
     }
 
@@ -154,6 +154,20 @@ namespace simu5g
         delete pktAux;
     }
 
+    bool LteRlcUm::discardHolSdu(MacCid cid)
+    {
+        Enter_Method_Silent("discardHolSdu()"); // Direct Method Call
+
+        if (mapAllLcidsToSingleBearer_)
+            cid = idToMacCid(MacCidToNodeId(cid), 1);
+
+        auto it = txEntities_.find(cid);
+        if (it == txEntities_.end())
+            return false;
+
+        return it->second->discardHolSdu();
+    }
+
     void LteRlcUm::handleUpperMessage(cPacket *pktAux)
     {
 
@@ -97,6 +97,17 @@ class LteRlcUm : public cSimpleModule
      */
     virtual void dropBufferOverflow(cPacket *pkt);
 
+    /**
+     * discardHolSdu() is invoked by the MAC as a direct method
+     * call to discard the head-of-line SDU of a connection (e.g. when
+     * its delay budget has expired). The SDU is kept if a fragment
+     * of it has already been sent.
+     *
+     * @param cid connection whose first SDU is dropped
+     * @return TRUE if the SDU was discarded
+     */
+    virtual bool discardHolSdu(MacCid cid);
+
     virtual void resumeDownstreamInPackets(MacNodeId peerId) {}
 
     virtual bool isEmptyingTxBuffer(MacNodeId peerId) { return false; }
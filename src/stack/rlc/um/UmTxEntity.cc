@@ -278,6 +278,26 @@ void UmTxEntity::removeDataFromQueue()
     delete retPkt;
 }
 
+bool UmTxEntity::discardHolSdu()
+{
+    // a fragment of the first SDU has already been sent
+    if (sduQueue_.isEmpty() || fragmentInfo != nullptr)
+        return false;
+
+    auto pkt = check_and_cast<inet::Packet *>(sduQueue_.pop());
+    auto rlcSdu = pkt->peekAtFront<LteRlcSdu>();
+    queueLength_ -= pkt->getByteLength();
+    ASSERT(queueLength_ >= 0);
+
+    EV << NOW << " UmTxEntity::discardHolSdu - discarded SDU " << rlcSdu->getSnoMainPacket() << endl;
+
+    if (packetFlowManager_)
+        packetFlowManager_->discardRlcSdu(flowControlInfo_->getLcid(), rlcSdu->getSnoMainPacket());
+
+    delete pkt;
+    return true;
+}
+
 void UmTxEntity::clearQueue()
 {
     // empty buffer
@@ -92,6 +92,9 @@ class UmTxEntity : public cSimpleModule
     // remove the last SDU from the queue
     void removeDataFromQueue();
 
+    // discard the first SDU of the queue, unless its transmission has already started
+    bool discardHolSdu();
+
     // clear the TX buffer
     void clearQueue();
 
@@ -0,0 +1,372 @@
+//
+//                  Simu5G-NR-EDF (Extension of Simu5G)
+//
+// Original Authors: Giovanni Nardini, Giovanni Stea, Antonio Virdis (University of Pisa)
+// Extension Authors: Alaf Nascimento, Philippe Martins, Samuel Tardieu, Laurent Pautet (Institut Polytechnique de Paris)
+//
+// This file is part of a software released under the license included in file
+// "license.pdf". Please read LICENSE and README files before using it.
+// The above files and the present reference are part of the software itself,
+// and cannot be removed from it.
+//
+
+//
+// Replay of the scheduler traces written by LteSchedulerEnb (schedulerTraceFile parameter of the MAC).
+//
+// Every record of the trace (one carrier, one scheduling period) is handed to a scheduling policy,
+// outside the simulator:
+//  - the connections that can be served (non-zero CQI, free bands among their allowed ones) are scored
+//    by the policy, with the same ConnectionView as MetricScheduler;
+//  - they are then granted in decreasing score order: each one takes free bands among its allowed ones,
+//    in band order, until its buffer (plus the MAC header) is covered or no band is left.
+//
+// Policies:
+//  - maxci, pf: the MaxCiMetric and PfMetric of SchedulingMetrics.h, i.e. the MAXCI and PF
+//    schedulers. Any other metric of that file is replayed by adding it to makePolicy();
+//  - edf: the NR-EDF priority of the head-of-line PDU (downlink traces only, WCTT not accounted).
+//
+// The traces record the inputs of the simulated scheduler, not the effect of the replayed decisions:
+// buffers and CQIs of a record do not depend on the grants replayed for the previous ones. Only the
+// state of the policy (e.g. the PF rates) follows the replayed grants. Codeword limits, MU-MIMO and
+// background UEs are not modeled.
+//
+// Usage: see printUsage()
+//
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "common/LteCommon.h"
+#include "common/qos_data.h"
+#include "stack/mac/scheduler/SchedulerTrace.h"
+#include "stack/mac/scheduling_modules/NrEdfPriority.h"
+#include "stack/mac/scheduling_modules/SchedulingMetrics.h"
+
+using namespace simu5g;
+
+namespace {
+
+class Policy
+{
+  public:
+    virtual ~Policy() {}
+
+    /// false if the connection is not served by the policy
+    virtual bool score(const ConnectionView& view, const SchedulerTraceConnection& connection, double now, double& score) = 0;
+    virtual void granted(MacCid cid, unsigned int bytes) {}
+    virtual void commit(unsigned int totalBlocks) {}
+};
+
+template<typename Metric>
+class MetricPolicy : public Policy
+{
+  protected:
+    Metric metric_;
+
+  public:
+    Metric& metric() { return metric_; }
+
+    bool score(const ConnectionView& view, const SchedulerTraceConnection& connection, double now, double& score) override
+    {
+        score = metric_.score(view);
+        return true;
+    }
+    void granted(MacCid cid, unsigned int bytes) override { metric_.granted(cid, bytes); }
+    void commit(unsigned int totalBlocks) override { metric_.commit(totalBlocks); }
+};
+
+// Same ranking as NrEDF::prepareSchedule, without admission control
+class EdfPolicy : public Policy
+{
+  public:
+    bool score(const ConnectionView& view, const SchedulerTraceConnection& connection, double now, double& score) override
+    {
+        // NrEDF only serves connections with MAC PDU metadata
+        if (connection.pendingPdus == 0)
+            return false;
+
+        const auto& params = get_qos_parameters(connection.fiveQi);
+        if (params.fiveQI == 0)
+            return false;
+
+        struct
+        {
+            struct
+            {
+                double arrival_time;
+            } mcp;
+            double wctt;
+        } tb = {{connection.arrivalTime}, 0};
+
+        double priority = 0;
+        switch (params.resource_type) {
+            case qos_data::DCGBR:
+                priority = COMPUTE_PRIORITY_DCGBR(params, now, tb);
+                break;
+            case qos_data::GBR:
+                priority = COMPUTE_PRIORITY_GBR(params);
+                break;
+            case qos_data::NGBR:
+                priority = COMPUTE_PRIORITY_NGBR(params);
+                break;
+            default:
+                return false;
+        }
+        score = nr_edf_map_to_band(params.resource_type, priority);
+        return true;
+    }
+};
+
+std::unique_ptr<Policy> makePolicy(const std::string& name, double pfAlpha)
+{
+    if (name == "maxci")
+        return std::make_unique<MetricPolicy<MaxCiMetric>>();
+    if (name == "pf") {
+        auto policy = std::make_unique<MetricPolicy<PfMetric>>();
+        policy->metric().initialize(pfAlpha);
+        return policy;
+    }
+    if (name == "edf")
+        return std::make_unique<EdfPolicy>();
+    return nullptr;
+}
+
+struct Scored
+{
+    double score;
+    size_t index;    // in the connections of the record
+};
+
+struct Stats
+{
+    unsigned long records = 0;
+    unsigned long scored = 0;
+    unsigned long grants = 0;
+    unsigned long long bytes = 0;
+    unsigned long long blocks = 0;
+    unsigned long long freeBlocks = 0;
+    unsigned long lateGrants = 0;    // head-of-line PDU served after its deadline
+    double decisionTime = 0;         // s
+    double maxDecisionTime = 0;      // s
+};
+
+/*
+ * Replays one record: scores, sorts and grants. Returns the decision time.
+ */
+double replayRecord(Policy& policy, const SchedulerTraceRecord& record, unsigned int totalBlocks, std::vector<uint8_t>& freeBands,
+        std::vector<Scored>& scores, std::vector<std::pair<unsigned int, unsigned int>>& grants, Stats& stats)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    freeBands = record.freeBands;
+    scores.clear();
+    grants.assign(record.connections.size(), {0, 0});
+
+    ConnectionView view;
+    for (size_t i = 0; i < record.connections.size(); i++) {
+        const SchedulerTraceConnection& connection = record.connections[i];
+        if (connection.cqi.empty() || std::find(connection.cqi.begin(), connection.cqi.end(), 0) != connection.cqi.end())
+            continue;
+
+        view.cid = connection.cid;
+        view.nodeId = MacCidToNodeId(connection.cid);
+        view.dir = DL;
+        view.txParams = nullptr;
+        view.availableBytes = 0;
+        view.availableBlocks = 0;
+        for (const auto& [band, bytes] : connection.bands) {
+            if (band < freeBands.size() && freeBands[band]) {
+                view.availableBlocks++;
+                view.availableBytes += bytes;
+            }
+        }
+        if (view.availableBlocks == 0)
+            continue;
+
+        double score;
+        if (policy.score(view, connection, record.time, score))
+            scores.push_back({score, i});
+    }
+
+    // deterministic order among equal scores
+    std::sort(scores.begin(), scores.end(), [&record](const Scored& a, const Scored& b) {
+        return a.score > b.score || (a.score == b.score && record.connections[a.index].cid < record.connections[b.index].cid);
+    });
+
+    for (const Scored& current : scores) {
+        const SchedulerTraceConnection& connection = record.connections[current.index];
+        unsigned int request = connection.bufferedBytes + MAC_HEADER;
+        auto& [bytes, blocks] = grants[current.index];
+        for (const auto& [band, bandBytes] : connection.bands) {
+            if (bytes >= request)
+                break;
+            if (band < freeBands.size() && freeBands[band] && bandBytes > 0) {
+                freeBands[band] = 0;
+                bytes += bandBytes;
+                blocks++;
+            }
+        }
+        policy.granted(connection.cid, bytes);
+    }
+    policy.commit(totalBlocks);
+
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    stats.records++;
+    stats.scored += scores.size();
+    stats.freeBlocks += std::count(record.freeBands.begin(), record.freeBands.end(), 1);
+    for (size_t i = 0; i < grants.size(); i++) {
+        if (grants[i].second == 0)
+            continue;
+        stats.grants++;
+        stats.bytes += grants[i].first;
+        stats.blocks += grants[i].second;
+        if (record.connections[i].pendingPdus > 0 && record.time > record.connections[i].deadline)
+            stats.lateGrants++;
+    }
+    stats.decisionTime += elapsed;
+    stats.maxDecisionTime = std::max(stats.maxDecisionTime, elapsed);
+    return elapsed;
+}
+
+void printUsage(const char *name)
+{
+    std::cout << "Usage: " << name << " [options] <trace>\n"
+              << "\n"
+              << "  -p <policies>       comma-separated policies to replay: maxci, pf, edf (default: maxci,pf,edf)\n"
+              << "  --pf-alpha <a>      smoothing factor of pf (default 0.95)\n"
+              << "  --grants <file>     write the grants of every record, as CSV (policy,time,carrier,cid,bytes,blocks)\n"
+              << "  --repeat <n>        replay the trace n times, for stable timings (default 1)\n"
+              << "  -v                  print the decision time of every record\n"
+              << "\n"
+              << "Exit code: 0 success, 2 error\n";
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    std::string traceFile, grantsFile;
+    std::vector<std::string> policies = {"maxci", "pf", "edf"};
+    double pfAlpha = 0.95;
+    int repeat = 1;
+    bool verbose = false;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto next = [&]() -> std::string {
+            if (i + 1 >= argc) {
+                std::cerr << "missing value for " << arg << std::endl;
+                exit(2);
+            }
+            return argv[++i];
+        };
+        if (arg == "-h" || arg == "--help") {
+            printUsage(argv[0]);
+            return 0;
+        }
+        else if (arg == "-p") {
+            policies.clear();
+            std::stringstream ss(next());
+            std::string policy;
+            while (std::getline(ss, policy, ','))
+                policies.push_back(policy);
+        }
+        else if (arg == "--pf-alpha")
+            pfAlpha = atof(next().c_str());
+        else if (arg == "--grants")
+            grantsFile = next();
+        else if (arg == "--repeat")
+            repeat = std::max(1, atoi(next().c_str()));
+        else if (arg == "-v")
+            verbose = true;
+        else if (arg[0] != '-' && traceFile.empty())
+            traceFile = arg;
+        else {
+            std::cerr << "unknown option " << arg << std::endl;
+            printUsage(argv[0]);
+            return 2;
+        }
+    }
+    if (traceFile.empty()) {
+        printUsage(argv[0]);
+        return 2;
+    }
+
+    std::ofstream grantsOut;
+    if (!grantsFile.empty()) {
+        grantsOut.open(grantsFile);
+        if (!grantsOut) {
+            std::cerr << "cannot create " << grantsFile << std::endl;
+            return 2;
+        }
+        grantsOut << "policy,time,carrier,cid,bytes,blocks\n" << std::setprecision(12);
+    }
+
+    try {
+        std::cout << std::left << std::setw(8) << "policy" << std::right
+                  << std::setw(10) << "records" << std::setw(12) << "scored" << std::setw(10) << "grants"
+                  << std::setw(14) << "bytes" << std::setw(10) << "blocks" << std::setw(8) << "util%"
+                  << std::setw(8) << "late" << std::setw(12) << "mean(us)" << std::setw(12) << "max(us)" << "\n";
+
+        for (const std::string& name : policies) {
+            Stats stats;
+            for (int run = 0; run < repeat; run++) {
+                std::unique_ptr<Policy> policy = makePolicy(name, pfAlpha);
+                if (policy == nullptr) {
+                    std::cerr << "unknown policy " << name << std::endl;
+                    return 2;
+                }
+
+                SchedulerTraceReader reader;
+                SchedulerTraceHeader header;
+                reader.open(traceFile, header);
+                if (name == "edf" && header.direction != DL)
+                    std::cerr << "warning: uplink trace, edf only serves the connections with MAC PDU metadata" << std::endl;
+
+                SchedulerTraceRecord record;
+                std::vector<uint8_t> freeBands;
+                std::vector<Scored> scores;
+                std::vector<std::pair<unsigned int, unsigned int>> grants;
+                while (reader.next(record)) {
+                    double elapsed = replayRecord(*policy, record, header.numBands, freeBands, scores, grants, stats);
+                    if (verbose)
+                        std::cout << name << " t=" << record.time << " carrier=" << record.carrierFrequency
+                                  << " connections=" << record.connections.size() << " decision=" << elapsed * 1e6 << "us\n";
+
+                    // the grants do not depend on the run
+                    if (grantsOut.is_open() && run == 0) {
+                        for (size_t i = 0; i < grants.size(); i++) {
+                            if (grants[i].second > 0)
+                                grantsOut << name << "," << record.time << "," << record.carrierFrequency << "," << record.connections[i].cid
+                                          << "," << grants[i].first << "," << grants[i].second << "\n";
+                        }
+                    }
+                }
+            }
+
+            double util = stats.freeBlocks > 0 ? 100.0 * stats.blocks / stats.freeBlocks : 0;
+            double mean = stats.records > 0 ? stats.decisionTime / stats.records : 0;
+            std::cout << std::left << std::setw(8) << name << std::right << std::fixed << std::setprecision(2)
+                      << std::setw(10) << stats.records / repeat << std::setw(12) << stats.scored / repeat
+                      << std::setw(10) << stats.grants / repeat << std::setw(14) << stats.bytes / repeat
+                      << std::setw(10) << stats.blocks / repeat << std::setw(8) << util << std::setw(8) << stats.lateGrants / repeat
+                      << std::setw(12) << mean * 1e6 << std::setw(12) << stats.maxDecisionTime * 1e6 << "\n";
+            std::cout.unsetf(std::ios::fixed);
+        }
+    }
+    catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 2;
+    }
+    return 0;
+}
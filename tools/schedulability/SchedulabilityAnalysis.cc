@@ -0,0 +1,796 @@
+//
+//                  Simu5G-NR-EDF (Extension of Simu5G)
+//
+// Original Authors: Giovanni Nardini, Giovanni Stea, Antonio Virdis (University of Pisa)
+// Extension Authors: Alaf Nascimento, Philippe Martins, Samuel Tardieu, Laurent Pautet (Institut Polytechnique de Paris)
+//
+// This file is part of a software released under the license included in file
+// "license.pdf". Please read LICENSE and README files before using it.
+// The above files and the present reference are part of the software itself,
+// and cannot be removed from it.
+//
+
+//
+// Offline schedulability analysis of a set of CBR downlink flows under NR-EDF.
+//
+// Flows are read from the CbrSender parameters (fiveQI, packetSize, sampling_time)
+// of an ini file, or given on the command line. Each packet is turned into a demand
+// of PRBs with the NR TBS computation used by NRAmc, at the given CQI. The cell is
+// modeled as a resource of numBands PRBs per slot, shared among the flows.
+//
+// Flows are ranked with the NR-EDF priority model:
+//  - DC-GBR flows are served first, by deadline: the processor demand test
+//    dbf(t) <= numBands * t is checked at every absolute deadline up to the busy period bound;
+//  - GBR and non-GBR flows are served by static priority below them: their worst-case
+//    response time is computed with the DC-GBR flows and the higher priority flows as interference.
+//
+// The model is fluid (PRBs of a slot can be split among any number of UEs) and ignores
+// control overhead, so a "schedulable" answer is meant to prune the parameter space
+// before running the simulations, not to replace them.
+//
+// Usage: see printUsage()
+//
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <numeric>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "common/LteCommon.h"
+#include "common/qos_data.h"
+#include "stack/mac/amc/NRMcs.h"
+#include "stack/mac/scheduling_modules/NrEdfPriority.h"
+
+using namespace simu5g;
+
+namespace {
+
+struct Flow
+{
+    int index = 0;
+    int fiveQI = 0;
+    double period = 0.02;    // s
+    double size = 40;        // B
+    qos_data::ResourceType type = qos_data::NONE;
+    double priority = -1;    // position on the NR-EDF priority scale
+
+    long T = 0;              // period, in slots
+    long D = 0;              // relative deadline, in slots
+    long C = 0;              // PRBs needed by one packet
+    long R = 0;              // worst-case response time, in slots (static priority flows)
+};
+
+struct CellConfig
+{
+    unsigned int numBands = 25;
+    unsigned int numerologyIndex = 0;
+    unsigned int symbolsPerSlot = 14;
+    unsigned int layers = 1;
+    Cqi cqi = 15;
+    unsigned int harqRtx = 0;            // retransmissions accounted for every packet
+    unsigned int harqFbEvaluationTimer = 4;
+};
+
+/*
+ * Minimal reader for the OMNeT++ ini files of the simulations. It supports the
+ * sections and "extends" keys, the '*' and '**' wildcards in keys, and the
+ * ${var=value} iteration syntax (the first value is used, also where the
+ * variable is referenced as ${var}).
+ */
+class IniReader
+{
+    struct Entry
+    {
+        std::string key;
+        std::string value;
+    };
+
+    std::map<std::string, std::vector<Entry>> sections_;
+    std::map<std::string, std::string> extends_;
+    std::vector<std::string> searchOrder_;
+    // first value of each named iteration variable
+    std::map<std::string, std::string> variables_;
+
+    static std::string trim(const std::string& s)
+    {
+        size_t b = s.find_first_not_of(" \t\r");
+        if (b == std::string::npos)
+            return "";
+        size_t e = s.find_last_not_of(" \t\r");
+        return s.substr(b, e - b + 1);
+    }
+
+    // Returns the first value of the iteration "${var=v1,v2}" or "${v1,v2}" starting at pos, and its name if any
+    static bool splitIteration(const std::string& value, size_t pos, size_t& end, std::string& name, std::string& first)
+    {
+        end = value.find('}', pos);
+        if (end == std::string::npos)
+            return false;
+        std::string body = value.substr(pos + 2, end - pos - 2);
+        size_t eq = body.find('=');
+        name = (eq != std::string::npos) ? trim(body.substr(0, eq)) : "";
+        first = (eq != std::string::npos) ? body.substr(eq + 1) : body;
+        first = trim(first.substr(0, first.find(',')));
+        return true;
+    }
+
+    static std::string stripComment(const std::string& line)
+    {
+        bool quoted = false;
+        for (size_t i = 0; i < line.size(); ++i) {
+            if (line[i] == '"')
+                quoted = !quoted;
+            else if (line[i] == '#' && !quoted)
+                return line.substr(0, i);
+        }
+        return line;
+    }
+
+    // '**' matches any sequence, '*' any sequence without dots
+    static bool match(const char *pattern, const char *name)
+    {
+        if (*pattern == '\0')
+            return *name == '\0';
+        if (pattern[0] == '*' && pattern[1] == '*') {
+            for (const char *s = name; ; ++s) {
+                if (match(pattern + 2, s))
+                    return true;
+                if (*s == '\0')
+                    return false;
+            }
+        }
+        if (*pattern == '*') {
+            for (const char *s = name; ; ++s) {
+                if (match(pattern + 1, s))
+                    return true;
+                if (*s == '\0' || *s == '.')
+                    return false;
+            }
+        }
+        return *pattern == *name && match(pattern + 1, name + 1);
+    }
+
+  public:
+    bool load(const std::string& fileName)
+    {
+        std::ifstream in(fileName);
+        if (!in)
+            return false;
+
+        std::string section = "General";
+        std::string line;
+        while (std::getline(in, line)) {
+            line = trim(stripComment(line));
+            if (line.empty())
+                continue;
+            if (line.front() == '[' && line.back() == ']') {
+                section = trim(line.substr(1, line.size() - 2));
+                if (section.compare(0, 7, "Config ") == 0)
+                    section = trim(section.substr(7));
+                continue;
+            }
+            size_t eq = line.find('=');
+            if (eq == std::string::npos)
+                continue;
+            std::string key = trim(line.substr(0, eq));
+            std::string value = trim(line.substr(eq + 1));
+            if (key == "extends")
+                extends_[section] = value;
+            else
+                sections_[section].push_back({key, value});
+
+            size_t end;
+            std::string name, first;
+            for (size_t pos = value.find("${"); pos != std::string::npos; pos = value.find("${", end)) {
+                if (!splitIteration(value, pos, end, name, first))
+                    break;
+                if (!name.empty())
+                    variables_[name] = first;
+            }
+        }
+        return true;
+    }
+
+    void selectConfig(const std::string& config)
+    {
+        searchOrder_.clear();
+        std::string section = config;
+        while (!section.empty() && std::find(searchOrder_.begin(), searchOrder_.end(), section) == searchOrder_.end()) {
+            searchOrder_.push_back(section);
+            auto it = extends_.find(section);
+            section = (it != extends_.end()) ? it->second : "";
+        }
+        if (std::find(searchOrder_.begin(), searchOrder_.end(), "General") == searchOrder_.end())
+            searchOrder_.push_back("General");
+    }
+
+    bool hasSection(const std::string& section) const
+    {
+        return section == "General" || sections_.count(section) > 0 || extends_.count(section) > 0;
+    }
+
+    // Returns the value of the first entry matching the given full parameter name
+    bool lookup(const std::string& name, std::string& value) const
+    {
+        for (const auto& section : searchOrder_) {
+            auto it = sections_.find(section);
+            if (it == sections_.end())
+                continue;
+            for (const auto& entry : it->second) {
+                if (match(entry.key.c_str(), name.c_str())) {
+                    value = entry.value;
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    // Replaces the iterations and the references to iteration variables by their first value
+    bool expandVariables(std::string& value) const
+    {
+        size_t end;
+        std::string name, first;
+        for (size_t pos = value.find("${"); pos != std::string::npos; pos = value.find("${", pos)) {
+            if (!splitIteration(value, pos, end, name, first))
+                return false;
+            if (name.empty() && !first.empty() && (isalpha((unsigned char)first[0]) || first[0] == '_')) {
+                // reference to a variable defined elsewhere, e.g. ${numUe}
+                auto it = variables_.find(first);
+                if (it == variables_.end())
+                    return false;
+                first = it->second;
+            }
+            value.replace(pos, end + 1 - pos, first);
+            pos += first.size();
+        }
+        return true;
+    }
+
+    // Returns the indices used explicitly in keys like "<prefix>[<index>].<param>"
+    int maxExplicitIndex(const std::string& prefix) const
+    {
+        int maxIndex = -1;
+        std::string token = prefix + "[";
+        for (const auto& section : searchOrder_) {
+            auto it = sections_.find(section);
+            if (it == sections_.end())
+                continue;
+            for (const auto& entry : it->second) {
+                size_t pos = entry.key.find(token);
+                if (pos == std::string::npos)
+                    continue;
+                const char *digits = entry.key.c_str() + pos + token.size();
+                char *end;
+                long index = strtol(digits, &end, 10);
+                if (end != digits && *end == ']')
+                    maxIndex = std::max(maxIndex, (int)index);
+            }
+        }
+        return maxIndex;
+    }
+};
+
+// Parses a number with an optional unit, returning it in s or B. Iteration
+// variables (${x=1,2,3}) take their first value
+bool parseQuantity(std::string value, double& result)
+{
+    size_t var = value.find("${");
+    if (var != std::string::npos) {
+        size_t eq = value.find('=', var);
+        size_t end = value.find('}', var);
+        if (end == std::string::npos)
+            return false;
+        size_t begin = (eq != std::string::npos && eq < end) ? eq + 1 : var + 2;
+        std::string first = value.substr(begin, end - begin);
+        first = first.substr(0, first.find(','));
+        value = value.substr(0, var) + first + value.substr(end + 1);
+    }
+    if (!value.empty() && value.front() == '"' && value.back() == '"')
+        value = value.substr(1, value.size() - 2);
+
+    const char *str = value.c_str();
+    char *end;
+    result = strtod(str, &end);
+    if (end == str)
+        return false;
+
+    std::string unit = end;
+    unit.erase(std::remove(unit.begin(), unit.end(), ' '), unit.end());
+    if (unit.empty() || unit == "s" || unit == "B")
+        return true;
+    if (unit == "ms")
+        result /= 1000.0;
+    else if (unit == "us")
+        result /= 1000000.0;
+    else if (unit == "KiB")
+        result *= 1024;
+    else if (unit == "kB")
+        result *= 1000;
+    else
+        return false;
+    return true;
+}
+
+bool parseBool(const std::string& value, bool& result)
+{
+    if (value == "true")
+        result = true;
+    else if (value == "false")
+        result = false;
+    else
+        return false;
+    return true;
+}
+
+// Evaluates the arithmetic of an ini value: numbers, + - * / and parentheses
+class ExpressionEvaluator
+{
+    const char *p_;
+
+    void skipSpaces()
+    {
+        while (*p_ == ' ' || *p_ == '\t')
+            ++p_;
+    }
+
+    bool primary(double& result)
+    {
+        skipSpaces();
+        if (*p_ == '(') {
+            ++p_;
+            if (!sum(result))
+                return false;
+            skipSpaces();
+            return *p_++ == ')';
+        }
+        if (*p_ == '-') {
+            ++p_;
+            if (!primary(result))
+                return false;
+            result = -result;
+            return true;
+        }
+        char *end;
+        result = strtod(p_, &end);
+        if (end == p_)
+            return false;
+        p_ = end;
+        return true;
+    }
+
+    bool product(double& result)
+    {
+        if (!primary(result))
+            return false;
+        for (skipSpaces(); *p_ == '*' || *p_ == '/'; skipSpaces()) {
+            char op = *p_++;
+            double rhs;
+            if (!primary(rhs) || (op == '/' && rhs == 0))
+                return false;
+            result = (op == '*') ? result * rhs : result / rhs;
+        }
+        return true;
+    }
+
+    bool sum(double& result)
+    {
+        if (!product(result))
+            return false;
+        for (skipSpaces(); *p_ == '+' || *p_ == '-'; skipSpaces()) {
+            char op = *p_++;
+            double rhs;
+            if (!product(rhs))
+                return false;
+            result = (op == '+') ? result + rhs : result - rhs;
+        }
+        return true;
+    }
+
+  public:
+    bool evaluate(const std::string& expression, double& result)
+    {
+        p_ = expression.c_str();
+        if (!sum(result))
+            return false;
+        skipSpaces();
+        return *p_ == '\0';
+    }
+};
+
+class SchedulabilityAnalysis
+{
+    CellConfig cell_;
+    NRMCSelem mcs_;
+    std::vector<Flow> flows_;
+    bool verbose_ = false;
+
+    // maximum number of checkpoints of the processor demand test
+    static constexpr long MAX_CHECKPOINTS = 10000000;
+
+    double slotDuration() const
+    {
+        return 0.001 / (1 << cell_.numerologyIndex);
+    }
+
+    unsigned int tbsOnBlocks(unsigned int blocks) const
+    {
+        return computeNrTbs(mcs_, cell_.layers, getNrResourceElements(blocks, cell_.symbolsPerSlot));
+    }
+
+    // PRBs needed to carry the given number of bits, over one or more slots. -1 if the UE cannot be served
+    long blocksForBits(unsigned long bits) const
+    {
+        unsigned int fullSlotBits = tbsOnBlocks(cell_.numBands);
+        if (fullSlotBits == 0)
+            return -1;
+
+        unsigned long fullSlots = bits / fullSlotBits;
+        unsigned long remainder = bits - fullSlots * fullSlotBits;
+        long blocks = fullSlots * cell_.numBands;
+        if (remainder > 0) {
+            unsigned int b = 1;
+            while (b < cell_.numBands && tbsOnBlocks(b) < remainder)
+                ++b;
+            blocks += b;
+        }
+        return blocks;
+    }
+
+    bool testDcGbr(double& utilization, long& checkpoints) const
+    {
+        std::vector<const Flow *> set;
+        utilization = 0;
+        for (const auto& flow : flows_) {
+            if (flow.type == qos_data::DCGBR) {
+                set.push_back(&flow);
+                utilization += (double)flow.C / ((double)flow.T * cell_.numBands);
+            }
+        }
+        checkpoints = 0;
+        if (set.empty())
+            return true;
+        if (utilization > 1.0)
+            return false;
+
+        // bound on the length of the interval to check
+        long maxD = 0;
+        long hyperperiod = 1;
+        double slack = 0;
+        for (const Flow *flow : set) {
+            maxD = std::max(maxD, flow->D);
+            if (hyperperiod < MAX_CHECKPOINTS)
+                hyperperiod = std::lcm(hyperperiod, flow->T);
+            slack += (double)(flow->T - flow->D) * flow->C / ((double)flow->T * cell_.numBands);
+        }
+        double bound = (double)hyperperiod + maxD;
+        if (utilization < 1.0)
+            bound = std::min(bound, std::max((double)maxD, slack / (1.0 - utilization)));
+
+        // absolute deadlines within the bound
+        std::vector<long> deadlines;
+        for (const Flow *flow : set) {
+            for (long d = flow->D; d <= bound && checkpoints < MAX_CHECKPOINTS; d += flow->T, ++checkpoints)
+                deadlines.push_back(d);
+        }
+        std::sort(deadlines.begin(), deadlines.end());
+        deadlines.erase(std::unique(deadlines.begin(), deadlines.end()), deadlines.end());
+
+        for (long t : deadlines) {
+            if (t <= 0)
+                return false;
+            long demand = 0;
+            for (const Flow *flow : set) {
+                if (t >= flow->D)
+                    demand += ((t - flow->D) / flow->T + 1) * flow->C;
+            }
+            if (demand > (long)cell_.numBands * t) {
+                if (verbose_)
+                    std::cout << "DC-GBR demand of " << demand << " PRBs exceeds the capacity of " << (long)cell_.numBands * t << " PRBs at t = " << t << " slots" << std::endl;
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Worst-case response time of a static priority flow, -1 if it exceeds its deadline
+    long responseTime(const Flow& flow) const
+    {
+        long R = (flow.C + cell_.numBands - 1) / cell_.numBands;
+        while (R <= flow.D) {
+            long demand = flow.C;
+            for (const auto& other : flows_) {
+                if (&other == &flow || other.type == qos_data::NONE)
+                    continue;
+                // DC-GBR flows always come first, equal priorities are counted as interference
+                if (other.type == qos_data::DCGBR || other.priority >= flow.priority)
+                    demand += ((R + other.T - 1) / other.T) * other.C;
+            }
+            long next = (demand + cell_.numBands - 1) / cell_.numBands;
+            if (next <= R)
+                return R;
+            R = next;
+        }
+        return -1;
+    }
+
+  public:
+    SchedulabilityAnalysis(const CellConfig& cell, const std::vector<Flow>& flows, bool verbose)
+        : cell_(cell), flows_(flows), verbose_(verbose)
+    {
+        // same MCS selection as NRAmc, on the downlink table
+        NRMcsTable mcsTable;
+        mcs_ = mcsTable.getMcsElemPerCqi(cell_.cqi);
+    }
+
+    bool run()
+    {
+        double slot = slotDuration();
+        unsigned int harqRttSlots = cell_.harqFbEvaluationTimer + 1;
+        bool schedulable = true;
+
+        for (auto& flow : flows_) {
+            const auto& params = get_qos_parameters(flow.fiveQI);
+            flow.type = params.resource_type;
+            if (params.fiveQI == 0)
+                continue;
+
+            // same priority model as NrEDF: DC-GBR flows by deadline, the others by static priority
+            if (flow.type == qos_data::GBR)
+                flow.priority = nr_edf_map_to_band(flow.type, COMPUTE_PRIORITY_GBR(params));
+            else if (flow.type == qos_data::NGBR)
+                flow.priority = nr_edf_map_to_band(flow.type, COMPUTE_PRIORITY_NGBR(params));
+
+            flow.T = std::max(1L, (long)std::floor(flow.period / slot + 1e-9));
+            flow.D = (long)std::floor(params.packet_delay_budget / 1000.0 / slot + 1e-9) - (long)(cell_.harqRtx * harqRttSlots);
+
+            unsigned long bits = ((unsigned long)flow.size + MAC_HEADER + RLC_HEADER_UM) * 8;
+            long blocks = blocksForBits(bits);
+            if (blocks < 0 || flow.D <= 0) {
+                std::cout << "flow " << flow.index << ": cannot be served within its delay budget" << std::endl;
+                schedulable = false;
+                flow.C = 0;
+                continue;
+            }
+            flow.C = blocks * (1 + cell_.harqRtx);
+        }
+        if (!schedulable)
+            return false;
+
+        double utilization;
+        long checkpoints;
+        bool dcGbrSchedulable = testDcGbr(utilization, checkpoints);
+        schedulable = dcGbrSchedulable;
+
+        for (auto& flow : flows_) {
+            if (flow.type == qos_data::GBR || flow.type == qos_data::NGBR) {
+                flow.R = responseTime(flow);
+                if (flow.R < 0)
+                    schedulable = false;
+            }
+        }
+
+        if (verbose_) {
+            std::cout << std::left << std::setw(6) << "flow" << std::setw(5) << "5QI" << std::setw(7) << "type"
+                      << std::setw(9) << "T[slot]" << std::setw(9) << "D[slot]" << std::setw(9) << "C[PRB]"
+                      << std::setw(10) << "priority" << "R[slot]" << std::endl;
+            for (const auto& flow : flows_) {
+                std::cout << std::left << std::setw(6) << flow.index << std::setw(5) << flow.fiveQI << std::setw(7) << resourceTypeToA(flow.type);
+                if (flow.type == qos_data::NONE) {
+                    std::cout << "no QoS, ignored" << std::endl;
+                    continue;
+                }
+                std::cout << std::setw(9) << flow.T << std::setw(9) << flow.D << std::setw(9) << flow.C;
+                if (flow.type == qos_data::DCGBR)
+                    std::cout << std::setw(10) << "EDF" << "-" << std::endl;
+                else
+                    std::cout << std::setw(10) << flow.priority << (flow.R < 0 ? std::string("miss") : std::to_string(flow.R)) << std::endl;
+            }
+            std::cout << "DC-GBR utilization " << utilization << ", processor demand test " << (dcGbrSchedulable ? "passed" : "failed")
+                      << " (" << checkpoints << " deadlines checked)" << std::endl;
+        }
+        return schedulable;
+    }
+};
+
+void printUsage(const char *name)
+{
+    std::cout << "Usage: " << name << " [options]\n"
+              << "\n"
+              << "Flows (CbrSender parameters):\n"
+              << "  -f <file.ini>       read fiveQI, packetSize and sampling_time of the CbrSender apps\n"
+              << "  -c <config>         ini configuration to use (default: General)\n"
+              << "  --apps <path>       path of the apps in the network (default: server.app)\n"
+              << "  --num-apps <n>      number of apps (default: numApps of the ini file, else highest index used + 1)\n"
+              << "  --flow <T:size:5QI> add a flow, e.g. --flow 10ms:512B:83\n"
+              << "\n"
+              << "Cell (read from the ini file when given there):\n"
+              << "  --prbs <n>          numBands (default 25)\n"
+              << "  --numerology <n>    numerologyIndex (default 0)\n"
+              << "  --symbols <n>       DL symbols per slot (default 14, tddNumSymbolsDl with TDD)\n"
+              << "  --layers <n>        MIMO layers (default 1)\n"
+              << "  --cqi <n>           CQI of all the UEs (default 15)\n"
+              << "  --harq-rtx <n>      HARQ retransmissions accounted for every packet (default 0)\n"
+              << "\n"
+              << "  -v                  print the analysis of every flow\n"
+              << "\n"
+              << "Exit code: 0 schedulable, 1 not schedulable, 2 error\n";
+}
+
+bool parseFlow(const std::string& spec, Flow& flow)
+{
+    std::stringstream ss(spec);
+    std::string period, size, fiveQI;
+    if (!std::getline(ss, period, ':') || !std::getline(ss, size, ':') || !std::getline(ss, fiveQI))
+        return false;
+    double qi;
+    if (!parseQuantity(period, flow.period) || !parseQuantity(size, flow.size) || !parseQuantity(fiveQI, qi))
+        return false;
+    flow.fiveQI = (int)qi;
+    return true;
+}
+
+bool readFlows(const IniReader& ini, const std::string& appPath, int numApps, std::vector<Flow>& flows)
+{
+    std::string prefix = "net." + appPath;
+    if (numApps < 0) {
+        std::string value;
+        if (ini.lookup(prefix.substr(0, prefix.rfind('.')) + ".numApps", value)) {
+            std::string expression = value;
+            double n;
+            if (!ini.expandVariables(expression) || !ExpressionEvaluator().evaluate(expression, n) || n < 0) {
+                std::cerr << "cannot evaluate numApps = " << value << ", give it with --num-apps" << std::endl;
+                return false;
+            }
+            numApps = (int)n;
+        }
+        else
+            numApps = ini.maxExplicitIndex(appPath.substr(appPath.rfind('.') + 1)) + 1;
+    }
+
+    for (int i = 0; i < numApps; ++i) {
+        Flow flow;
+        flow.index = flows.size();
+        std::string app = prefix + "[" + std::to_string(i) + "].";
+        std::string value;
+        double qi;
+        if (ini.lookup(app + "fiveQI", value) && ini.expandVariables(value) && parseQuantity(value, qi))
+            flow.fiveQI = (int)qi;
+        if (ini.lookup(app + "packetSize", value) && !(ini.expandVariables(value) && parseQuantity(value, flow.size)))
+            return false;
+        if (ini.lookup(app + "sampling_time", value) && !(ini.expandVariables(value) && parseQuantity(value, flow.period)))
+            return false;
+        flows.push_back(flow);
+    }
+    return true;
+}
+
+void readCell(const IniReader& ini, CellConfig& cell)
+{
+    std::string value;
+    double n;
+    bool tdd = false;
+    if (ini.lookup("net.carrierAggregation.componentCarrier[0].numBands", value) && parseQuantity(value, n))
+        cell.numBands = (unsigned int)n;
+    if (ini.lookup("net.carrierAggregation.componentCarrier[0].numerologyIndex", value) && parseQuantity(value, n))
+        cell.numerologyIndex = (unsigned int)n;
+    if (ini.lookup("net.gnb.cellularNic.nrChannelModel[0].useTdd", value) && parseBool(value, tdd) && tdd
+            && ini.lookup("net.gnb.cellularNic.nrChannelModel[0].tddNumSymbolsDl", value) && parseQuantity(value, n))
+        cell.symbolsPerSlot = (unsigned int)n;
+    if (ini.lookup("net.gnb.cellularNic.mac.harqFbEvaluationTimer", value) && parseQuantity(value, n))
+        cell.harqFbEvaluationTimer = (unsigned int)n;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    std::string iniFile, config = "General", appPath = "server.app";
+    int numApps = -1;
+    bool verbose = false;
+    std::vector<Flow> cliFlows;
+    std::map<std::string, std::string> cellOptions;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto next = [&]() -> std::string {
+            if (i + 1 >= argc) {
+                std::cerr << "missing value for " << arg << std::endl;
+                exit(2);
+            }
+            return argv[++i];
+        };
+        if (arg == "-h" || arg == "--help") {
+            printUsage(argv[0]);
+            return 0;
+        }
+        else if (arg == "-f")
+            iniFile = next();
+        else if (arg == "-c")
+            config = next();
+        else if (arg == "--apps")
+            appPath = next();
+        else if (arg == "--num-apps")
+            numApps = atoi(next().c_str());
+        else if (arg == "--flow") {
+            Flow flow;
+            if (!parseFlow(next(), flow)) {
+                std::cerr << "invalid flow " << argv[i] << ", expected <period>:<size>:<5QI>" << std::endl;
+                return 2;
+            }
+            cliFlows.push_back(flow);
+        }
+        else if (arg == "--prbs" || arg == "--numerology" || arg == "--symbols" || arg == "--layers" || arg == "--cqi" || arg == "--harq-rtx")
+            cellOptions[arg] = next();
+        else if (arg == "-v")
+            verbose = true;
+        else {
+            std::cerr << "unknown option " << arg << std::endl;
+            printUsage(argv[0]);
+            return 2;
+        }
+    }
+
+    CellConfig cell;
+    std::vector<Flow> flows;
+    if (!iniFile.empty()) {
+        IniReader ini;
+        if (!ini.load(iniFile)) {
+            std::cerr << "cannot read " << iniFile << std::endl;
+            return 2;
+        }
+        if (!ini.hasSection(config)) {
+            std::cerr << "configuration " << config << " not found in " << iniFile << std::endl;
+            return 2;
+        }
+        ini.selectConfig(config);
+        readCell(ini, cell);
+        if (!readFlows(ini, appPath, numApps, flows)) {
+            std::cerr << "invalid CbrSender parameters in " << iniFile << std::endl;
+            return 2;
+        }
+    }
+    for (auto& flow : cliFlows) {
+        flow.index = flows.size();
+        flows.push_back(flow);
+    }
+    if (flows.empty()) {
+        std::cerr << "no flows to analyze" << std::endl;
+        printUsage(argv[0]);
+        return 2;
+    }
+
+    for (const auto& [option, value] : cellOptions) {
+        unsigned int n = (unsigned int)atoi(value.c_str());
+        if (option == "--prbs")
+            cell.numBands = n;
+        else if (option == "--numerology")
+            cell.numerologyIndex = n;
+        else if (option == "--symbols")
+            cell.symbolsPerSlot = n;
+        else if (option == "--layers")
+            cell.layers = n;
+        else if (option == "--cqi")
+            cell.cqi = n;
+        else if (option == "--harq-rtx")
+            cell.harqRtx = n;
+    }
+    if (cell.numBands == 0 || cell.cqi > MAXCQI || cell.layers == 0) {
+        std::cerr << "invalid cell configuration" << std::endl;
+        return 2;
+    }
+
+    SchedulabilityAnalysis analysis(cell, flows, verbose);
+    bool schedulable = analysis.run();
+    std::cout << (schedulable ? "schedulable" : "not schedulable") << std::endl;
+    return schedulable ? 0 : 1;
+}